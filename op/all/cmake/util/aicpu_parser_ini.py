@@ -2,6 +2,7 @@ import json
 import os
 import stat
 import sys
+import op_cost_model
 
 def parse_ini_files(ini_files):
     aicpu_ops_info = {}
@@ -94,6 +95,8 @@ def parse_ini_to_json(ini_file_paths, outfile_path):
     aicpu_ops_info = parse_ini_files(ini_file_paths)
     try:
         check_op_info(aicpu_ops_info)
+        # computeCost=auto is estimated from the op's shapes by op_cost_model
+        op_cost_model.resolve_costs(aicpu_ops_info, "opInfo", "computeCost", "aicpu")
         write_json_file(aicpu_ops_info, outfile_path)
     except KeyError:
         print("bad format key value, failed to generate json file")
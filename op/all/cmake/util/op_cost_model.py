@@ -0,0 +1,261 @@
+# -*- coding: utf-8 -*-
+"""
+Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+
+Cost model of the custom ops in op/all.
+
+An op info ini may set its cost, opInfo.computeCost for AI CPU kernels and
+compute.cost for AI Core ones, to "auto". The ini parsers then replace it
+with estimate_cost(op_type, engine):
+  - the op's infer function below, a mirror of op_proto/<op>.cpp, derives
+    the output shapes from the inputs and attrs of its reference case,
+  - the op's count function gives the FLOPs and the bytes moved,
+  - the cost is the roofline time in microseconds on the engine profile,
+    launch included, never below 1.
+The reference cases are the shapes the op runs at in the sample networks,
+so the numbers the graph engine compares follow real tensor sizes. Run
+this file to print the estimates of every op.
+"""
+import math
+import sys
+
+DTYPE_BYTES = {
+    "bool": 1, "int8": 1, "uint8": 1,
+    "float16": 2, "int16": 2, "uint16": 2,
+    "float": 4, "float32": 4, "int32": 4, "uint32": 4,
+    "int64": 8, "uint64": 8, "double": 8, "complex64": 8,
+    "complex128": 16,
+}
+
+# sustained rates of one kernel launch, GFLOP/s and GB/s, and its fixed cost in us
+ENGINE_PROFILES = {
+    "aicpu": {"gflops": 8.0, "gbytes": 6.0, "launch_us": 20.0},
+    "ai_core": {"gflops": 2000.0, "gbytes": 40.0, "launch_us": 2.0},
+}
+
+
+def tensor(shape, dtype="float16"):
+    """tensor desc of a reference case"""
+    return {"shape": list(shape), "dtype": dtype}
+
+
+def numel(desc):
+    """elements of a tensor desc, a rank 0 shape holds one"""
+    count = 1
+    for dim in desc["shape"]:
+        count *= dim
+    return count
+
+
+def nbytes(desc):
+    """bytes of a tensor desc"""
+    return numel(desc) * DTYPE_BYTES[desc["dtype"]]
+
+
+def broadcast_shape(shape1, shape2):
+    """numpy broadcast of two shapes, as in AddInferShape"""
+    rank = max(len(shape1), len(shape2))
+    dims1 = [1] * (rank - len(shape1)) + list(shape1)
+    dims2 = [1] * (rank - len(shape2)) + list(shape2)
+    out = []
+    for dim1, dim2 in zip(dims1, dims2):
+        if dim1 != dim2 and dim1 != 1 and dim2 != 1:
+            raise ValueError("shapes %s and %s do not broadcast" % (shape1, shape2))
+        out.append(dim2 if dim1 == 1 else dim1)
+    return out
+
+
+def accumulate_dtype(dtype):
+    """int8 matmul and conv accumulate into int32"""
+    return "int32" if dtype in ("int8", "uint8") else dtype
+
+
+# infer functions: (inputs, attrs) -> outputs
+
+def infer_same(inputs, attrs):
+    return [tensor(inputs[0]["shape"], inputs[0]["dtype"])]
+
+
+def infer_add(inputs, attrs):
+    return [tensor(broadcast_shape(inputs[0]["shape"], inputs[1]["shape"]), inputs[0]["dtype"])]
+
+
+def matmul_dims(inputs, attrs):
+    """m, k and n of MatmulTik, after its transpose attrs"""
+    shape1, shape2 = inputs[0]["shape"], inputs[1]["shape"]
+    rows, depth = shape1[-2:]
+    if attrs.get("transpose_x1", False):
+        rows, depth = depth, rows
+    cols = shape2[-2] if attrs.get("transpose_x2", False) else shape2[-1]
+    return rows, depth, cols
+
+
+def infer_matmul_tik(inputs, attrs):
+    """batch dims broadcast as in MatmulTikInferShape, then [m, n], float16 accumulates into float"""
+    rows, _, cols = matmul_dims(inputs, attrs)
+    batch = broadcast_shape(inputs[0]["shape"][:-2], inputs[1]["shape"][:-2])
+    dtype = "float" if inputs[0]["dtype"] == "float16" else accumulate_dtype(inputs[0]["dtype"])
+    return [tensor(batch + [rows, cols], dtype)]
+
+
+def conv_in_channels(inputs, attrs):
+    """channels of x, at the axis its data_format puts them"""
+    return inputs[0]["shape"][3 if attrs.get("data_format", "NCHW") == "NHWC" else 1]
+
+
+def infer_conv2d_tik(inputs, attrs):
+    """x, strides and dilations in data_format, OIHW filter, pads (top, bottom, left, right)"""
+    nhwc = attrs.get("data_format", "NCHW") == "NHWC"
+    if nhwc:
+        batch, in_h, in_w, _ = inputs[0]["shape"]
+    else:
+        batch, _, in_h, in_w = inputs[0]["shape"]
+    out_c, _, kernel_h, kernel_w = inputs[1]["shape"]
+    hw_axes = (1, 2) if nhwc else (2, 3)
+    strides = [attrs["strides"][axis] for axis in hw_axes]
+    dilations = [attrs.get("dilations", [1, 1, 1, 1])[axis] for axis in hw_axes]
+    pads = attrs["pads"]
+    out_h = (in_h + pads[0] + pads[1] - dilations[0] * (kernel_h - 1) - 1) // strides[0] + 1
+    out_w = (in_w + pads[2] + pads[3] - dilations[1] * (kernel_w - 1) - 1) // strides[1] + 1
+    shape = [batch, out_h, out_w, out_c] if nhwc else [batch, out_c, out_h, out_w]
+    return [tensor(shape, accumulate_dtype(inputs[0]["dtype"]))]
+
+
+def infer_permute_tik(inputs, attrs):
+    shape = inputs[0]["shape"]
+    order = list(attrs.get("order", [0]))
+    order += [axis for axis in range(len(shape)) if axis not in order]
+    return [tensor([shape[axis] for axis in order], inputs[0]["dtype"])]
+
+
+def infer_upsample_tik(inputs, attrs):
+    shape = list(inputs[0]["shape"])
+    shape[2] *= attrs.get("stride_h", 2)
+    shape[3] *= attrs.get("stride_w", 2)
+    return [tensor(shape, inputs[0]["dtype"])]
+
+
+def infer_reshape_cust(inputs, attrs):
+    return [tensor(inputs[1]["value"], inputs[0]["dtype"])]
+
+
+def infer_fused_elementwise(inputs, attrs):
+    shape = []
+    for desc in inputs:
+        if numel(desc) != 1:
+            shape = desc["shape"]
+    return [tensor(shape, inputs[0]["dtype"])]
+
+
+# count functions: (inputs, outputs, attrs) -> (flops, bytes moved)
+
+def io_bytes(inputs, outputs):
+    return sum(nbytes(desc) for desc in inputs) + sum(nbytes(desc) for desc in outputs)
+
+
+def count_elementwise(flops_per_element):
+    def count(inputs, outputs, attrs):
+        return numel(outputs[0]) * flops_per_element, io_bytes(inputs, outputs)
+    return count
+
+
+def count_matmul_tik(inputs, outputs, attrs):
+    _, depth, _ = matmul_dims(inputs, attrs)
+    return 2 * numel(outputs[0]) * depth, io_bytes(inputs, outputs)
+
+
+def count_conv2d_tik(inputs, outputs, attrs):
+    """each output element sums in_c / groups channels, depthwise only its own"""
+    in_c = conv_in_channels(inputs, attrs)
+    _, _, kernel_h, kernel_w = inputs[1]["shape"]
+    groups = attrs.get("groups", 1)
+    return 2 * numel(outputs[0]) * (in_c // groups) * kernel_h * kernel_w, io_bytes(inputs, outputs)
+
+
+def count_move(inputs, outputs, attrs):
+    """pure data movement, x read once and y written once"""
+    return 0, nbytes(inputs[0]) + nbytes(outputs[0])
+
+
+def count_reshape_cust(inputs, outputs, attrs):
+    """the output aliases the input, only the launch is charged"""
+    return 0, 0
+
+
+def count_scatter_nd_add(inputs, outputs, attrs):
+    """only the rows named by indices are read and written back"""
+    _, indices, updates = inputs
+    return numel(updates), nbytes(indices) + 3 * nbytes(updates)
+
+
+def count_fused_elementwise(inputs, outputs, attrs):
+    instructions = len(attrs["program"]) // 3
+    return numel(outputs[0]) * instructions, io_bytes(inputs, outputs)
+
+
+# op type -> (infer, count, reference inputs, reference attrs)
+OP_COST_MODELS = {
+    # the TF testcase net, a bias add over yolo feature maps
+    "Add": (infer_add, count_elementwise(1),
+            [tensor([1, 256, 52, 52]), tensor([1, 256, 52, 52])], {}),
+    "BatchNormCust": (infer_same, count_elementwise(2),
+                      [tensor([1, 256, 52, 52]), tensor([256]), tensor([256])], {"data_format": "NCHW"}),
+    "Conv2DTik": (infer_conv2d_tik, count_conv2d_tik,
+                  [tensor([1, 256, 52, 52]), tensor([256, 256, 3, 3])],
+                  {"strides": [1, 1, 1, 1], "pads": [1, 1, 1, 1]}),
+    # ssd head, 1917 anchors
+    "DecodeBboxV2": (infer_same, count_elementwise(20),
+                     [tensor([1917, 4], "float"), tensor([1917, 4], "float")], {}),
+    "FusedElementwise": (infer_fused_elementwise, count_fused_elementwise,
+                         [tensor([1, 256, 52, 52]), tensor([1, 256, 52, 52])],
+                         {"program": [4, 0, 1, 2, 2, -1], "constants": []}),
+    "LeakyReluDemo": (infer_same, count_elementwise(2),
+                      [tensor([1, 256, 52, 52])], {"negative_slope": 0.1}),
+    "MatmulTik": (infer_matmul_tik, count_matmul_tik,
+                  [tensor([1024, 1024]), tensor([1024, 1024])], {}),
+    "PermuteTik": (infer_permute_tik, count_move,
+                   [tensor([1, 24, 19, 19])], {"order": [0, 2, 3, 1]}),
+    "ReshapeCust": (infer_reshape_cust, count_reshape_cust,
+                    [tensor([1, 24, 19, 19]), dict(tensor([2], "int64"), value=[1, 8664])], {}),
+    "ScatterNdAdd": (infer_same, count_scatter_nd_add,
+                     [tensor([100000, 64], "float"), tensor([4096, 1], "int32"), tensor([4096, 64], "float")],
+                     {"use_locking": False}),
+    "UpsampleTik": (infer_upsample_tik, count_move,
+                    [tensor([1, 256, 13, 13])], {"scale": 1.0, "stride_h": 2, "stride_w": 2}),
+}
+
+
+def estimate_flops_bytes(op_type):
+    """FLOPs and bytes moved of op_type at its reference case"""
+    infer, count, inputs, attrs = OP_COST_MODELS[op_type]
+    outputs = infer(inputs, attrs)
+    return count(inputs, outputs, attrs)
+
+
+def estimate_cost(op_type, engine):
+    """roofline time in us of op_type on engine ("aicpu" or "ai_core"), as an int >= 1"""
+    if op_type not in OP_COST_MODELS:
+        raise KeyError("no cost model for op " + op_type)
+    profile = ENGINE_PROFILES[engine]
+    flops, moved = estimate_flops_bytes(op_type)
+    # GFLOP/s and GB/s are FLOPs and bytes per ns, so these are ns
+    compute_ns = flops / profile["gflops"]
+    memory_ns = moved / profile["gbytes"]
+    cost_us = profile["launch_us"] + max(compute_ns, memory_ns) / 1000.0
+    return max(1, int(math.ceil(cost_us)))
+
+
+def resolve_costs(ops_info, section, key, engine):
+    """replace every ops_info[op][section][key] set to "auto" by estimate_cost"""
+    for op_type, op in ops_info.items():
+        if op.get(section, {}).get(key) == "auto":
+            op[section][key] = str(estimate_cost(op_type, engine))
+
+
+if __name__ == '__main__':
+    print("%-18s %14s %14s %10s %10s" % ("op", "flops", "bytes", "aicpu", "ai_core"))
+    for name in sorted(OP_COST_MODELS):
+        op_flops, op_bytes = estimate_flops_bytes(name)
+        print("%-18s %14d %14d %10d %10d" % (name, op_flops, op_bytes, estimate_cost(name, "aicpu"),
+                                            estimate_cost(name, "ai_core")))
+    sys.exit(0)
@@ -2,6 +2,7 @@ import json
 import os
 import stat
 import sys
+import op_cost_model
 
 tbe_ops = {}
 
@@ -85,6 +86,13 @@ def parse_ini_to_json(ini_file_paths, outfile_path):
     if not check_op_info(tbe_ops_info):
         print("Compile op info cfg failed.")
         return False
+    # compute.cost=auto is estimated from the op's shapes by op_cost_model
+    try:
+        op_cost_model.resolve_costs(tbe_ops_info, "compute", "cost", "ai_core")
+    except KeyError as error:
+        print(error)
+        print("Compile op info cfg failed.")
+        return False
     write_json_file(tbe_ops_info, outfile_path)
     return True
 
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark cases of Add
+ */
+
+#include "kernel_bench.h"
+
+namespace aicpu {
+namespace {
+const char *ADD = "Add";
+
+bool BuildAddSameShape(BenchNode &node, DataType type, int64_t elements)
+{
+    return node.AddInput(type, {elements}) != nullptr && node.AddInput(type, {elements}) != nullptr &&
+        node.AddOutput(type, {elements}) != nullptr;
+}
+
+// bias style add: [n, c, h, w] + [c, 1, 1], with an odd channel count
+bool BuildAddChannelBroadcast(BenchNode &node, DataType type, int64_t elements)
+{
+    const int64_t channels = 3;
+    const int64_t width = 17;
+    int64_t height = elements / (channels * width);
+    if (height < 1) {
+        return false;
+    }
+    return node.AddInput(type, {1, channels, height, width}) != nullptr &&
+        node.AddInput(type, {channels, 1, 1}) != nullptr &&
+        node.AddOutput(type, {1, channels, height, width}) != nullptr;
+}
+
+// row broadcast: [rows, 64] + [64]
+bool BuildAddRowBroadcast(BenchNode &node, DataType type, int64_t elements)
+{
+    const int64_t cols = 64;
+    int64_t rows = elements / cols;
+    if (rows < 1) {
+        return false;
+    }
+    return node.AddInput(type, {rows, cols}) != nullptr && node.AddInput(type, {cols}) != nullptr &&
+        node.AddOutput(type, {rows, cols}) != nullptr;
+}
+}
+
+REGISTER_KERNEL_BENCH(Add_same, ADD, BuildAddSameShape, DT_FLOAT16, DT_FLOAT, DT_INT32, DT_INT64);
+REGISTER_KERNEL_BENCH(Add_channel, ADD, BuildAddChannelBroadcast, DT_FLOAT16, DT_FLOAT, DT_INT32, DT_INT64);
+REGISTER_KERNEL_BENCH(Add_row, ADD, BuildAddRowBroadcast, DT_FLOAT16, DT_FLOAT, DT_INT32, DT_INT64);
+} // namespace aicpu
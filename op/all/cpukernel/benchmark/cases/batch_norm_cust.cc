@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark cases of BatchNormCust
+ */
+
+#include <vector>
+#include "kernel_bench.h"
+
+namespace aicpu {
+namespace {
+const char *BATCH_NORM_CUST = "BatchNormCust";
+
+// square feature maps of channels planes, elements counts x
+bool BuildBatchNorm(BenchNode &node, DataType type, int64_t elements, int64_t channels, bool nhwc)
+{
+    int64_t side = 1;
+    while ((side + 1) * (side + 1) * channels <= elements) {
+        ++side;
+    }
+    std::vector<int64_t> dims = nhwc ? std::vector<int64_t>{1, side, side, channels} :
+        std::vector<int64_t>{1, channels, side, side};
+    if (node.AddInput(type, dims) == nullptr || node.AddInput(type, {channels}) == nullptr ||
+        node.AddInput(type, {channels}) == nullptr || node.AddOutput(type, dims) == nullptr) {
+        return false;
+    }
+    node.AddAttr("data_format")->SetString(nhwc ? "NHWC" : "NCHW");
+    return true;
+}
+
+// the shape family of the TIK tiling modes, which stop at 1024 channels of 32 x 32
+bool BuildBatchNormNchw(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildBatchNorm(node, type, elements, 64, false);
+}
+
+bool BuildBatchNormNhwc(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildBatchNorm(node, type, elements, 64, true);
+}
+
+// image input, three channels a row
+bool BuildBatchNormNhwcRgb(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildBatchNorm(node, type, elements, 3, true);
+}
+}
+
+REGISTER_KERNEL_BENCH(BatchNormCust_nchw, BATCH_NORM_CUST, BuildBatchNormNchw, DT_FLOAT16, DT_FLOAT);
+REGISTER_KERNEL_BENCH(BatchNormCust_nhwc, BATCH_NORM_CUST, BuildBatchNormNhwc, DT_FLOAT16, DT_FLOAT);
+REGISTER_KERNEL_BENCH(BatchNormCust_nhwc_rgb, BATCH_NORM_CUST, BuildBatchNormNhwcRgb, DT_FLOAT16, DT_FLOAT);
+} // namespace aicpu
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark cases of Conv2DTik
+ */
+
+#include <vector>
+#include "kernel_bench.h"
+
+namespace aicpu {
+namespace {
+const char *CONV2D_TIK = "Conv2DTik";
+// keeps the largest case near a GFLOP per launch
+const int64_t kMaxSide = 112;
+
+struct ConvCase {
+    int64_t in_c;
+    int64_t out_c;
+    int64_t kernel;
+    int64_t stride;
+};
+
+// elements is the output size, int8 writes int32 like the ai core kernel
+bool BuildConv(BenchNode &node, DataType type, int64_t elements, const ConvCase &conv)
+{
+    int64_t side = 1;
+    while ((side + 1) * (side + 1) * conv.out_c <= elements && side < kMaxSide) {
+        ++side;
+    }
+    int64_t pad = conv.kernel / 2;
+    int64_t in_side = side * conv.stride;
+    int64_t out_side = (in_side + 2 * pad - conv.kernel) / conv.stride + 1;
+    DataType out_type = (type == DT_INT8) ? DT_INT32 : type;
+    if (node.AddInput(type, {1, conv.in_c, in_side, in_side}) == nullptr ||
+        node.AddInput(type, {conv.out_c, conv.in_c, conv.kernel, conv.kernel}) == nullptr ||
+        node.AddOutput(out_type, {1, conv.out_c, out_side, out_side}) == nullptr) {
+        return false;
+    }
+    node.AddAttr("strides")->SetListInt({1, 1, conv.stride, conv.stride});
+    node.AddAttr("pads")->SetListInt({pad, pad, pad, pad});
+    node.SetFlops(static_cast<uint64_t>(2 * conv.out_c * out_side * out_side * conv.in_c * conv.kernel * conv.kernel));
+    return true;
+}
+
+// unit-stride 3x3 takes the Winograd path for float types
+bool BuildConv3x3(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildConv(node, type, elements, ConvCase{32, 32, 3, 1});
+}
+
+bool BuildConv3x3Stride2(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildConv(node, type, elements, ConvCase{32, 32, 3, 2});
+}
+
+// side branch pointwise conv on a small feature map
+bool BuildConv1x1(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildConv(node, type, elements, ConvCase{64, 16, 1, 1});
+}
+}
+
+REGISTER_KERNEL_BENCH(Conv2DTik_3x3, CONV2D_TIK, BuildConv3x3, DT_FLOAT16, DT_FLOAT, DT_INT8);
+REGISTER_KERNEL_BENCH(Conv2DTik_3x3_s2, CONV2D_TIK, BuildConv3x3Stride2, DT_FLOAT16, DT_INT8);
+REGISTER_KERNEL_BENCH(Conv2DTik_1x1, CONV2D_TIK, BuildConv1x1, DT_FLOAT16, DT_INT8);
+} // namespace aicpu
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark cases of DecodeBboxV2
+ */
+
+#include <vector>
+#include "kernel_bench.h"
+
+namespace aicpu {
+namespace {
+const char *DECODE_BBOX_V2 = "DecodeBboxV2";
+
+// elements counts coordinates, four per anchor
+bool BuildDecode(BenchNode &node, DataType type, int64_t elements, bool reversed)
+{
+    int64_t anchors = elements / 4;
+    std::vector<int64_t> dims = reversed ? std::vector<int64_t>{4, anchors} : std::vector<int64_t>{anchors, 4};
+    if (anchors == 0 || node.AddInput(type, dims) == nullptr || node.AddInput(type, dims) == nullptr ||
+        node.AddOutput(type, dims) == nullptr) {
+        return false;
+    }
+    node.AddAttr("scales")->SetListFloat({10.0f, 10.0f, 5.0f, 5.0f});
+    node.AddAttr("reversed_box")->SetBool(reversed);
+    return true;
+}
+
+bool BuildDecodeBoxes(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildDecode(node, type, elements, false);
+}
+
+bool BuildDecodeReversed(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildDecode(node, type, elements, true);
+}
+}
+
+REGISTER_KERNEL_BENCH(DecodeBboxV2_boxes, DECODE_BBOX_V2, BuildDecodeBoxes, DT_FLOAT16, DT_FLOAT);
+REGISTER_KERNEL_BENCH(DecodeBboxV2_reversed, DECODE_BBOX_V2, BuildDecodeReversed, DT_FLOAT);
+} // namespace aicpu
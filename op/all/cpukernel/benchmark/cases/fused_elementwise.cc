@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark cases of FusedElementwise
+ */
+
+#include "kernel_bench.h"
+
+namespace aicpu {
+namespace {
+const char *FUSED_ELEMENTWISE = "FusedElementwise";
+
+// Add(Add(Abs(x0), 1.0), Abs(x1)), the chain of IRBuild/data/tensorflow_generate.py
+bool BuildFusedAbsAddChain(BenchNode &node, DataType type, int64_t elements)
+{
+    if (node.AddInput(type, {elements}) == nullptr || node.AddInput(type, {elements}) == nullptr ||
+        node.AddOutput(type, {elements}) == nullptr) {
+        return false;
+    }
+    // values: x0, x1, constant 1.0, then one per instruction
+    node.AddAttr("program")->SetListInt({0, 0, -1, 0, 1, -1, 4, 3, 2, 4, 5, 4});
+    node.AddAttr("constants")->SetListFloat({1.0f});
+    node.SetFlops(static_cast<uint64_t>(elements) * 4);
+    return true;
+}
+}
+
+REGISTER_KERNEL_BENCH(FusedElementwise_abs_add, FUSED_ELEMENTWISE, BuildFusedAbsAddChain, DT_FLOAT16, DT_FLOAT);
+} // namespace aicpu
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark cases of MatmulTik
+ */
+
+#include <algorithm>
+#include "kernel_bench.h"
+
+namespace aicpu {
+namespace {
+const char *MATMUL_TIK = "MatmulTik";
+// keeps the largest case at about 2 GFLOP per launch
+const int64_t kMaxSide = 1024;
+
+// float16 accumulates to float and int8 to int32, as in the ai core ini
+DataType AccumulateType(DataType type)
+{
+    switch (type) {
+        case DT_FLOAT16: return DT_FLOAT;
+        case DT_INT8:
+        case DT_UINT8: return DT_INT32;
+        default: return type;
+    }
+}
+
+bool BuildMatmul(BenchNode &node, DataType type, int64_t m, int64_t n, int64_t k)
+{
+    if (node.AddInput(type, {m, k}) == nullptr || node.AddInput(type == DT_UINT8 ? DT_INT8 : type, {k, n}) == nullptr ||
+        node.AddOutput(AccumulateType(type), {m, n}) == nullptr) {
+        return false;
+    }
+    node.SetFlops(static_cast<uint64_t>(2 * m * n * k));
+    return true;
+}
+
+int64_t Side(int64_t elements)
+{
+    int64_t side = 1;
+    while ((side + 1) * (side + 1) <= elements && side < kMaxSide) {
+        ++side;
+    }
+    return side;
+}
+
+// elements is the size of the output in every case
+bool BuildMatmulSquare(BenchNode &node, DataType type, int64_t elements)
+{
+    int64_t side = Side(elements);
+    return BuildMatmul(node, type, side, side, side);
+}
+
+// none of m, n, k is a multiple of the tiling sizes matmul_tik.py needs
+bool BuildMatmulOdd(BenchNode &node, DataType type, int64_t elements)
+{
+    int64_t side = Side(elements);
+    return BuildMatmul(node, type, std::max<int64_t>(side - 3, 1), side + 5, side + 7);
+}
+
+// a handful of rows against a wide weight, like a fully connected layer at small batch
+bool BuildMatmulSkinny(BenchNode &node, DataType type, int64_t elements)
+{
+    const int64_t rows = 8;
+    const int64_t depth = 512;
+    return BuildMatmul(node, type, rows, std::min<int64_t>(std::max<int64_t>(elements / rows, 1), 8192), depth);
+}
+
+// attention heads against one shared weight stored as [n, k], batch of x1 only
+bool BuildMatmulBatched(BenchNode &node, DataType type, int64_t elements)
+{
+    const int64_t heads = 8;
+    const int64_t depth = 64;
+    int64_t rows = std::min<int64_t>(std::max<int64_t>(elements / (heads * depth), 1), kMaxSide);
+    if (node.AddInput(type, {heads, rows, depth}) == nullptr ||
+        node.AddInput(type == DT_UINT8 ? DT_INT8 : type, {depth, depth}) == nullptr ||
+        node.AddOutput(AccumulateType(type), {heads, rows, depth}) == nullptr) {
+        return false;
+    }
+    node.AddAttr("transpose_x2")->SetBool(true);
+    node.SetFlops(static_cast<uint64_t>(2 * heads * rows * depth * depth));
+    return true;
+}
+}
+
+REGISTER_KERNEL_BENCH(MatmulTik_square, MATMUL_TIK, BuildMatmulSquare, DT_FLOAT16, DT_FLOAT, DT_INT8);
+REGISTER_KERNEL_BENCH(MatmulTik_odd, MATMUL_TIK, BuildMatmulOdd, DT_FLOAT16, DT_INT8);
+REGISTER_KERNEL_BENCH(MatmulTik_skinny, MATMUL_TIK, BuildMatmulSkinny, DT_FLOAT16, DT_INT8);
+REGISTER_KERNEL_BENCH(MatmulTik_batched, MATMUL_TIK, BuildMatmulBatched, DT_FLOAT16, DT_FLOAT);
+} // namespace aicpu
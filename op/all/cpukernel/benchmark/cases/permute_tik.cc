@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark cases of PermuteTik
+ */
+
+#include <vector>
+#include "kernel_bench.h"
+
+namespace aicpu {
+namespace {
+const char *PERMUTE_TIK = "PermuteTik";
+
+bool BuildPermute(BenchNode &node, DataType type, const std::vector<int64_t> &dims,
+                  const std::vector<int64_t> &order)
+{
+    std::vector<int64_t> out_dims;
+    for (int64_t axis : order) {
+        out_dims.push_back(dims[axis]);
+    }
+    if (node.AddInput(type, dims) == nullptr || node.AddOutput(type, out_dims) == nullptr) {
+        return false;
+    }
+    node.AddAttr("order")->SetListInt(order);
+    return true;
+}
+
+// SSD head: [1, c, h, w] -> [1, h, w, c]
+bool BuildPermuteNchwToNhwc(BenchNode &node, DataType type, int64_t elements)
+{
+    const int64_t channels = 24;
+    int64_t side = 1;
+    while ((side + 1) * (side + 1) * channels <= elements) {
+        ++side;
+    }
+    return BuildPermute(node, type, {1, channels, side, side}, {0, 2, 3, 1});
+}
+
+// an order the AI Core kernel rejects, innermost axis stays put
+bool BuildPermuteRows(BenchNode &node, DataType type, int64_t elements)
+{
+    const int64_t width = 32;
+    int64_t side = 1;
+    while ((side + 1) * (side + 1) * width * 4 <= elements) {
+        ++side;
+    }
+    return BuildPermute(node, type, {4, side, side, width}, {2, 0, 1, 3});
+}
+}
+
+REGISTER_KERNEL_BENCH(PermuteTik_nhwc, PERMUTE_TIK, BuildPermuteNchwToNhwc, DT_FLOAT16, DT_FLOAT, DT_INT8);
+REGISTER_KERNEL_BENCH(PermuteTik_rows, PERMUTE_TIK, BuildPermuteRows, DT_FLOAT16, DT_FLOAT);
+} // namespace aicpu
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark cases of ReshapeCust
+ */
+
+#include <vector>
+#include "kernel_bench.h"
+
+namespace aicpu {
+namespace {
+const char *RESHAPE_CUST = "ReshapeCust";
+
+bool BuildReshapeCust(BenchNode &node, DataType type, int64_t elements, bool alias)
+{
+    if (node.AddInput(type, {elements}) == nullptr) {
+        return false;
+    }
+    Tensor *shape = node.AddInput(DT_INT64, {2});
+    if (shape == nullptr) {
+        return false;
+    }
+    int64_t *shape_data = static_cast<int64_t *>(shape->GetData());
+    shape_data[0] = elements / 64;
+    shape_data[1] = 64;
+    Tensor *output = alias ? node.AddRefOutput(0, {elements / 64, 64}) : node.AddOutput(type, {elements / 64, 64});
+    return output != nullptr;
+}
+
+bool BuildReshapeCustCopy(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildReshapeCust(node, type, elements, false);
+}
+
+bool BuildReshapeCustAlias(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildReshapeCust(node, type, elements, true);
+}
+
+/*
+ * x as a strided view of a [rows, 64] buffer: the left half of every row
+ * when sliced, all of it read column by column when transposed. elements
+ * counts the view.
+ */
+bool BuildReshapeCustStrided(BenchNode &node, DataType type, int64_t elements, bool transposed)
+{
+    const int64_t cols = 64;
+    int64_t view_cols = transposed ? cols : cols / 2;
+    int64_t rows = elements / view_cols;
+    if (rows < 1) {
+        return false;
+    }
+    Tensor *x = node.AddInput(type, {rows, cols});
+    if (x == nullptr) {
+        return false;
+    }
+    // the buffer keeps the data size of the whole [rows, cols] block
+    TensorShape view_shape(transposed ? std::vector<int64_t>{cols, rows} : std::vector<int64_t>{rows, view_cols});
+    x->SetTensorShape(&view_shape);
+    Tensor *shape = node.AddInput(DT_INT64, {1});
+    if (shape == nullptr) {
+        return false;
+    }
+    static_cast<int64_t *>(shape->GetData())[0] = rows * view_cols;
+    if (node.AddOutput(type, {rows * view_cols}) == nullptr) {
+        return false;
+    }
+    node.AddAttr("strides")->SetListInt(transposed ? std::vector<int64_t>{1, cols} : std::vector<int64_t>{cols, 1});
+    return true;
+}
+
+bool BuildReshapeCustSliced(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildReshapeCustStrided(node, type, elements, false);
+}
+
+bool BuildReshapeCustTransposed(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildReshapeCustStrided(node, type, elements, true);
+}
+}
+
+REGISTER_KERNEL_BENCH(ReshapeCust_copy, RESHAPE_CUST, BuildReshapeCustCopy, DT_FLOAT16, DT_FLOAT, DT_INT8, DT_INT64);
+REGISTER_KERNEL_BENCH(ReshapeCust_alias, RESHAPE_CUST, BuildReshapeCustAlias, DT_FLOAT16, DT_FLOAT);
+REGISTER_KERNEL_BENCH(ReshapeCust_sliced, RESHAPE_CUST, BuildReshapeCustSliced, DT_FLOAT16, DT_FLOAT);
+REGISTER_KERNEL_BENCH(ReshapeCust_transposed, RESHAPE_CUST, BuildReshapeCustTransposed, DT_FLOAT16, DT_FLOAT);
+} // namespace aicpu
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark cases of ScatterNdAdd
+ */
+
+#include <random>
+#include "kernel_bench.h"
+
+namespace aicpu {
+namespace {
+const char *SCATTER_ND_ADD = "ScatterNdAdd";
+const int64_t kEmbeddingDim = 64;
+
+/*
+ * Embedding style update: var is [rows, 64], a quarter of the rows receive
+ * updates and the indices follow a skewed distribution, so many repeat.
+ */
+bool BuildScatterNdAdd(BenchNode &node, DataType type, int64_t elements)
+{
+    int64_t rows = elements / kEmbeddingDim;
+    int64_t index_num = rows / 4;
+    if (rows < 4) {
+        return false;
+    }
+    if (node.AddInput(type, {rows, kEmbeddingDim}) == nullptr) {
+        return false;
+    }
+    Tensor *indices = node.AddInput(DT_INT32, {index_num, 1});
+    if (indices == nullptr || node.AddInput(type, {index_num, kEmbeddingDim}) == nullptr) {
+        return false;
+    }
+    std::mt19937 engine(static_cast<uint32_t>(rows));
+    std::geometric_distribution<int32_t> skewed(8.0 / rows);
+    int32_t *indices_data = static_cast<int32_t *>(indices->GetData());
+    for (int64_t i = 0; i < index_num; ++i) {
+        indices_data[i] = static_cast<int32_t>(skewed(engine) % rows);
+    }
+    if (node.AddRefOutput(0, {rows, kEmbeddingDim}) == nullptr) {
+        return false;
+    }
+    // var rows are read and written once per update
+    int64_t type_size = BenchDataTypeSize(type);
+    node.SetBytesMoved(static_cast<uint64_t>(index_num * kEmbeddingDim * type_size * 3 + index_num * 4));
+    return true;
+}
+}
+
+REGISTER_KERNEL_BENCH(ScatterNdAdd, SCATTER_ND_ADD, BuildScatterNdAdd, DT_FLOAT16, DT_FLOAT, DT_INT32, DT_INT8,
+    DT_UINT8);
+} // namespace aicpu
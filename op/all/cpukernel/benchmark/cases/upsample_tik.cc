@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark cases of UpsampleTik
+ */
+
+#include <vector>
+#include "kernel_bench.h"
+
+namespace aicpu {
+namespace {
+const char *UPSAMPLE_TIK = "UpsampleTik";
+
+// yolo style 2x upsample of [1, c, h, w], elements counts the input
+bool BuildUpsample(BenchNode &node, DataType type, int64_t elements, float scale)
+{
+    const int64_t channels = 128;
+    const int64_t stride = 2;
+    int64_t side = 1;
+    while ((side + 1) * (side + 1) * channels <= elements) {
+        ++side;
+    }
+    if (node.AddInput(type, {1, channels, side, side}) == nullptr ||
+        node.AddOutput(type, {1, channels, side * stride, side * stride}) == nullptr) {
+        return false;
+    }
+    node.AddAttr("scale")->SetFloat(scale);
+    node.AddAttr("stride_h")->SetInt(stride);
+    node.AddAttr("stride_w")->SetInt(stride);
+    return true;
+}
+
+bool BuildUpsampleCopy(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildUpsample(node, type, elements, 1.0f);
+}
+
+bool BuildUpsampleScaled(BenchNode &node, DataType type, int64_t elements)
+{
+    return BuildUpsample(node, type, elements, 0.5f);
+}
+}
+
+REGISTER_KERNEL_BENCH(UpsampleTik_copy, UPSAMPLE_TIK, BuildUpsampleCopy, DT_FLOAT16, DT_FLOAT);
+REGISTER_KERNEL_BENCH(UpsampleTik_scaled, UPSAMPLE_TIK, BuildUpsampleScaled, DT_FLOAT16, DT_FLOAT);
+} // namespace aicpu
@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: throughput benchmark of the float16 conversion library
+ *
+ * Compares the bulk conversions and the float16 helpers built on them with
+ * the per-element scalar loops they replace. Needs no kernel context and
+ * builds for both the board and the host:
+ *   g++ -O2 -std=c++11 -I../impl fp16_bench.cc -o fp16_bench
+ * add -mavx2 -mf16c on x86 hosts to measure the F16C path.
+ * Usage: fp16_bench
+ */
+
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <random>
+#include <vector>
+#include "fp16_utils.h"
+#include "vector_ops.h"
+
+namespace {
+const int kRepeatTimes = 20;
+const int64_t kBenchElements[] = {64, 1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024};
+
+// stops the compiler from dropping results nobody reads
+volatile float g_sink = 0.0f;
+
+// best of kRepeatTimes, in elements per ns
+double MeasureElementsPerNs(int64_t n, const std::function<void()> &run)
+{
+    // small sizes repeat inside the timed region to stay above timer resolution
+    int64_t inner = std::max<int64_t>(1, (64 * 1024) / n);
+    double best_ns = 0.0;
+    for (int i = 0; i < kRepeatTimes; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        for (int64_t j = 0; j < inner; ++j) {
+            run();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / inner;
+        if (i == 0 || ns < best_ns) {
+            best_ns = ns;
+        }
+    }
+    return n / best_ns;
+}
+
+void PrintRow(const char *name, int64_t n, double scalar, double bulk)
+{
+    printf("%-12s %10lld %12.3f %12.3f %9.2fx\n", name, static_cast<long long>(n), scalar, bulk, bulk / scalar);
+}
+}
+
+int main()
+{
+    printf("native lanes: %lld\n", static_cast<long long>(aicpu::kHalfConvertLanes));
+    printf("%-12s %10s %12s %12s %10s\n", "case", "elements", "scalar el/ns", "bulk el/ns", "speedup");
+    std::mt19937 engine(0);
+    std::uniform_real_distribution<float> dist(-8.0f, 8.0f);
+    for (int64_t n : kBenchElements) {
+        std::vector<float> f0(n);
+        std::vector<float> f1(n);
+        std::vector<aicpu::Half> h0(n);
+        std::vector<aicpu::Half> h1(n);
+        std::vector<aicpu::Half> h2(n);
+        for (int64_t i = 0; i < n; ++i) {
+            f0[i] = dist(engine);
+            h0[i] = aicpu::FloatToHalf(f0[i]);
+            h1[i] = aicpu::FloatToHalf(dist(engine));
+        }
+
+        PrintRow("HalfToFloat", n,
+            MeasureElementsPerNs(n, [&]() { aicpu::HalfToFloatScalar(h0.data(), f1.data(), n); }),
+            MeasureElementsPerNs(n, [&]() { aicpu::HalfToFloat(h0.data(), f1.data(), n); }));
+        PrintRow("FloatToHalf", n,
+            MeasureElementsPerNs(n, [&]() { aicpu::FloatToHalfScalar(f0.data(), h2.data(), n); }),
+            MeasureElementsPerNs(n, [&]() { aicpu::FloatToHalf(f0.data(), h2.data(), n); }));
+        PrintRow("Add<Half>", n,
+            MeasureElementsPerNs(n, [&]() {
+                for (int64_t i = 0; i < n; ++i) {
+                    h2[i] = aicpu::FloatToHalf(aicpu::HalfToFloat(h0[i]) + aicpu::HalfToFloat(h1[i]));
+                }
+            }),
+            MeasureElementsPerNs(n, [&]() { aicpu::Add(h2.data(), h0.data(), h1.data(), n); }));
+        PrintRow("HalfSum", n,
+            MeasureElementsPerNs(n, [&]() {
+                float total = 0.0f;
+                for (int64_t i = 0; i < n; ++i) {
+                    total += aicpu::HalfToFloat(h0[i]);
+                }
+                g_sink = total;
+            }),
+            MeasureElementsPerNs(n, [&]() { g_sink = aicpu::HalfSum(h0.data(), n); }));
+    }
+    return 0;
+}
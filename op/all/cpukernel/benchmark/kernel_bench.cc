@@ -0,0 +1,284 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host micro-benchmark driver for AI CPU kernels
+ *
+ * Usage: kernel_bench [--op=<op type>] [--threads=<n>] [--max_elements=<n>] [--repeat=<n>]
+ */
+
+#include "kernel_bench.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <set>
+#include "fp16_utils.h"
+
+namespace aicpu {
+namespace {
+const uint64_t kBufferAlign = 64;
+const int64_t kBenchElements[] = {1024, 64 * 1024, 1024 * 1024, 16 * 1024 * 1024};
+
+struct BenchOptions {
+    std::string op_type;
+    uint32_t threads = 1;
+    int64_t max_elements = 16 * 1024 * 1024;
+    int repeat = 20;
+};
+
+std::vector<KernelBench> &BenchRegistry()
+{
+    static std::vector<KernelBench> registry;
+    return registry;
+}
+
+bool ParseOptions(int argc, char *argv[], BenchOptions &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (strncmp(arg, "--op=", 5) == 0) {
+            options.op_type = arg + 5;
+        } else if (strncmp(arg, "--threads=", 10) == 0) {
+            options.threads = static_cast<uint32_t>(std::max(1, atoi(arg + 10)));
+        } else if (strncmp(arg, "--max_elements=", 15) == 0) {
+            options.max_elements = std::max(1LL, atoll(arg + 15));
+        } else if (strncmp(arg, "--repeat=", 9) == 0) {
+            options.repeat = std::max(1, atoi(arg + 9));
+        } else {
+            printf("Usage: %s [--op=<op type>] [--threads=<n>] [--max_elements=<n>] [--repeat=<n>]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+int RunBench(const KernelBench &bench, const BenchOptions &options)
+{
+    int failed = 0;
+    for (DataType type : bench.types) {
+        for (int64_t elements : kBenchElements) {
+            if (elements > options.max_elements) {
+                continue;
+            }
+            BenchNode node(bench.op_type);
+            node.Context().SetCpuNum(options.threads);
+            if (!bench.builder(node, type, elements)) {
+                continue;
+            }
+            std::shared_ptr<CpuKernel> kernel = CreateCpuKernel(bench.op_type);
+            if (kernel == nullptr) {
+                printf("%-24s no kernel registered for %s\n", bench.name.c_str(), bench.op_type.c_str());
+                return 1;
+            }
+
+            // the first launch warms caches and page tables and is not timed
+            if (kernel->Compute(node.Context()) != 0) {
+                printf("%-24s %-10s %12lld compute failed\n", bench.name.c_str(), BenchDataTypeName(type),
+                    static_cast<long long>(elements));
+                ++failed;
+                continue;
+            }
+            double best_ns = 0.0;
+            for (int i = 0; i < options.repeat; ++i) {
+                auto begin = std::chrono::steady_clock::now();
+                (void)kernel->Compute(node.Context());
+                auto end = std::chrono::steady_clock::now();
+                double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+                if (i == 0 || ns < best_ns) {
+                    best_ns = ns;
+                }
+            }
+            printf("%-24s %-10s %12lld %8u %14.0f %10.3f %10.2f", bench.name.c_str(), BenchDataTypeName(type),
+                static_cast<long long>(elements), options.threads, best_ns, best_ns / elements,
+                node.BytesMoved() / best_ns);
+            if (node.Flops() != 0) {
+                printf(" %10.2f", node.Flops() / best_ns);
+            }
+            printf("\n");
+        }
+    }
+    return failed;
+}
+}
+
+BenchNode::BenchNode(const std::string &op_type)
+{
+    ctx_.SetOpType(op_type);
+}
+
+Tensor *BenchNode::NewTensor(DataType type, const std::vector<int64_t> &dims, void *data)
+{
+    std::shared_ptr<Tensor> tensor = std::make_shared<Tensor>();
+    TensorShape shape(dims);
+    tensor->SetTensorShape(&shape);
+    tensor->SetDataType(type);
+    tensor->SetData(data);
+    int64_t size = tensor->CalcDataSizeByShape();
+    tensor->SetDataSize(size < 0 ? 0 : static_cast<uint64_t>(size));
+    tensors_.push_back(tensor);
+    return tensor.get();
+}
+
+Tensor *BenchNode::AddInput(DataType type, const std::vector<int64_t> &dims)
+{
+    TensorShape shape(dims);
+    int64_t elements = shape.NumElements();
+    uint64_t size = static_cast<uint64_t>(elements * std::max<int64_t>(BenchDataTypeSize(type), 1));
+    uint64_t alloc_size = (size + kBufferAlign - 1) / kBufferAlign * kBufferAlign + kBufferAlign;
+    void *data = nullptr;
+    if (posix_memalign(&data, kBufferAlign, alloc_size) != 0) {
+        return nullptr;
+    }
+    buffers_.push_back(std::shared_ptr<uint8_t>(static_cast<uint8_t *>(data), free));
+    FillRandom(type, data, elements);
+    Tensor *tensor = NewTensor(type, dims, data);
+    ctx_.AddInput(tensor);
+    return tensor;
+}
+
+Tensor *BenchNode::AddOutput(DataType type, const std::vector<int64_t> &dims)
+{
+    TensorShape shape(dims);
+    uint64_t size = static_cast<uint64_t>(shape.NumElements() * std::max<int64_t>(BenchDataTypeSize(type), 1));
+    uint64_t alloc_size = (size + kBufferAlign - 1) / kBufferAlign * kBufferAlign + kBufferAlign;
+    void *data = nullptr;
+    if (posix_memalign(&data, kBufferAlign, alloc_size) != 0) {
+        return nullptr;
+    }
+    memset(data, 0, alloc_size);
+    buffers_.push_back(std::shared_ptr<uint8_t>(static_cast<uint8_t *>(data), free));
+    Tensor *tensor = NewTensor(type, dims, data);
+    ctx_.AddOutput(tensor);
+    return tensor;
+}
+
+Tensor *BenchNode::AddRefOutput(uint32_t input_index, const std::vector<int64_t> &dims)
+{
+    Tensor *input = ctx_.Input(input_index);
+    if (input == nullptr) {
+        return nullptr;
+    }
+    Tensor *tensor = NewTensor(input->GetDataType(), dims, input->GetData());
+    ctx_.AddOutput(tensor);
+    return tensor;
+}
+
+uint64_t BenchNode::BytesMoved() const
+{
+    if (bytes_moved_ != 0) {
+        return bytes_moved_;
+    }
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < ctx_.GetInputsSize(); ++i) {
+        bytes += ctx_.Input(i)->GetDataSize();
+    }
+    for (uint32_t i = 0; i < ctx_.GetOutputsSize(); ++i) {
+        bytes += ctx_.Output(i)->GetDataSize();
+    }
+    return bytes;
+}
+
+bool RegistKernelBench(const KernelBench &bench)
+{
+    BenchRegistry().push_back(bench);
+    return true;
+}
+
+int64_t BenchDataTypeSize(DataType type)
+{
+    Tensor tensor;
+    tensor.SetDataType(type);
+    return tensor.CalcDataSizeByShape();
+}
+
+const char *BenchDataTypeName(DataType type)
+{
+    switch (type) {
+        case DT_FLOAT: return "float";
+        case DT_FLOAT16: return "float16";
+        case DT_DOUBLE: return "double";
+        case DT_INT8: return "int8";
+        case DT_UINT8: return "uint8";
+        case DT_INT16: return "int16";
+        case DT_UINT16: return "uint16";
+        case DT_INT32: return "int32";
+        case DT_UINT32: return "uint32";
+        case DT_INT64: return "int64";
+        case DT_UINT64: return "uint64";
+        case DT_BOOL: return "bool";
+        case DT_COMPLEX64: return "complex64";
+        case DT_COMPLEX128: return "complex128";
+        case DT_QINT8: return "qint8";
+        case DT_QUINT8: return "quint8";
+        case DT_QINT16: return "qint16";
+        case DT_QUINT16: return "quint16";
+        case DT_QINT32: return "qint32";
+        default: return "unknown";
+    }
+}
+
+void FillRandom(DataType type, void *data, int64_t elements)
+{
+    std::mt19937 engine(static_cast<uint32_t>(elements));
+    std::uniform_real_distribution<float> real(-1.0f, 1.0f);
+    std::uniform_int_distribution<int32_t> small(0, 255);
+    for (int64_t i = 0; i < elements; ++i) {
+        switch (type) {
+            case DT_FLOAT:
+                static_cast<float *>(data)[i] = real(engine);
+                break;
+            case DT_DOUBLE:
+                static_cast<double *>(data)[i] = real(engine);
+                break;
+            case DT_FLOAT16:
+                static_cast<Half *>(data)[i] = FloatToHalf(real(engine));
+                break;
+            case DT_COMPLEX64:
+                static_cast<float *>(data)[2 * i] = real(engine);
+                static_cast<float *>(data)[2 * i + 1] = real(engine);
+                break;
+            case DT_COMPLEX128:
+                static_cast<double *>(data)[2 * i] = real(engine);
+                static_cast<double *>(data)[2 * i + 1] = real(engine);
+                break;
+            default: {
+                int64_t size = BenchDataTypeSize(type);
+                if (size <= 0) {
+                    return;
+                }
+                // small non-negative integers are valid in every integer type
+                uint64_t value = static_cast<uint64_t>(small(engine) & (type == DT_BOOL ? 1 : 63));
+                memcpy(static_cast<uint8_t *>(data) + i * size, &value, static_cast<size_t>(size));
+                break;
+            }
+        }
+    }
+}
+} // namespace aicpu
+
+int main(int argc, char *argv[])
+{
+    aicpu::BenchOptions options;
+    if (!aicpu::ParseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::set<std::string> covered;
+    printf("%-24s %-10s %12s %8s %14s %10s %10s %10s\n", "bench", "dtype", "elements", "threads", "ns", "ns/elem", "GB/s",
+        "GFLOP/s");
+    int failed = 0;
+    for (const aicpu::KernelBench &bench : aicpu::BenchRegistry()) {
+        covered.insert(bench.op_type);
+        if (!options.op_type.empty() && options.op_type != bench.op_type) {
+            continue;
+        }
+        failed += aicpu::RunBench(bench, options);
+    }
+    for (const std::string &type : aicpu::GetAllCpuKernelTypes()) {
+        if (covered.count(type) == 0) {
+            printf("%-24s no benchmark case\n", type.c_str());
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
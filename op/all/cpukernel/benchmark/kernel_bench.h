@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of the host micro-benchmark driver for AI CPU kernels
+ */
+
+#ifndef _AICPU_KERNEL_BENCH_H_
+#define _AICPU_KERNEL_BENCH_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "cpu_kernel.h"
+
+namespace aicpu {
+/*
+ * One kernel launch assembled by hand: owns the tensors, their buffers and
+ * the context handed to Compute.
+ */
+class BenchNode {
+public:
+    explicit BenchNode(const std::string &op_type);
+    ~BenchNode() = default;
+
+    // allocate a 64 byte aligned buffer for dims, filled with small random values
+    Tensor *AddInput(DataType type, const std::vector<int64_t> &dims);
+    Tensor *AddOutput(DataType type, const std::vector<int64_t> &dims);
+    // output that shares the buffer of an input, like a ref output in GE
+    Tensor *AddRefOutput(uint32_t input_index, const std::vector<int64_t> &dims);
+    AttrValue *AddAttr(const std::string &name) { return ctx_.AddAttr(name); }
+    CpuKernelContext &Context() { return ctx_; }
+
+    // bytes touched by one launch, defaults to all input and output bytes
+    uint64_t BytesMoved() const;
+    void SetBytesMoved(uint64_t bytes) { bytes_moved_ = bytes; }
+    // arithmetic operations of one launch, compute bound cases report GFLOP/s when set
+    uint64_t Flops() const { return flops_; }
+    void SetFlops(uint64_t flops) { flops_ = flops; }
+
+private:
+    Tensor *NewTensor(DataType type, const std::vector<int64_t> &dims, void *data);
+
+    CpuKernelContext ctx_;
+    std::vector<std::shared_ptr<Tensor>> tensors_;
+    std::vector<std::shared_ptr<uint8_t>> buffers_;
+    uint64_t bytes_moved_ = 0;
+    uint64_t flops_ = 0;
+};
+
+// build the node of op_type for dtype type with about elements elements
+using BenchBuilder = std::function<bool(BenchNode &node, DataType type, int64_t elements)>;
+
+struct KernelBench {
+    std::string name;
+    std::string op_type;
+    std::vector<DataType> types;
+    BenchBuilder builder;
+};
+
+bool RegistKernelBench(const KernelBench &bench);
+
+int64_t BenchDataTypeSize(DataType type);
+const char *BenchDataTypeName(DataType type);
+void FillRandom(DataType type, void *data, int64_t elements);
+
+// the trailing arguments are the dtypes to sweep
+#define REGISTER_KERNEL_BENCH(name, op_type, builder, ...)                  \
+    bool g_##name##_Bench_Register __attribute__((unused)) =                \
+        RegistKernelBench(KernelBench{#name, op_type, std::vector<DataType>{__VA_ARGS__}, builder})
+} // namespace aicpu
+#endif
@@ -0,0 +1,1061 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host correctness test of the AI CPU kernels
+ *
+ * Every case builds random shapes and data, runs the registered kernel with
+ * 1 to 4 threads and compares y against a naive reference computed in
+ * double. Inputs hold small integers, so the float paths are exact up to
+ * the rounding of the output dtype.
+ *
+ * Usage: kernel_test [--op=<op type>] [--iterations=<n>] [--seed=<n>]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+#include "cpu_kernel.h"
+#include "fp16_utils.h"
+
+namespace aicpu {
+namespace {
+const uint32_t kMaxTestThreads = 4;
+
+struct TestOptions {
+    std::string op_type;
+    int iterations = 40;
+    uint32_t seed = 1;
+};
+
+/*
+ * One launch assembled by hand. Buffers are sized exactly to their shape,
+ * so a sanitizer build catches any access past the end.
+ */
+class TestNode {
+public:
+    explicit TestNode(uint32_t threads) { ctx_.SetCpuNum(threads); }
+    ~TestNode() = default;
+
+    Tensor *AddInput(DataType type, const std::vector<int64_t> &dims, const std::vector<double> &values);
+    Tensor *AddOutput(DataType type, const std::vector<int64_t> &dims);
+    // output that shares the buffer of an input, like a ref output in GE
+    Tensor *AddRefOutput(uint32_t input_index, const std::vector<int64_t> &dims);
+    AttrValue *AddAttr(const std::string &name) { return ctx_.AddAttr(name); }
+    uint32_t Run(const std::string &op_type);
+
+private:
+    Tensor *NewTensor(DataType type, const std::vector<int64_t> &dims, void *data, uint64_t size);
+
+    CpuKernelContext ctx_;
+    std::vector<std::shared_ptr<Tensor>> tensors_;
+    std::vector<std::shared_ptr<std::vector<uint8_t>>> buffers_;
+};
+
+using KernelTestFunc = bool (*)(std::mt19937 &engine, uint32_t threads);
+
+struct KernelTest {
+    const char *op_type;
+    KernelTestFunc func;
+};
+
+int64_t TypeSize(DataType type)
+{
+    Tensor tensor;
+    tensor.SetDataType(type);
+    return tensor.CalcDataSizeByShape();
+}
+
+int64_t NumElements(const std::vector<int64_t> &dims)
+{
+    return std::accumulate(dims.begin(), dims.end(), static_cast<int64_t>(1), std::multiplies<int64_t>());
+}
+
+double LoadValue(DataType type, const void *data, int64_t i)
+{
+    switch (type) {
+        case DT_FLOAT: return static_cast<const float *>(data)[i];
+        case DT_FLOAT16: return HalfToFloat(static_cast<const Half *>(data)[i]);
+        case DT_DOUBLE: return static_cast<const double *>(data)[i];
+        case DT_INT8: return static_cast<const int8_t *>(data)[i];
+        case DT_UINT8: return static_cast<const uint8_t *>(data)[i];
+        case DT_INT16: return static_cast<const int16_t *>(data)[i];
+        case DT_INT32: return static_cast<const int32_t *>(data)[i];
+        case DT_INT64: return static_cast<double>(static_cast<const int64_t *>(data)[i]);
+        default: return 0.0;
+    }
+}
+
+// integer types wrap like the kernels do
+void StoreValue(DataType type, void *data, int64_t i, double value)
+{
+    int64_t integer = static_cast<int64_t>(value);
+    switch (type) {
+        case DT_FLOAT: static_cast<float *>(data)[i] = static_cast<float>(value); break;
+        case DT_FLOAT16: static_cast<Half *>(data)[i] = FloatToHalf(static_cast<float>(value)); break;
+        case DT_DOUBLE: static_cast<double *>(data)[i] = value; break;
+        case DT_INT8: static_cast<int8_t *>(data)[i] = static_cast<int8_t>(integer); break;
+        case DT_UINT8: static_cast<uint8_t *>(data)[i] = static_cast<uint8_t>(integer); break;
+        case DT_INT16: static_cast<int16_t *>(data)[i] = static_cast<int16_t>(integer); break;
+        case DT_INT32: static_cast<int32_t *>(data)[i] = static_cast<int32_t>(integer); break;
+        case DT_INT64: static_cast<int64_t *>(data)[i] = integer; break;
+        default: break;
+    }
+}
+
+// value as a tensor of type holds it
+double RoundTo(DataType type, double value)
+{
+    uint8_t storage[sizeof(double)];
+    StoreValue(type, storage, 0, value);
+    return LoadValue(type, storage, 0);
+}
+
+std::vector<double> Values(const Tensor *tensor)
+{
+    int64_t elements = tensor->NumElements();
+    std::vector<double> values(static_cast<size_t>(elements));
+    for (int64_t i = 0; i < elements; ++i) {
+        values[i] = LoadValue(tensor->GetDataType(), tensor->GetData(), i);
+    }
+    return values;
+}
+
+int64_t Uniform(std::mt19937 &engine, int64_t low, int64_t high)
+{
+    return std::uniform_int_distribution<int64_t>(low, high)(engine);
+}
+
+// small integers, exact in every dtype, non-negative for the unsigned ones
+std::vector<double> RandomValues(std::mt19937 &engine, DataType type, int64_t elements, int64_t range)
+{
+    int64_t low = (type == DT_UINT8) ? 0 : -range;
+    int64_t high = (type == DT_UINT8) ? 2 * range : range;
+    std::vector<double> values(static_cast<size_t>(elements));
+    for (double &value : values) {
+        value = static_cast<double>(Uniform(engine, low, high));
+    }
+    return values;
+}
+
+// relative tolerance, 0 asks for an exact match
+bool CheckValues(const char *what, const std::vector<double> &got, const std::vector<double> &want, double tolerance)
+{
+    if (got.size() != want.size()) {
+        printf("    %s: %zu values, expected %zu\n", what, got.size(), want.size());
+        return false;
+    }
+    for (size_t i = 0; i < got.size(); ++i) {
+        bool same = (got[i] == want[i]) || (isnan(got[i]) && isnan(want[i]));
+        if (!same && !(fabs(got[i] - want[i]) <= tolerance * (1.0 + fabs(want[i])))) {
+            printf("    %s: y[%zu] = %g, expected %g\n", what, i, got[i], want[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CheckCompute(const char *what, uint32_t ret, bool expect_success)
+{
+    if ((ret == 0) != expect_success) {
+        printf("    %s: Compute returned %u\n", what, ret);
+        return false;
+    }
+    return true;
+}
+
+// flat index into input dims, right aligned against out_dims, of the out_index-th output element
+int64_t BroadcastIndex(const std::vector<int64_t> &dims, const std::vector<int64_t> &out_dims, int64_t out_index)
+{
+    int64_t index = 0;
+    int64_t stride = 1;
+    size_t pad = out_dims.size() - dims.size();
+    for (size_t i = out_dims.size(); i-- > 0;) {
+        int64_t coord = out_index % out_dims[i];
+        out_index /= out_dims[i];
+        if (i >= pad) {
+            int64_t dim = dims[i - pad];
+            index += (dim == 1 ? 0 : coord) * stride;
+            stride *= dim;
+        }
+    }
+    return index;
+}
+
+// out_dims with leading dims dropped and some dims set to 1
+std::vector<int64_t> RandomBroadcastDims(std::mt19937 &engine, const std::vector<int64_t> &out_dims)
+{
+    std::vector<int64_t> dims(out_dims.begin() + Uniform(engine, 0, static_cast<int64_t>(out_dims.size())),
+                              out_dims.end());
+    for (int64_t &dim : dims) {
+        if (Uniform(engine, 0, 2) == 0) {
+            dim = 1;
+        }
+    }
+    return dims;
+}
+
+// shape of two compatible broadcast inputs
+std::vector<int64_t> BroadcastShape(const std::vector<int64_t> &dims_a, const std::vector<int64_t> &dims_b)
+{
+    std::vector<int64_t> dims(std::max(dims_a.size(), dims_b.size()), 1);
+    for (size_t i = 0; i < dims.size(); ++i) {
+        size_t pad_a = dims.size() - dims_a.size();
+        size_t pad_b = dims.size() - dims_b.size();
+        int64_t dim_a = (i >= pad_a) ? dims_a[i - pad_a] : 1;
+        int64_t dim_b = (i >= pad_b) ? dims_b[i - pad_b] : 1;
+        dims[i] = (dim_a == 1) ? dim_b : dim_a;
+    }
+    return dims;
+}
+
+Tensor *TestNode::NewTensor(DataType type, const std::vector<int64_t> &dims, void *data, uint64_t size)
+{
+    std::shared_ptr<Tensor> tensor = std::make_shared<Tensor>();
+    TensorShape shape(dims);
+    tensor->SetTensorShape(&shape);
+    tensor->SetDataType(type);
+    tensor->SetData(data);
+    tensor->SetDataSize(size);
+    tensors_.push_back(tensor);
+    return tensor.get();
+}
+
+Tensor *TestNode::AddInput(DataType type, const std::vector<int64_t> &dims, const std::vector<double> &values)
+{
+    int64_t elements = NumElements(dims);
+    uint64_t size = static_cast<uint64_t>(elements * TypeSize(type));
+    buffers_.push_back(std::make_shared<std::vector<uint8_t>>(std::max<uint64_t>(size, 1)));
+    void *data = buffers_.back()->data();
+    for (int64_t i = 0; i < elements && i < static_cast<int64_t>(values.size()); ++i) {
+        StoreValue(type, data, i, values[i]);
+    }
+    Tensor *tensor = NewTensor(type, dims, data, size);
+    ctx_.AddInput(tensor);
+    return tensor;
+}
+
+Tensor *TestNode::AddOutput(DataType type, const std::vector<int64_t> &dims)
+{
+    uint64_t size = static_cast<uint64_t>(NumElements(dims) * TypeSize(type));
+    // a pattern no reference produces, so unwritten elements show up
+    buffers_.push_back(std::make_shared<std::vector<uint8_t>>(std::max<uint64_t>(size, 1), 0x7b));
+    Tensor *tensor = NewTensor(type, dims, buffers_.back()->data(), size);
+    ctx_.AddOutput(tensor);
+    return tensor;
+}
+
+Tensor *TestNode::AddRefOutput(uint32_t input_index, const std::vector<int64_t> &dims)
+{
+    Tensor *input = ctx_.Input(input_index);
+    if (input == nullptr) {
+        return nullptr;
+    }
+    Tensor *tensor = NewTensor(input->GetDataType(), dims, input->GetData(), input->GetDataSize());
+    ctx_.AddOutput(tensor);
+    return tensor;
+}
+
+uint32_t TestNode::Run(const std::string &op_type)
+{
+    ctx_.SetOpType(op_type);
+    std::shared_ptr<CpuKernel> kernel = CreateCpuKernel(op_type);
+    if (kernel == nullptr) {
+        printf("    no kernel registered for %s\n", op_type.c_str());
+        return static_cast<uint32_t>(-1);
+    }
+    return kernel->Compute(ctx_);
+}
+
+/*
+ * MatmulTik and the Gemm under it: batched, transposed and broadcast
+ * products over every dtype pair of the ai core ini, now and then big
+ * enough for several Gemm blocks.
+ */
+bool TestMatmulTik(std::mt19937 &engine, uint32_t threads)
+{
+    struct MatmulTypes {
+        DataType a;
+        DataType b;
+        DataType y;
+    };
+    const MatmulTypes kTypes[] = {
+        {DT_FLOAT16, DT_FLOAT16, DT_FLOAT}, {DT_FLOAT16, DT_FLOAT16, DT_FLOAT16}, {DT_FLOAT, DT_FLOAT, DT_FLOAT},
+        {DT_INT8, DT_INT8, DT_INT32}, {DT_UINT8, DT_INT8, DT_INT32}, {DT_INT32, DT_INT32, DT_INT32}
+    };
+    const MatmulTypes &types = kTypes[Uniform(engine, 0, 5)];
+    bool big = Uniform(engine, 0, 5) == 0;
+    int64_t m = Uniform(engine, 1, big ? 150 : 24);
+    int64_t n = Uniform(engine, 1, big ? 150 : 24);
+    int64_t k = Uniform(engine, big ? 64 : 1, big ? 300 : 40);
+    bool trans_a = Uniform(engine, 0, 1) != 0;
+    bool trans_b = Uniform(engine, 0, 1) != 0;
+    std::vector<int64_t> batch(static_cast<size_t>(big ? 0 : Uniform(engine, 0, 2)));
+    for (int64_t &dim : batch) {
+        dim = Uniform(engine, 1, 3);
+    }
+    std::vector<int64_t> batch_a = RandomBroadcastDims(engine, batch);
+    std::vector<int64_t> batch_b = RandomBroadcastDims(engine, batch);
+    std::vector<int64_t> batch_y = BroadcastShape(batch_a, batch_b);
+
+    std::vector<int64_t> dims_a = batch_a;
+    std::vector<int64_t> dims_b = batch_b;
+    std::vector<int64_t> dims_y = batch_y;
+    dims_a.push_back(trans_a ? k : m);
+    dims_a.push_back(trans_a ? m : k);
+    dims_b.push_back(trans_b ? n : k);
+    dims_b.push_back(trans_b ? k : n);
+    dims_y.push_back(m);
+    dims_y.push_back(n);
+    std::vector<double> a = RandomValues(engine, types.a, NumElements(dims_a), 4);
+    std::vector<double> b = RandomValues(engine, types.b, NumElements(dims_b), 4);
+
+    TestNode node(threads);
+    node.AddInput(types.a, dims_a, a);
+    node.AddInput(types.b, dims_b, b);
+    Tensor *y = node.AddOutput(types.y, dims_y);
+    node.AddAttr("transpose_x1")->SetBool(trans_a);
+    node.AddAttr("transpose_x2")->SetBool(trans_b);
+    if (!CheckCompute("MatmulTik", node.Run("MatmulTik"), true)) {
+        return false;
+    }
+
+    int64_t batch_num = NumElements(batch_y);
+    std::vector<double> want(static_cast<size_t>(batch_num * m * n));
+    for (int64_t bi = 0; bi < batch_num; ++bi) {
+        const double *mat_a = a.data() + BroadcastIndex(batch_a, batch_y, bi) * m * k;
+        const double *mat_b = b.data() + BroadcastIndex(batch_b, batch_y, bi) * k * n;
+        for (int64_t i = 0; i < m; ++i) {
+            for (int64_t j = 0; j < n; ++j) {
+                double sum = 0.0;
+                for (int64_t p = 0; p < k; ++p) {
+                    sum += (trans_a ? mat_a[p * m + i] : mat_a[i * k + p]) *
+                        (trans_b ? mat_b[j * k + p] : mat_b[p * n + j]);
+                }
+                want[(bi * m + i) * n + j] = RoundTo(types.y, sum);
+            }
+        }
+    }
+    return CheckValues("MatmulTik", Values(y), want, types.y == DT_FLOAT16 ? 1e-3 : 0.0);
+}
+
+/*
+ * Conv2DTik over NCHW: unit-stride 3x3 for the Winograd path, random
+ * kernels, strides and dilations for the direct path, and grouped and
+ * depthwise filters. int8 pads with offset_x.
+ */
+bool TestConv2DTik(std::mt19937 &engine, uint32_t threads)
+{
+    struct ConvTypes {
+        DataType x;
+        DataType y;
+        DataType bias;
+    };
+    const ConvTypes kTypes[] = {
+        {DT_FLOAT, DT_FLOAT, DT_FLOAT}, {DT_FLOAT16, DT_FLOAT16, DT_FLOAT}, {DT_FLOAT16, DT_FLOAT, DT_FLOAT},
+        {DT_INT8, DT_INT32, DT_INT32}
+    };
+    const ConvTypes &types = kTypes[Uniform(engine, 0, 3)];
+    int64_t mode = Uniform(engine, 0, 2);
+    int64_t batch = Uniform(engine, 1, 2);
+    int64_t groups = 1;
+    int64_t in_per_group = Uniform(engine, 1, 5);
+    int64_t out_per_group = Uniform(engine, 1, 8);
+    int64_t h = Uniform(engine, 1, 14);
+    int64_t w = Uniform(engine, 1, (Uniform(engine, 0, 3) == 0) ? 64 : 14);
+    std::vector<int64_t> kernel = {3, 3};
+    std::vector<int64_t> stride = {1, 1};
+    std::vector<int64_t> dilation = {1, 1};
+    if (mode == 1) {
+        for (size_t i = 0; i < 2; ++i) {
+            kernel[i] = Uniform(engine, 1, 4);
+            stride[i] = Uniform(engine, 1, 3);
+            dilation[i] = Uniform(engine, 1, 2);
+        }
+    } else if (mode == 2) {
+        groups = Uniform(engine, 2, 4);
+        // depthwise half of the time
+        if (Uniform(engine, 0, 1) == 0) {
+            in_per_group = 1;
+            out_per_group = Uniform(engine, 1, 2);
+        }
+        kernel[0] = Uniform(engine, 1, 3);
+        kernel[1] = kernel[0];
+        stride[0] = stride[1] = Uniform(engine, 1, 2);
+    }
+    std::vector<int64_t> pads = {Uniform(engine, 0, 2), Uniform(engine, 0, 2), Uniform(engine, 0, 2),
+                                 Uniform(engine, 0, 2)};
+    int64_t in_c = in_per_group * groups;
+    int64_t out_c = out_per_group * groups;
+    int64_t span_h = dilation[0] * (kernel[0] - 1) + 1;
+    int64_t span_w = dilation[1] * (kernel[1] - 1) + 1;
+    if (h + pads[0] + pads[1] < span_h || w + pads[2] + pads[3] < span_w) {
+        return true;
+    }
+    int64_t out_h = (h + pads[0] + pads[1] - span_h) / stride[0] + 1;
+    int64_t out_w = (w + pads[2] + pads[3] - span_w) / stride[1] + 1;
+    int64_t offset_x = (types.x == DT_INT8 && Uniform(engine, 0, 1) == 0) ? 3 : 0;
+    bool has_bias = Uniform(engine, 0, 2) != 0;
+
+    std::vector<double> x = RandomValues(engine, types.x, batch * in_c * h * w, 4);
+    std::vector<double> filter = RandomValues(engine, types.x, out_c * in_per_group * kernel[0] * kernel[1], 4);
+    std::vector<double> bias = RandomValues(engine, types.bias, out_c, 5);
+    TestNode node(threads);
+    node.AddInput(types.x, {batch, in_c, h, w}, x);
+    node.AddInput(types.x, {out_c, in_per_group, kernel[0], kernel[1]}, filter);
+    if (has_bias) {
+        node.AddInput(types.bias, {out_c}, bias);
+    }
+    Tensor *y = node.AddOutput(types.y, {batch, out_c, out_h, out_w});
+    node.AddAttr("strides")->SetListInt({1, 1, stride[0], stride[1]});
+    node.AddAttr("pads")->SetListInt(pads);
+    node.AddAttr("dilations")->SetListInt({1, 1, dilation[0], dilation[1]});
+    node.AddAttr("groups")->SetInt(groups);
+    if (offset_x != 0) {
+        node.AddAttr("offset_x")->SetInt(offset_x);
+    }
+    if (!CheckCompute("Conv2DTik", node.Run("Conv2DTik"), true)) {
+        return false;
+    }
+
+    std::vector<double> want;
+    for (int64_t b = 0; b < batch; ++b) {
+        for (int64_t o = 0; o < out_c; ++o) {
+            int64_t first_in = (o / out_per_group) * in_per_group;
+            for (int64_t i = 0; i < out_h; ++i) {
+                for (int64_t j = 0; j < out_w; ++j) {
+                    double sum = has_bias ? bias[o] : 0.0;
+                    for (int64_t c = 0; c < in_per_group; ++c) {
+                        for (int64_t kh = 0; kh < kernel[0]; ++kh) {
+                            for (int64_t kw = 0; kw < kernel[1]; ++kw) {
+                                int64_t row = i * stride[0] + kh * dilation[0] - pads[0];
+                                int64_t col = j * stride[1] + kw * dilation[1] - pads[2];
+                                bool inside = row >= 0 && row < h && col >= 0 && col < w;
+                                double value = inside ? x[((b * in_c + first_in + c) * h + row) * w + col] :
+                                                        static_cast<double>(offset_x);
+                                sum += value * filter[((o * in_per_group + c) * kernel[0] + kh) * kernel[1] + kw];
+                            }
+                        }
+                    }
+                    want.push_back(RoundTo(types.y, sum));
+                }
+            }
+        }
+    }
+    // the Winograd transforms round in float
+    double tolerance = (types.y == DT_FLOAT16) ? 2e-3 : (types.y == DT_FLOAT ? 1e-5 : 0.0);
+    return CheckValues("Conv2DTik", Values(y), want, tolerance);
+}
+
+// Add with general broadcasting, y sharing the buffer of a full-shape input at times
+bool RunAdd(std::mt19937 &engine, uint32_t threads, DataType type, const std::vector<int64_t> &dims_a,
+            const std::vector<int64_t> &dims_b, bool in_place)
+{
+    std::vector<int64_t> out_dims = BroadcastShape(dims_a, dims_b);
+    std::vector<double> a = RandomValues(engine, type, NumElements(dims_a), 8);
+    std::vector<double> b = RandomValues(engine, type, NumElements(dims_b), 8);
+
+    TestNode node(threads);
+    node.AddInput(type, dims_a, a);
+    node.AddInput(type, dims_b, b);
+    Tensor *y = nullptr;
+    if (in_place && dims_a == out_dims) {
+        y = node.AddRefOutput(0, out_dims);
+    } else if (in_place && dims_b == out_dims) {
+        y = node.AddRefOutput(1, out_dims);
+    } else {
+        y = node.AddOutput(type, out_dims);
+    }
+    if (!CheckCompute("Add", node.Run("Add"), true)) {
+        return false;
+    }
+
+    int64_t elements = NumElements(out_dims);
+    std::vector<double> want(static_cast<size_t>(elements));
+    for (int64_t i = 0; i < elements; ++i) {
+        want[i] = RoundTo(type, a[BroadcastIndex(dims_a, out_dims, i)] + b[BroadcastIndex(dims_b, out_dims, i)]);
+    }
+    return CheckValues("Add", Values(y), want, 0.0);
+}
+
+bool TestAdd(std::mt19937 &engine, uint32_t threads)
+{
+    const DataType kTypes[] = {DT_FLOAT, DT_INT32, DT_INT64, DT_FLOAT16, DT_INT16, DT_INT8, DT_UINT8, DT_DOUBLE};
+    DataType type = kTypes[Uniform(engine, 0, 7)];
+    std::vector<int64_t> full_dims(static_cast<size_t>(Uniform(engine, 1, 4)));
+    for (int64_t &dim : full_dims) {
+        dim = Uniform(engine, 1, 7);
+    }
+    // sometimes enough elements for several shards
+    if (Uniform(engine, 0, 4) == 0) {
+        full_dims[Uniform(engine, 0, static_cast<int64_t>(full_dims.size()) - 1)] = 20000;
+    }
+    std::vector<int64_t> dims_a = RandomBroadcastDims(engine, full_dims);
+    std::vector<int64_t> dims_b = RandomBroadcastDims(engine, full_dims);
+    if (Uniform(engine, 0, 1) == 0) {
+        (Uniform(engine, 0, 1) == 0 ? dims_a : dims_b) = full_dims;
+    }
+    bool in_place = Uniform(engine, 0, 2) == 0;
+    // collapsed to fewer rows than threads, so with more than one thread the rows are cut into
+    // chunks: a same shape Add, a tensor + [1] Add and two rows of a row broadcast
+    return RunAdd(engine, threads, type, dims_a, dims_b, in_place) &&
+        RunAdd(engine, threads, type, {3, 40000}, {3, 40000}, in_place) &&
+        RunAdd(engine, threads, type, {1}, {100001}, in_place) &&
+        RunAdd(engine, threads, type, {2, 70000}, {70000}, in_place);
+}
+
+// PermuteTik with a full or partial order, the missing axes keep their place at the end
+bool TestPermuteTik(std::mt19937 &engine, uint32_t threads)
+{
+    const DataType kTypes[] = {DT_INT8, DT_FLOAT16, DT_FLOAT, DT_INT32, DT_INT64, DT_DOUBLE};
+    DataType type = kTypes[Uniform(engine, 0, 5)];
+    int64_t rank = Uniform(engine, 1, 5);
+    std::vector<int64_t> dims(static_cast<size_t>(rank));
+    for (int64_t &dim : dims) {
+        dim = (Uniform(engine, 0, 3) == 0) ? 1 : Uniform(engine, 1, 9);
+    }
+    if (Uniform(engine, 0, 4) == 0) {
+        dims[Uniform(engine, 0, rank - 1)] = 300;
+    }
+    std::vector<int64_t> full(static_cast<size_t>(rank));
+    std::iota(full.begin(), full.end(), 0);
+    std::shuffle(full.begin(), full.end(), engine);
+    std::vector<int64_t> order(full.begin(), full.begin() + (Uniform(engine, 0, 3) == 0 ? Uniform(engine, 0, rank) : rank));
+    full = order;
+    for (int64_t axis = 0; axis < rank; ++axis) {
+        if (std::find(full.begin(), full.end(), axis) == full.end()) {
+            full.push_back(axis);
+        }
+    }
+    std::vector<int64_t> out_dims(static_cast<size_t>(rank));
+    for (int64_t i = 0; i < rank; ++i) {
+        out_dims[i] = dims[full[i]];
+    }
+    int64_t elements = NumElements(dims);
+    std::vector<double> x(static_cast<size_t>(elements));
+    for (int64_t i = 0; i < elements; ++i) {
+        x[i] = RoundTo(type, static_cast<double>(i % 201 - 100));
+    }
+
+    TestNode node(threads);
+    node.AddInput(type, dims, x);
+    Tensor *y = node.AddOutput(type, out_dims);
+    node.AddAttr("order")->SetListInt(order);
+    if (!CheckCompute("PermuteTik", node.Run("PermuteTik"), true)) {
+        return false;
+    }
+
+    std::vector<int64_t> strides(static_cast<size_t>(rank), 1);
+    for (int64_t i = rank - 1; i > 0; --i) {
+        strides[i - 1] = strides[i] * dims[i];
+    }
+    std::vector<double> want(static_cast<size_t>(elements));
+    for (int64_t o = 0; o < elements; ++o) {
+        int64_t rest = o;
+        int64_t offset = 0;
+        for (int64_t i = rank - 1; i >= 0; --i) {
+            offset += (rest % out_dims[i]) * strides[full[i]];
+            rest /= out_dims[i];
+        }
+        want[o] = x[offset];
+    }
+    return CheckValues("PermuteTik", Values(y), want, 0.0);
+}
+
+// ScatterNdAdd with repeated indices, in place on var or into a separate y
+bool TestScatterNdAdd(std::mt19937 &engine, uint32_t threads)
+{
+    const DataType kTypes[] = {DT_FLOAT16, DT_FLOAT, DT_INT32, DT_INT8, DT_UINT8};
+    DataType type = kTypes[Uniform(engine, 0, 4)];
+    DataType index_type = (Uniform(engine, 0, 1) == 0) ? DT_INT32 : DT_INT64;
+    std::vector<int64_t> var_dims(static_cast<size_t>(Uniform(engine, 1, 3)));
+    for (int64_t &dim : var_dims) {
+        dim = Uniform(engine, 1, 40);
+    }
+    int64_t depth = Uniform(engine, 1, static_cast<int64_t>(var_dims.size()));
+    int64_t updates_num = Uniform(engine, 0, 200);
+    std::vector<int64_t> slice_dims(var_dims.begin() + depth, var_dims.end());
+    int64_t slice = NumElements(slice_dims);
+    std::vector<int64_t> update_dims = slice_dims;
+    update_dims.insert(update_dims.begin(), updates_num);
+
+    std::vector<double> var = RandomValues(engine, type, NumElements(var_dims), 9);
+    std::vector<double> updates = RandomValues(engine, type, updates_num * slice, 3);
+    std::vector<double> indices(static_cast<size_t>(updates_num * depth));
+    std::vector<double> want = var;
+    for (int64_t i = 0; i < updates_num; ++i) {
+        int64_t row = 0;
+        for (int64_t d = 0; d < depth; ++d) {
+            // a third of the updates hit the first row
+            int64_t coord = (Uniform(engine, 0, 2) == 0) ? 0 : Uniform(engine, 0, var_dims[d] - 1);
+            indices[i * depth + d] = static_cast<double>(coord);
+            row = row * var_dims[d] + coord;
+        }
+        for (int64_t j = 0; j < slice; ++j) {
+            want[row * slice + j] += updates[i * slice + j];
+        }
+    }
+    for (double &value : want) {
+        value = RoundTo(type, value);
+    }
+
+    TestNode node(threads);
+    node.AddInput(type, var_dims, var);
+    node.AddInput(index_type, {updates_num, depth}, indices);
+    node.AddInput(type, update_dims, updates);
+    Tensor *y = (Uniform(engine, 0, 1) == 0) ? node.AddRefOutput(0, var_dims) : node.AddOutput(type, var_dims);
+    if (!CheckCompute("ScatterNdAdd", node.Run("ScatterNdAdd"), true)) {
+        return false;
+    }
+    return CheckValues("ScatterNdAdd", Values(y), want, 0.0);
+}
+
+/*
+ * Runs UpsampleTik 2x on a float [1, 2, 3, 4] x into y of y_dims and
+ * y_type, with y_size bytes of buffer, where nothing but the exact output
+ * may be written.
+ */
+bool RunUpsampleRejected(uint32_t threads, const std::vector<int64_t> &y_dims, DataType y_type, uint64_t y_size)
+{
+    TestNode node(threads);
+    node.AddInput(DT_FLOAT, {1, 2, 3, 4}, std::vector<double>(24, 1.0));
+    Tensor *y = node.AddOutput(y_type, y_dims);
+    if (y_size < y->GetDataSize()) {
+        y->SetDataSize(y_size);
+    }
+    return CheckCompute("UpsampleTik", node.Run("UpsampleTik"), false);
+}
+
+// nearest neighbour UpsampleTik of NCHW and NC1HWC0, scaled or not
+bool TestUpsampleTik(std::mt19937 &engine, uint32_t threads)
+{
+    DataType type = (Uniform(engine, 0, 1) == 0) ? DT_FLOAT : DT_FLOAT16;
+    std::vector<int64_t> dims(static_cast<size_t>(Uniform(engine, 4, 5)));
+    for (int64_t &dim : dims) {
+        dim = Uniform(engine, 1, 6);
+    }
+    if (Uniform(engine, 0, 4) == 0) {
+        dims[1] = 200;
+    }
+    int64_t stride_h = Uniform(engine, 1, 3);
+    int64_t stride_w = Uniform(engine, 1, 3);
+    float scale = (Uniform(engine, 0, 1) == 0) ? 1.0f : 0.5f * static_cast<float>(Uniform(engine, 1, 4));
+    std::vector<int64_t> out_dims = dims;
+    out_dims[2] *= stride_h;
+    out_dims[3] *= stride_w;
+    std::vector<double> x = RandomValues(engine, type, NumElements(dims), 20);
+
+    TestNode node(threads);
+    node.AddInput(type, dims, x);
+    Tensor *y = node.AddOutput(type, out_dims);
+    node.AddAttr("scale")->SetFloat(scale);
+    node.AddAttr("stride_h")->SetInt(stride_h);
+    node.AddAttr("stride_w")->SetInt(stride_w);
+    if (!CheckCompute("UpsampleTik", node.Run("UpsampleTik"), true)) {
+        return false;
+    }
+
+    int64_t inner = (dims.size() == 5) ? dims[4] : 1;
+    int64_t elements = NumElements(out_dims);
+    std::vector<double> want(static_cast<size_t>(elements));
+    for (int64_t o = 0; o < elements; ++o) {
+        int64_t rest = o / inner;
+        int64_t col = rest % out_dims[3];
+        rest /= out_dims[3];
+        int64_t row = rest % out_dims[2];
+        rest /= out_dims[2];
+        int64_t src = ((rest * dims[2] + row / stride_h) * dims[3] + col / stride_w) * inner + o % inner;
+        want[o] = RoundTo(type, x[src] * scale);
+    }
+    if (!CheckValues("UpsampleTik", Values(y), want, 0.0)) {
+        return false;
+    }
+
+    // y of another channel count, rank or dtype, or a buffer one byte short
+    const uint64_t kFullSize = 2 * 6 * 8 * sizeof(float);
+    return RunUpsampleRejected(threads, {1, 3, 6, 8}, DT_FLOAT, kFullSize * 2) &&
+        RunUpsampleRejected(threads, {1, 2, 6, 8, 1}, DT_FLOAT, kFullSize) &&
+        RunUpsampleRejected(threads, {1, 2, 6, 8}, DT_FLOAT16, kFullSize) &&
+        RunUpsampleRejected(threads, {1, 2, 6, 8}, DT_FLOAT, kFullSize - 1);
+}
+
+// y = (x - gamma) / beta per channel, NCHW and NHWC
+bool TestBatchNormCust(std::mt19937 &engine, uint32_t threads)
+{
+    DataType type = (Uniform(engine, 0, 1) == 0) ? DT_FLOAT : DT_FLOAT16;
+    bool nhwc = Uniform(engine, 0, 1) != 0;
+    std::vector<int64_t> dims(static_cast<size_t>(Uniform(engine, 2, 4)));
+    for (int64_t &dim : dims) {
+        dim = Uniform(engine, 1, 12);
+    }
+    size_t channel_axis = nhwc ? dims.size() - 1 : 1;
+    if (Uniform(engine, 0, 3) == 0) {
+        dims[channel_axis] = Uniform(engine, 500, 2000);
+    }
+    int64_t channels = dims[channel_axis];
+    std::vector<double> x = RandomValues(engine, type, NumElements(dims), 8);
+    std::vector<double> gamma = RandomValues(engine, type, channels, 4);
+    std::vector<double> beta(static_cast<size_t>(channels));
+    for (double &value : beta) {
+        value = static_cast<double>(Uniform(engine, 1, 8));
+    }
+
+    TestNode node(threads);
+    node.AddInput(type, dims, x);
+    node.AddInput(type, {channels}, gamma);
+    node.AddInput(type, {channels}, beta);
+    Tensor *y = node.AddOutput(type, dims);
+    node.AddAttr("data_format")->SetString(nhwc ? "NHWC" : "NCHW");
+    if (!CheckCompute("BatchNormCust", node.Run("BatchNormCust"), true)) {
+        return false;
+    }
+
+    int64_t inner = 1;
+    for (size_t i = channel_axis + 1; i < dims.size(); ++i) {
+        inner *= dims[i];
+    }
+    std::vector<double> want(x.size());
+    for (size_t i = 0; i < x.size(); ++i) {
+        int64_t c = (static_cast<int64_t>(i) / inner) % channels;
+        want[i] = RoundTo(type, (x[i] - gamma[c]) / beta[c]);
+    }
+    // the kernel multiplies by a float reciprocal
+    if (!CheckValues("BatchNormCust", Values(y), want, type == DT_FLOAT16 ? 2e-3 : 1e-6)) {
+        return false;
+    }
+
+    // y of the other dtype is rejected
+    TestNode mismatch(threads);
+    mismatch.AddInput(type, dims, x);
+    mismatch.AddInput(type, {channels}, gamma);
+    mismatch.AddInput(type, {channels}, beta);
+    mismatch.AddOutput(type == DT_FLOAT ? DT_FLOAT16 : DT_FLOAT, dims);
+    return CheckCompute("BatchNormCust", mismatch.Run("BatchNormCust"), false);
+}
+
+double FusedReference(int64_t opcode, double a, double b)
+{
+    switch (opcode) {
+        case 0: return fabs(a);
+        case 1: return -a;
+        case 2: return a > 0.0 ? a : 0.0;
+        case 3: return exp(a);
+        case 4: return a + b;
+        case 5: return a - b;
+        case 6: return a * b;
+        case 7: return a / b;
+        case 8: return a > b ? a : b;
+        default: return a < b ? a : b;
+    }
+}
+
+/*
+ * FusedElementwise over random programs of the ten opcodes, with single
+ * element inputs broadcast and y written over input 0 at times.
+ */
+bool TestFusedElementwise(std::mt19937 &engine, uint32_t threads)
+{
+    const DataType kTypes[] = {DT_FLOAT, DT_FLOAT16, DT_DOUBLE};
+    const int64_t kOpcodes = 10;
+    DataType type = kTypes[Uniform(engine, 0, 2)];
+    int64_t num_inputs = Uniform(engine, 1, 3);
+    int64_t num_instrs = Uniform(engine, 1, 6);
+    int64_t elements = (Uniform(engine, 0, 4) == 0) ? Uniform(engine, 60000, 100000) : Uniform(engine, 1, 3000);
+    std::vector<float> constants(static_cast<size_t>(Uniform(engine, 0, 2)));
+    for (float &value : constants) {
+        value = static_cast<float>(Uniform(engine, -3, 3)) + 0.5f;
+    }
+    int64_t first_instr = num_inputs + static_cast<int64_t>(constants.size());
+    std::vector<int64_t> program;
+    for (int64_t k = 0; k < num_instrs; ++k) {
+        int64_t opcode = Uniform(engine, 0, kOpcodes - 1);
+        program.push_back(opcode);
+        program.push_back(Uniform(engine, 0, first_instr + k - 1));
+        program.push_back(opcode < 4 ? -1 : Uniform(engine, 0, first_instr + k - 1));
+    }
+
+    TestNode node(threads);
+    std::vector<std::vector<double>> inputs(static_cast<size_t>(num_inputs));
+    for (int64_t i = 0; i < num_inputs; ++i) {
+        int64_t size = (i > 0 && Uniform(engine, 0, 3) == 0) ? 1 : elements;
+        // quarters keep exp and division away from the float16 limits
+        inputs[i] = RandomValues(engine, DT_INT32, size, 100);
+        for (double &value : inputs[i]) {
+            value = RoundTo(type, value / 32.0);
+        }
+        node.AddInput(type, {size}, inputs[i]);
+    }
+    Tensor *y = (Uniform(engine, 0, 3) == 0) ? node.AddRefOutput(0, {elements}) : node.AddOutput(type, {elements});
+    node.AddAttr("program")->SetListInt(program);
+    if (!constants.empty()) {
+        node.AddAttr("constants")->SetListFloat(constants);
+    }
+    if (!CheckCompute("FusedElementwise", node.Run("FusedElementwise"), true)) {
+        return false;
+    }
+
+    std::vector<double> got = Values(y);
+    std::vector<double> want(static_cast<size_t>(elements));
+    std::vector<double> values;
+    for (int64_t j = 0; j < elements; ++j) {
+        values.clear();
+        for (const std::vector<double> &input : inputs) {
+            values.push_back(input[input.size() == 1 ? 0 : j]);
+        }
+        values.insert(values.end(), constants.begin(), constants.end());
+        for (int64_t k = 0; k < num_instrs; ++k) {
+            double b = program[3 * k + 2] < 0 ? 0.0 : values[program[3 * k + 2]];
+            double result = FusedReference(program[3 * k], values[program[3 * k + 1]], b);
+            // float16 chains keep their intermediates in float
+            values.push_back(type == DT_DOUBLE ? result : static_cast<double>(static_cast<float>(result)));
+        }
+        want[j] = RoundTo(type, values.back());
+        // past float range the kernel and the reference may overflow at different steps
+        if (fabs(want[j]) > 1e30 || (isinf(want[j]) && isinf(got[j]))) {
+            want[j] = got[j];
+        }
+    }
+    return CheckValues("FusedElementwise", got, want, 1e-3);
+}
+
+// DecodeBboxV2 of [n, 4] or reversed [4, n] boxes, scaled and clipped
+bool TestDecodeBboxV2(std::mt19937 &engine, uint32_t threads)
+{
+    DataType type = (Uniform(engine, 0, 1) == 0) ? DT_FLOAT : DT_FLOAT16;
+    int64_t num = (Uniform(engine, 0, 4) == 0) ? Uniform(engine, 1, 5000) : Uniform(engine, 1, 600);
+    bool reversed = Uniform(engine, 0, 1) != 0;
+    float clip = (Uniform(engine, 0, 2) == 0) ? 0.5f : 0.0f;
+    std::vector<float> scales = (Uniform(engine, 0, 3) == 0) ? std::vector<float>{10.0f, 10.0f, 5.0f, 5.0f} :
+                                                               std::vector<float>{1.0f, 1.0f, 1.0f, 1.0f};
+    std::uniform_real_distribution<float> delta(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> position(0.0f, 100.0f);
+    std::uniform_real_distribution<float> size(1.0f, 50.0f);
+    std::vector<double> boxes(static_cast<size_t>(num * 4));
+    std::vector<double> anchors(static_cast<size_t>(num * 4));
+    auto at = [num, reversed](int64_t i, int64_t k) { return reversed ? k * num + i : i * 4 + k; };
+    for (int64_t i = 0; i < num; ++i) {
+        for (int64_t k = 0; k < 4; ++k) {
+            boxes[at(i, k)] = RoundTo(type, delta(engine) * (k >= 2 ? 3.0f : 1.0f));
+        }
+        float top = position(engine);
+        float left = position(engine);
+        anchors[at(i, 0)] = RoundTo(type, top);
+        anchors[at(i, 1)] = RoundTo(type, left);
+        anchors[at(i, 2)] = RoundTo(type, top + size(engine));
+        anchors[at(i, 3)] = RoundTo(type, left + size(engine));
+    }
+
+    std::vector<int64_t> dims = reversed ? std::vector<int64_t>{4, num} : std::vector<int64_t>{num, 4};
+    TestNode node(threads);
+    node.AddInput(type, dims, boxes);
+    node.AddInput(type, dims, anchors);
+    Tensor *y = node.AddOutput(type, dims);
+    node.AddAttr("scales")->SetListFloat(scales);
+    if (clip > 0.0f) {
+        node.AddAttr("decode_clip")->SetFloat(clip);
+    }
+    node.AddAttr("reversed_box")->SetBool(reversed);
+    if (!CheckCompute("DecodeBboxV2", node.Run("DecodeBboxV2"), true)) {
+        return false;
+    }
+
+    std::vector<double> want(boxes.size());
+    for (int64_t i = 0; i < num; ++i) {
+        double anchor_h = anchors[at(i, 2)] - anchors[at(i, 0)];
+        double anchor_w = anchors[at(i, 3)] - anchors[at(i, 1)];
+        double dy = boxes[at(i, 0)] / scales[0];
+        double dx = boxes[at(i, 1)] / scales[1];
+        double dh = boxes[at(i, 2)] / scales[2];
+        double dw = boxes[at(i, 3)] / scales[3];
+        if (clip > 0.0f) {
+            dh = std::min<double>(dh, clip);
+            dw = std::min<double>(dw, clip);
+        }
+        double h = exp(dh) * anchor_h;
+        double w = exp(dw) * anchor_w;
+        double center_y = dy * anchor_h + anchors[at(i, 0)] + anchor_h / 2;
+        double center_x = dx * anchor_w + anchors[at(i, 1)] + anchor_w / 2;
+        want[at(i, 0)] = center_y - h / 2;
+        want[at(i, 1)] = center_x - w / 2;
+        want[at(i, 2)] = center_y + h / 2;
+        want[at(i, 3)] = center_x + w / 2;
+    }
+    // corners near 0 are the difference of coordinates of a hundred or more
+    return CheckValues("DecodeBboxV2", Values(y), want, type == DT_FLOAT16 ? 2e-3 : 1e-4);
+}
+
+/*
+ * Runs ReshapeCust on x as a view of dims and strides at offset into a
+ * buffer of storage elements. y is a separate [n] tensor, or the buffer
+ * of x itself when aliased. Checks y against the gather of the view when
+ * the kernel is expected to succeed.
+ */
+bool RunReshapeView(std::mt19937 &engine, uint32_t threads, DataType type, const std::vector<int64_t> &dims,
+                    const std::vector<int64_t> &strides, int64_t offset, int64_t storage, bool alias,
+                    bool expect_success)
+{
+    int64_t elements = NumElements(dims);
+    std::vector<double> buffer(static_cast<size_t>(storage));
+    for (double &value : buffer) {
+        value = RoundTo(type, static_cast<double>(Uniform(engine, -100, 100)));
+    }
+    TestNode node(threads);
+    Tensor *x = node.AddInput(type, {storage}, buffer);
+    TensorShape view_shape(dims);
+    x->SetTensorShape(&view_shape);
+    node.AddInput(DT_INT64, {1}, {static_cast<double>(elements)});
+    Tensor *y = alias ? node.AddRefOutput(0, {elements}) : node.AddOutput(type, {elements});
+    node.AddAttr("strides")->SetListInt(strides);
+    node.AddAttr("storage_offset")->SetInt(offset);
+    if (!CheckCompute("ReshapeCust", node.Run("ReshapeCust"), expect_success)) {
+        return false;
+    }
+    if (!expect_success) {
+        return true;
+    }
+
+    std::vector<double> want(static_cast<size_t>(elements));
+    std::vector<int64_t> index(dims.size(), 0);
+    for (int64_t e = 0; e < elements; ++e) {
+        int64_t position = offset;
+        for (size_t i = 0; i < dims.size(); ++i) {
+            position += index[i] * strides[i];
+        }
+        want[e] = buffer[position];
+        for (size_t i = dims.size(); i-- > 0;) {
+            if (++index[i] < dims[i]) {
+                break;
+            }
+            index[i] = 0;
+        }
+    }
+    return CheckValues("ReshapeCust", Values(y), want, 0.0);
+}
+
+// ReshapeCust of permuted slices of a dense tensor, plus the dense, aliased and invalid views
+bool TestReshapeCust(std::mt19937 &engine, uint32_t threads)
+{
+    const DataType kTypes[] = {DT_INT8, DT_FLOAT16, DT_FLOAT, DT_INT64, DT_DOUBLE};
+    DataType type = kTypes[Uniform(engine, 0, 4)];
+    int64_t rank = Uniform(engine, 1, 5);
+    std::vector<int64_t> base(static_cast<size_t>(rank));
+    std::vector<int64_t> dims(static_cast<size_t>(rank));
+    std::vector<int64_t> base_strides(static_cast<size_t>(rank));
+    int64_t storage = 1;
+    int64_t offset = 0;
+    for (int64_t i = rank - 1; i >= 0; --i) {
+        base[i] = Uniform(engine, 1, (rank <= 2 && Uniform(engine, 0, 9) == 0) ? 300 : 9);
+        dims[i] = Uniform(engine, 1, base[i]);
+        base_strides[i] = storage;
+        offset += Uniform(engine, 0, base[i] - dims[i]) * storage;
+        storage *= base[i];
+    }
+    std::vector<int64_t> perm(static_cast<size_t>(rank));
+    std::iota(perm.begin(), perm.end(), 0);
+    std::shuffle(perm.begin(), perm.end(), engine);
+    std::vector<int64_t> view_dims(static_cast<size_t>(rank));
+    std::vector<int64_t> view_strides(static_cast<size_t>(rank));
+    for (int64_t i = 0; i < rank; ++i) {
+        view_dims[i] = dims[perm[i]];
+        view_strides[i] = base_strides[perm[i]];
+    }
+    if (!RunReshapeView(engine, threads, type, view_dims, view_strides, offset, storage, false, true)) {
+        return false;
+    }
+
+    // large enough for several shards, each starting mid odometer
+    return RunReshapeView(engine, threads, DT_FLOAT, {60, 40, 50}, {1, 3000, 60}, 0, 120000, false, true) &&
+        RunReshapeView(engine, threads, DT_INT8, {7, 60, 40, 50}, {1, 1, 3000, 60}, 5, 120100, false, true) &&
+        // dense views, y written over x only where nothing moves
+        RunReshapeView(engine, threads, DT_FLOAT, {4, 5}, {5, 1}, 0, 20, true, true) &&
+        RunReshapeView(engine, threads, DT_FLOAT, {4, 5}, {5, 1}, 3, 23, false, true) &&
+        RunReshapeView(engine, threads, DT_FLOAT, {4, 1, 5}, {5, 77, 1}, 0, 20, false, true) &&
+        RunReshapeView(engine, threads, DT_FLOAT, {0, 5}, {5, 1}, 0, 1, false, true) &&
+        // a dense view past the start of its own buffer, the copy would overlap itself
+        RunReshapeView(engine, threads, DT_FLOAT, {4096}, {1}, 4, 4100, true, false) &&
+        // a strided view over its own buffer, an overrun, a rank mismatch and a negative stride
+        RunReshapeView(engine, threads, DT_FLOAT, {4, 5}, {1, 4}, 0, 20, true, false) &&
+        RunReshapeView(engine, threads, DT_FLOAT, {4, 5}, {6, 1}, 0, 20, false, false) &&
+        RunReshapeView(engine, threads, DT_FLOAT, {4, 5}, {5}, 0, 20, false, false) &&
+        RunReshapeView(engine, threads, DT_FLOAT, {4, 5}, {-5, 1}, 0, 20, false, false);
+}
+
+const KernelTest kKernelTests[] = {
+    {"MatmulTik", TestMatmulTik},
+    {"Conv2DTik", TestConv2DTik},
+    {"Add", TestAdd},
+    {"PermuteTik", TestPermuteTik},
+    {"ScatterNdAdd", TestScatterNdAdd},
+    {"UpsampleTik", TestUpsampleTik},
+    {"BatchNormCust", TestBatchNormCust},
+    {"FusedElementwise", TestFusedElementwise},
+    {"DecodeBboxV2", TestDecodeBboxV2},
+    {"ReshapeCust", TestReshapeCust},
+};
+
+bool ParseOptions(int argc, char *argv[], TestOptions &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (strncmp(arg, "--op=", 5) == 0) {
+            options.op_type = arg + 5;
+        } else if (strncmp(arg, "--iterations=", 13) == 0) {
+            options.iterations = std::max(1, atoi(arg + 13));
+        } else if (strncmp(arg, "--seed=", 7) == 0) {
+            options.seed = static_cast<uint32_t>(strtoul(arg + 7, nullptr, 10));
+        } else {
+            printf("Usage: %s [--op=<op type>] [--iterations=<n>] [--seed=<n>]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// every iteration runs with 1 to kMaxTestThreads threads from its own seed, so a failure replays alone
+bool RunTest(const KernelTest &test, const TestOptions &options)
+{
+    for (int iteration = 0; iteration < options.iterations; ++iteration) {
+        for (uint32_t threads = 1; threads <= kMaxTestThreads; ++threads) {
+            std::mt19937 engine(options.seed * 7919u + static_cast<uint32_t>(iteration));
+            if (!test.func(engine, threads)) {
+                printf("%-20s FAILED at iteration %d with %u threads, seed %u\n", test.op_type, iteration, threads,
+                    options.seed);
+                return false;
+            }
+        }
+    }
+    printf("%-20s ok\n", test.op_type);
+    return true;
+}
+}
+} // namespace aicpu
+
+int main(int argc, char *argv[])
+{
+    aicpu::TestOptions options;
+    if (!aicpu::ParseOptions(argc, argv, options)) {
+        return 1;
+    }
+
+    std::set<std::string> covered;
+    int failed = 0;
+    for (const aicpu::KernelTest &test : aicpu::kKernelTests) {
+        covered.insert(test.op_type);
+        if (!options.op_type.empty() && options.op_type != test.op_type) {
+            continue;
+        }
+        failed += aicpu::RunTest(test, options) ? 0 : 1;
+    }
+    for (const std::string &type : aicpu::GetAllCpuKernelTypes()) {
+        if (covered.count(type) == 0) {
+            printf("%-20s no test case\n", type.c_str());
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark of the per-launch cost of KERNEL_TRACE_SCOPE
+ *
+ * Opens and closes trace scopes around an empty launch of a few context
+ * shapes and reports the ns each one adds. Needs the host stand-ins of the
+ * kernel context, built by host/CMakeLists.txt as kernel_trace_bench.
+ * Usage: kernel_trace_bench [--off] [dump path]
+ *   --off leaves CUST_AICPU_KERNEL_TRACE unset, to time a disabled scope
+ *   the dump path, ending in .csv or not, receives the recorded launches
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <memory>
+#include <vector>
+#include "cpu_kernel.h"
+#include "kernel_trace.h"
+
+namespace {
+const int kRepeatTimes = 20;
+const int64_t kLaunches = 100000;
+
+struct BenchContext {
+    const char *name;
+    std::vector<std::vector<int64_t>> inputs;
+    std::vector<std::vector<int64_t>> outputs;
+};
+
+const BenchContext kBenchContexts[] = {
+    {"1 in 1 out, rank 1", {{1024}}, {{1024}}},
+    {"2 in 1 out, rank 4", {{8, 3, 224, 224}, {3, 1, 1}}, {{8, 3, 224, 224}}},
+    {"4 in 1 out, rank 4", {{1, 64, 56, 56}, {64, 64, 3, 3}, {64}, {1}}, {{1, 64, 56, 56}}},
+};
+
+// owns the tensors of one context, data pointers stay null as the scope never reads them
+class ContextHolder {
+public:
+    explicit ContextHolder(const BenchContext &bench)
+    {
+        for (const auto &dims : bench.inputs) {
+            ctx_.AddInput(NewTensor(dims));
+        }
+        for (const auto &dims : bench.outputs) {
+            ctx_.AddOutput(NewTensor(dims));
+        }
+    }
+
+    aicpu::CpuKernelContext &Context() { return ctx_; }
+
+private:
+    aicpu::Tensor *NewTensor(const std::vector<int64_t> &dims)
+    {
+        tensors_.push_back(std::make_shared<aicpu::Tensor>());
+        aicpu::Tensor *tensor = tensors_.back().get();
+        aicpu::TensorShape shape(dims);
+        tensor->SetTensorShape(&shape);
+        tensor->SetDataType(aicpu::DT_FLOAT);
+        tensor->SetDataSize(static_cast<uint64_t>(tensor->CalcDataSizeByShape()));
+        return tensor;
+    }
+
+    aicpu::CpuKernelContext ctx_;
+    std::vector<std::shared_ptr<aicpu::Tensor>> tensors_;
+};
+
+// best of kRepeatTimes, in ns per launch
+template <typename Func>
+double MeasureNs(const Func &launch)
+{
+    double best_ns = 0.0;
+    for (int i = 0; i < kRepeatTimes; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        for (int64_t j = 0; j < kLaunches; ++j) {
+            launch();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / kLaunches;
+        if (i == 0 || ns < best_ns) {
+            best_ns = ns;
+        }
+    }
+    return best_ns;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    bool off = false;
+    const char *dump_path = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--off") == 0) {
+            off = true;
+        } else {
+            dump_path = argv[i];
+        }
+    }
+    if (off) {
+        unsetenv("CUST_AICPU_KERNEL_TRACE");
+    } else if (getenv("CUST_AICPU_KERNEL_TRACE") == nullptr) {
+        // enables the scopes, the dump at exit goes nowhere useful so it is left to dump_path
+        setenv("CUST_AICPU_KERNEL_TRACE", "/dev/null", 1);
+    }
+    printf("tracing %s\n", aicpu::KernelTraceEnabled() ? "enabled" : "disabled");
+    printf("%-24s %12s %12s %12s\n", "context", "bare ns", "traced ns", "cost ns");
+    for (const BenchContext &bench : kBenchContexts) {
+        ContextHolder holder(bench);
+        aicpu::CpuKernelContext &ctx = holder.Context();
+        // the asm barrier keeps the empty launch from being folded away
+        double bare = MeasureNs([&ctx]() { __asm__ __volatile__("" : : "r"(&ctx) : "memory"); });
+        double traced = MeasureNs([&ctx]() {
+            aicpu::KernelTraceScope scope(ctx, "Bench");
+            __asm__ __volatile__("" : : "r"(&ctx) : "memory");
+        });
+        printf("%-24s %12.1f %12.1f %12.1f\n", bench.name, bare, traced, traced - bare);
+    }
+    if (dump_path != nullptr) {
+        printf("dumped %zu records to %s: %s\n", aicpu::KernelTraceSnapshot().size(), dump_path,
+               aicpu::KernelTraceDump(dump_path) == 0 ? "ok" : "failed");
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: throughput benchmark of the sharded copy used by ParallelCopy
+ *
+ * Runs the same shard plan as ParallelCopy on plain std::thread workers, so it
+ * needs no kernel context and builds for both the board and the host:
+ *   g++ -O2 -std=c++11 -pthread -I../impl parallel_copy_bench.cc -o parallel_copy_bench
+ * Usage: parallel_copy_bench [max_threads]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "parallel_copy.h"
+
+namespace {
+const int kRepeatTimes = 10;
+const uint64_t kBenchSizes[] = {
+    64 * 1024, 1024 * 1024, 4 * 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024, 256 * 1024 * 1024
+};
+
+void RunShards(void *dst, const void *src, uint64_t size, uint32_t thread_num)
+{
+    if (thread_num <= 1) {
+        memcpy(dst, src, size);
+        return;
+    }
+    aicpu::CopyShardPlan plan = aicpu::PlanCopyShards(dst, size, thread_num);
+    int64_t per_thread = (plan.shard_num + thread_num - 1) / thread_num;
+    std::vector<std::thread> workers;
+    for (int64_t start = per_thread; start < plan.shard_num; start += per_thread) {
+        int64_t end = std::min(plan.shard_num, start + per_thread);
+        workers.emplace_back([=, &plan]() {
+            for (int64_t i = start; i < end; ++i) {
+                aicpu::CopyShard(dst, src, size, plan, i);
+            }
+        });
+    }
+    for (int64_t i = 0; i < std::min(plan.shard_num, per_thread); ++i) {
+        aicpu::CopyShard(dst, src, size, plan, i);
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+// best of kRepeatTimes, in GB/s of bytes read plus bytes written
+double MeasureGbps(void *dst, const void *src, uint64_t size, uint32_t thread_num)
+{
+    double best_ns = 0.0;
+    for (int i = 0; i < kRepeatTimes; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        RunShards(dst, src, size, thread_num);
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+        if (i == 0 || ns < best_ns) {
+            best_ns = ns;
+        }
+    }
+    return 2.0 * size / best_ns;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    if (argc > 1) {
+        max_threads = static_cast<uint32_t>(std::max(1, atoi(argv[1])));
+    }
+
+    printf("%12s %8s %10s %10s\n", "bytes", "threads", "GB/s", "speedup");
+    for (uint64_t size : kBenchSizes) {
+        std::vector<uint8_t> src(size, 1);
+        std::vector<uint8_t> dst(size, 0);
+        double base = 0.0;
+        for (uint32_t threads = 1; threads <= max_threads; threads *= 2) {
+            double gbps = MeasureGbps(dst.data(), src.data(), size, threads);
+            if (threads == 1) {
+                base = gbps;
+            }
+            printf("%12llu %8u %10.2f %9.2fx\n", static_cast<unsigned long long>(size), threads, gbps,
+                gbps / base);
+        }
+    }
+    return 0;
+}
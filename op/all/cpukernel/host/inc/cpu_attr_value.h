@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the AI CPU attribute value
+ */
+
+#ifndef _AICPU_HOST_CPU_ATTR_VALUE_H_
+#define _AICPU_HOST_CPU_ATTR_VALUE_H_
+
+#include <string>
+#include <vector>
+#include "cpu_types.h"
+
+namespace aicpu {
+class AICPU_VISIBILITY AttrValue {
+public:
+    AttrValue() = default;
+    ~AttrValue() = default;
+
+    std::string GetString() const { return s_; }
+    void SetString(const std::string &s) { s_ = s; }
+    int64_t GetInt() const { return i_; }
+    void SetInt(int64_t i) { i_ = i; }
+    float GetFloat() const { return f_; }
+    void SetFloat(float f) { f_ = f; }
+    bool GetBool() const { return b_; }
+    void SetBool(bool b) { b_ = b; }
+    DataType GetDataType() const { return type_; }
+    void SetDataType(DataType type) { type_ = type; }
+    std::vector<int64_t> GetListInt() const { return list_i_; }
+    void SetListInt(const std::vector<int64_t> &list) { list_i_ = list; }
+    std::vector<float> GetListFloat() const { return list_f_; }
+    void SetListFloat(const std::vector<float> &list) { list_f_ = list; }
+    std::vector<std::string> GetListString() const { return list_s_; }
+    void SetListString(const std::vector<std::string> &list) { list_s_ = list; }
+
+private:
+    std::string s_;
+    int64_t i_ = 0;
+    float f_ = 0.0f;
+    bool b_ = false;
+    DataType type_ = DT_UNDEFINED;
+    std::vector<int64_t> list_i_;
+    std::vector<float> list_f_;
+    std::vector<std::string> list_s_;
+};
+} // namespace aicpu
+#endif
@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the AI CPU kernel context
+ */
+
+#ifndef _AICPU_HOST_CPU_CONTEXT_H_
+#define _AICPU_HOST_CPU_CONTEXT_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "cpu_attr_value.h"
+#include "cpu_tensor.h"
+
+namespace aicpu {
+class AICPU_VISIBILITY CpuKernelContext {
+public:
+    explicit CpuKernelContext(DeviceType type = HOST) : device_type_(type) {}
+    ~CpuKernelContext() = default;
+
+    Tensor *Input(uint32_t index) const { return index < inputs_.size() ? inputs_[index] : nullptr; }
+    Tensor *Output(uint32_t index) const { return index < outputs_.size() ? outputs_[index] : nullptr; }
+    AttrValue *GetAttr(std::string name) const
+    {
+        auto iter = attrs_.find(name);
+        return iter == attrs_.end() ? nullptr : iter->second.get();
+    }
+    const std::string &GetOpType() const { return op_type_; }
+    uint32_t GetInputsSize() const { return static_cast<uint32_t>(inputs_.size()); }
+    uint32_t GetOutputsSize() const { return static_cast<uint32_t>(outputs_.size()); }
+
+    // host only: the benchmark driver assembles the node by hand
+    void SetOpType(const std::string &op_type) { op_type_ = op_type; }
+    void AddInput(Tensor *tensor) { inputs_.push_back(tensor); }
+    void AddOutput(Tensor *tensor) { outputs_.push_back(tensor); }
+    AttrValue *AddAttr(const std::string &name)
+    {
+        std::shared_ptr<AttrValue> &attr = attrs_[name];
+        attr = std::make_shared<AttrValue>();
+        return attr.get();
+    }
+    void SetCpuNum(uint32_t cpu_num) { cpu_num_ = cpu_num; }
+    uint32_t GetCpuNum() const { return cpu_num_; }
+
+private:
+    DeviceType device_type_;
+    std::string op_type_;
+    std::vector<Tensor *> inputs_;
+    std::vector<Tensor *> outputs_;
+    std::map<std::string, std::shared_ptr<AttrValue>> attrs_;
+    uint32_t cpu_num_ = 1;
+};
+} // namespace aicpu
+#endif
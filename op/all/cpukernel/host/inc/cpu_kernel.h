@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the AI CPU kernel base class and registry
+ */
+
+#ifndef _AICPU_HOST_CPU_KERNEL_H_
+#define _AICPU_HOST_CPU_KERNEL_H_
+
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "cpu_context.h"
+
+namespace aicpu {
+class AICPU_VISIBILITY CpuKernel {
+public:
+    virtual uint32_t Compute(CpuKernelContext &ctx) = 0;
+
+    virtual ~CpuKernel() {}
+};
+
+using KERNEL_CREATOR_FUN = std::function<std::shared_ptr<CpuKernel>(void)>;
+
+AICPU_VISIBILITY bool RegistCpuKernel(const std::string &type, const KERNEL_CREATOR_FUN &fun);
+
+// host only: look up what REGISTER_CPU_KERNEL put into the registry
+AICPU_VISIBILITY std::shared_ptr<CpuKernel> CreateCpuKernel(const std::string &type);
+AICPU_VISIBILITY std::vector<std::string> GetAllCpuKernelTypes();
+
+template <typename T, typename... Args>
+static inline std::shared_ptr<T> MakeShared(Args &&... args)
+{
+    typedef typename std::remove_const<T>::type T_nc;
+    std::shared_ptr<T> ret(new (std::nothrow) T_nc(std::forward<Args>(args)...));
+    return ret;
+}
+
+#define REGISTER_CPU_KERNEL(type, clazz)                                  \
+    std::shared_ptr<CpuKernel> Creator_##type##_Kernel()                  \
+    {                                                                     \
+        std::shared_ptr<clazz> ptr = nullptr;                             \
+        ptr = MakeShared<clazz>();                                        \
+        return ptr;                                                       \
+    }                                                                     \
+    bool g_##type##_Kernel_Creator __attribute__((unused)) =              \
+        RegistCpuKernel(type, Creator_##type##_Kernel)
+} // namespace aicpu
+#endif
@@ -0,0 +1,21 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the AI CPU kernel utils
+ */
+
+#ifndef _AICPU_HOST_CPU_KERNEL_UTILS_H_
+#define _AICPU_HOST_CPU_KERNEL_UTILS_H_
+
+#include <functional>
+#include "cpu_context.h"
+
+namespace aicpu {
+class AICPU_VISIBILITY CpuKernelUtils {
+public:
+    static uint32_t GetCPUNum(const CpuKernelContext &ctx);
+
+    static uint32_t ParallelFor(const CpuKernelContext &ctx, int64_t total, int64_t perUnitSize,
+                                const std::function<void(int64_t, int64_t)> &work);
+};
+} // namespace aicpu
+#endif
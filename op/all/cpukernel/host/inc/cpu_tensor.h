@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the AI CPU tensor
+ */
+
+#ifndef _AICPU_HOST_CPU_TENSOR_H_
+#define _AICPU_HOST_CPU_TENSOR_H_
+
+#include <memory>
+#include "cpu_tensor_shape.h"
+
+namespace aicpu {
+class AICPU_VISIBILITY Tensor {
+public:
+    Tensor() : shape_(std::make_shared<TensorShape>()) {}
+    ~Tensor() = default;
+
+    std::shared_ptr<TensorShape> GetTensorShape() const { return shape_; }
+    bool SetTensorShape(const TensorShape *shape)
+    {
+        if (shape == nullptr) {
+            return false;
+        }
+        *shape_ = *shape;
+        return true;
+    }
+    DataType GetDataType() const { return data_type_; }
+    void SetDataType(DataType type) { data_type_ = type; }
+    void *GetData() const { return data_; }
+    bool SetData(void *addr)
+    {
+        data_ = addr;
+        return true;
+    }
+    uint64_t GetDataSize() const { return data_size_; }
+    bool SetDataSize(uint64_t size)
+    {
+        data_size_ = size;
+        return true;
+    }
+    int64_t NumElements() const { return shape_->NumElements(); }
+    int64_t CalcDataSizeByShape() const;
+
+private:
+    std::shared_ptr<TensorShape> shape_;
+    DataType data_type_ = DT_UNDEFINED;
+    void *data_ = nullptr;
+    uint64_t data_size_ = 0;
+};
+} // namespace aicpu
+#endif
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the AI CPU tensor shape
+ */
+
+#ifndef _AICPU_HOST_CPU_TENSOR_SHAPE_H_
+#define _AICPU_HOST_CPU_TENSOR_SHAPE_H_
+
+#include <vector>
+#include "cpu_types.h"
+
+namespace aicpu {
+class AICPU_VISIBILITY TensorShape {
+public:
+    TensorShape() = default;
+    TensorShape(const std::vector<int64_t> &dims, Format format = FORMAT_ND) : dims_(dims), format_(format) {}
+    ~TensorShape() = default;
+
+    Format GetFormat() const { return format_; }
+    void SetFormat(Format format) { format_ = format; }
+    bool GetUnknownRank() const { return false; }
+    std::vector<int64_t> GetDimSizes() const { return dims_; }
+    void SetDimSizes(const std::vector<int64_t> &dims) { dims_ = dims; }
+    int64_t GetDimSize(int32_t index) const
+    {
+        return (index < 0 || static_cast<size_t>(index) >= dims_.size()) ? 0 : dims_[index];
+    }
+    int32_t GetDims() const { return static_cast<int32_t>(dims_.size()); }
+    int64_t NumElements() const
+    {
+        int64_t num = 1;
+        for (size_t i = 0; i < dims_.size(); ++i) {
+            num *= dims_[i];
+        }
+        return num;
+    }
+
+private:
+    std::vector<int64_t> dims_;
+    Format format_ = FORMAT_ND;
+};
+} // namespace aicpu
+#endif
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the AI CPU kernel data types
+ */
+
+#ifndef _AICPU_HOST_CPU_TYPES_H_
+#define _AICPU_HOST_CPU_TYPES_H_
+
+#include <cstdint>
+
+#ifndef AICPU_VISIBILITY
+#define AICPU_VISIBILITY __attribute__((visibility("default")))
+#endif
+
+namespace aicpu {
+enum DataType {
+    DT_FLOAT = 0,
+    DT_FLOAT16 = 1,
+    DT_INT8 = 2,
+    DT_INT32 = 3,
+    DT_UINT8 = 4,
+    DT_INT16 = 6,
+    DT_UINT16 = 7,
+    DT_UINT32 = 8,
+    DT_INT64 = 9,
+    DT_UINT64 = 10,
+    DT_DOUBLE = 11,
+    DT_BOOL = 12,
+    DT_STRING = 13,
+    DT_DUAL_SUB_INT8 = 14,
+    DT_DUAL_SUB_UINT8 = 15,
+    DT_COMPLEX64 = 16,
+    DT_COMPLEX128 = 17,
+    DT_QINT8 = 18,
+    DT_QINT16 = 19,
+    DT_QINT32 = 20,
+    DT_QUINT8 = 21,
+    DT_QUINT16 = 22,
+    DT_RESOURCE = 23,
+    DT_STRING_REF = 24,
+    DT_DUAL = 25,
+    DT_UNDEFINED
+};
+
+enum Format {
+    FORMAT_NCHW = 0,
+    FORMAT_NHWC,
+    FORMAT_ND,
+    FORMAT_NC1HWC0,
+    FORMAT_FRACTAL_Z,
+    FORMAT_RESERVED = 40
+};
+
+enum DeviceType { HOST, DEVICE };
+
+enum KernelStatus : uint32_t {
+    KERNEL_STATUS_OK = 0,
+    KERNEL_STATUS_PARAM_INVALID = 1,
+    KERNEL_STATUS_INNER_ERROR = 2,
+    KERNEL_STATUS_TIMEOUT = 3,
+    KERNEL_STATUS_PROTOBUF_ERROR = 4,
+    KERNEL_STATUS_SHARDER_ERROR = 5
+};
+} // namespace aicpu
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of libcpu_kernels_context.so
+ */
+
+#include <algorithm>
+#include <map>
+#include <thread>
+#include <vector>
+#include "cpu_kernel.h"
+#include "cpu_kernel_utils.h"
+
+namespace aicpu {
+namespace {
+std::map<std::string, KERNEL_CREATOR_FUN> &KernelRegistry()
+{
+    static std::map<std::string, KERNEL_CREATOR_FUN> registry;
+    return registry;
+}
+
+int64_t DataTypeSize(DataType type)
+{
+    switch (type) {
+        case DT_BOOL:
+        case DT_INT8:
+        case DT_UINT8:
+        case DT_QINT8:
+        case DT_QUINT8:
+            return 1;
+        case DT_FLOAT16:
+        case DT_INT16:
+        case DT_UINT16:
+        case DT_QINT16:
+        case DT_QUINT16:
+            return 2;
+        case DT_FLOAT:
+        case DT_INT32:
+        case DT_UINT32:
+        case DT_QINT32:
+            return 4;
+        case DT_INT64:
+        case DT_UINT64:
+        case DT_DOUBLE:
+        case DT_COMPLEX64:
+            return 8;
+        case DT_COMPLEX128:
+            return 16;
+        default:
+            return -1;
+    }
+}
+}
+
+bool RegistCpuKernel(const std::string &type, const KERNEL_CREATOR_FUN &fun)
+{
+    KernelRegistry()[type] = fun;
+    return true;
+}
+
+std::shared_ptr<CpuKernel> CreateCpuKernel(const std::string &type)
+{
+    auto iter = KernelRegistry().find(type);
+    if (iter == KernelRegistry().end()) {
+        return nullptr;
+    }
+    return iter->second();
+}
+
+std::vector<std::string> GetAllCpuKernelTypes()
+{
+    std::vector<std::string> types;
+    for (auto &item : KernelRegistry()) {
+        types.push_back(item.first);
+    }
+    return types;
+}
+
+int64_t Tensor::CalcDataSizeByShape() const
+{
+    int64_t type_size = DataTypeSize(data_type_);
+    if (type_size < 0) {
+        return -1;
+    }
+    return NumElements() * type_size;
+}
+
+uint32_t CpuKernelUtils::GetCPUNum(const CpuKernelContext &ctx)
+{
+    return ctx.GetCpuNum();
+}
+
+uint32_t CpuKernelUtils::ParallelFor(const CpuKernelContext &ctx, int64_t total, int64_t perUnitSize,
+                                     const std::function<void(int64_t, int64_t)> &work)
+{
+    if (total <= 0 || perUnitSize <= 0) {
+        return KERNEL_STATUS_PARAM_INVALID;
+    }
+    int64_t cpu_num = std::max<int64_t>(1, ctx.GetCpuNum());
+    int64_t block_num = std::min(cpu_num, (total + perUnitSize - 1) / perUnitSize);
+    int64_t block_size = (total + block_num - 1) / block_num;
+    if (block_num <= 1) {
+        work(0, total);
+        return KERNEL_STATUS_OK;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(block_num - 1);
+    for (int64_t start = block_size; start < total; start += block_size) {
+        int64_t end = std::min(total, start + block_size);
+        threads.emplace_back([&work, start, end]() { work(start, end); });
+    }
+    work(0, std::min(total, block_size));
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    return KERNEL_STATUS_OK;
+}
+} // namespace aicpu
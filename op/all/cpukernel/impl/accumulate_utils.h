@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of accumulation types for multiply-add kernels
+ *
+ * float16 accumulates in float and 8 bit integers in int32, as on the cube
+ * unit. Widen converts an element into its accumulation type and Narrow
+ * writes an accumulator back into the output type, both also come in bulk.
+ */
+
+#ifndef _AICPU_ACCUMULATE_UTILS_H_
+#define _AICPU_ACCUMULATE_UTILS_H_
+
+#include <stdint.h>
+#include "fp16_utils.h"
+
+namespace aicpu {
+template <typename T>
+struct Accumulate {
+    typedef T Type;
+};
+
+template <>
+struct Accumulate<Half> {
+    typedef float Type;
+};
+
+template <>
+struct Accumulate<int8_t> {
+    typedef int32_t Type;
+};
+
+template <>
+struct Accumulate<uint8_t> {
+    typedef int32_t Type;
+};
+
+inline float Widen(Half value) { return HalfToFloat(value); }
+inline float Widen(float value) { return value; }
+inline int32_t Widen(int8_t value) { return value; }
+inline int32_t Widen(uint8_t value) { return value; }
+inline int32_t Widen(int32_t value) { return value; }
+
+inline void Narrow(float value, float *dst) { *dst = value; }
+inline void Narrow(float value, Half *dst) { *dst = FloatToHalf(value); }
+inline void Narrow(int32_t value, int32_t *dst) { *dst = value; }
+
+// dst[i] = Widen(src[i]) for i in [0, n), float16 takes the bulk conversion
+template <typename T>
+inline void Widen(const T *src, typename Accumulate<T>::Type *dst, int64_t n)
+{
+    for (int64_t i = 0; i < n; ++i) {
+        dst[i] = Widen(src[i]);
+    }
+}
+
+inline void Widen(const Half *src, float *dst, int64_t n) { HalfToFloat(src, dst, n); }
+
+// Narrow(src[i], dst + i) for i in [0, n)
+template <typename TAcc, typename T>
+inline void Narrow(const TAcc *src, T *dst, int64_t n)
+{
+    for (int64_t i = 0; i < n; ++i) {
+        Narrow(src[i], dst + i);
+    }
+}
+
+inline void Narrow(const float *src, Half *dst, int64_t n) { FloatToHalf(src, dst, n); }
+} // namespace aicpu
+#endif
@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of Add
+ */
+
+#include "add_kernels.h"
+#include "elementwise_utils.h"
+#include "kernel_trace.h"
+
+namespace {
+const char *ADD = "Add";
+
+struct AddOp {
+    template <typename V>
+    V operator()(const V &a, const V &b) const { return a + b; }
+};
+}
+
+namespace aicpu {
+uint32_t AddCpuKernel::Compute(CpuKernelContext &ctx)
+{
+    KERNEL_TRACE_SCOPE(ctx, ADD);
+    // same order as the TensorType list of the Add op_proto
+    return BinaryElementwiseCompute(ctx, AddOp(),
+        TypeList<float, int32_t, int64_t, Half, int16_t, int8_t, uint8_t, double>());
+}
+
+REGISTER_CPU_KERNEL(ADD, AddCpuKernel);
+} // namespace aicpu
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of Add
+ */
+
+#ifndef _AICPU_ADD_KERNELS_H_
+#define _AICPU_ADD_KERNELS_H_
+
+#include "cpu_kernel.h"
+
+namespace aicpu {
+class AddCpuKernel : public CpuKernel {
+public:
+    ~AddCpuKernel() = default;
+    uint32_t Compute(CpuKernelContext &ctx) override;
+};
+} // namespace aicpu
+#endif
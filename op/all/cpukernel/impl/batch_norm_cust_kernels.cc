@@ -0,0 +1,225 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of BatchNormCust
+ */
+
+#include "batch_norm_cust_kernels.h"
+#include <string.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "cpu_kernel_utils.h"
+#include "cpu_types.h"
+#include "fp16_utils.h"
+#include "kernel_trace.h"
+#include "vector_ops.h"
+#include "workspace_arena.h"
+
+namespace {
+const char *BATCH_NORM_CUST = "BatchNormCust";
+const int64_t kMinShardElements = 16 * 1024;
+// channel-last rows are normalized about this many elements at a time
+const int64_t kChannelBlock = 1024;
+
+/*
+ * x viewed as [outer, channels, inner]: NCHW is [n, c, h * w] and NHWC is
+ * [n * h * w, c, 1]. With inner == 1 every row holds one value per channel,
+ * whatever the format, and takes the channel-last path.
+ */
+struct BatchNormShape {
+    int64_t outer;
+    int64_t channels;
+    int64_t inner;
+};
+
+inline float LoadFloat(float value)
+{
+    return value;
+}
+
+inline float LoadFloat(aicpu::Half value)
+{
+    return aicpu::HalfToFloat(value);
+}
+
+/*
+ * y = (x - gamma) / beta, gamma holding the mean and beta the variance as
+ * in the TIK tiling modes, folded into y = x * scale + shift. The pair is
+ * repeated rows times so a block of channel-last rows needs one MulAdd.
+ */
+template <typename T>
+void FoldScaleShift(const T *gamma, const T *beta, int64_t channels, int64_t rows, float *scale, float *shift)
+{
+    for (int64_t c = 0; c < channels; ++c) {
+        scale[c] = 1.0f / LoadFloat(beta[c]);
+        shift[c] = -LoadFloat(gamma[c]) * scale[c];
+    }
+    // doubling copies, a few channels repeated over a block would otherwise take hundreds of tiny ones
+    int64_t total = channels * rows;
+    for (int64_t filled = channels; filled < total; filled *= 2) {
+        int64_t len = (total - filled < filled) ? (total - filled) : filled;
+        memcpy(scale + filled, scale, len * sizeof(float));
+        memcpy(shift + filled, shift, len * sizeof(float));
+    }
+}
+
+inline void NormalizePlane(float *y, const float *x, int64_t n, float scale, float shift)
+{
+    aicpu::MulAddScalar(y, x, scale, shift, n);
+}
+
+inline void NormalizePlane(aicpu::Half *y, const aicpu::Half *x, int64_t n, float scale, float shift)
+{
+    aicpu::HalfUnary(y, x, n, [scale, shift](float *out, const float *in, int64_t len) {
+        aicpu::MulAddScalar(out, in, scale, shift, len);
+    });
+}
+
+// buffer is unused for float, float16 is widened into it
+inline void NormalizeRows(float *y, const float *x, const float *scale, const float *shift, int64_t n, float *)
+{
+    aicpu::MulAdd(y, x, scale, shift, n);
+}
+
+inline void NormalizeRows(aicpu::Half *y, const aicpu::Half *x, const float *scale, const float *shift, int64_t n,
+                          float *buffer)
+{
+    aicpu::HalfToFloat(x, buffer, n);
+    aicpu::MulAdd(buffer, buffer, scale, shift, n);
+    aicpu::FloatToHalf(buffer, y, n);
+}
+
+// run shard over units of unit_elements each, on the calling thread when it is too small to split
+template <typename Shard>
+uint32_t ShardUnits(const aicpu::CpuKernelContext &ctx, int64_t units, int64_t unit_elements, const Shard &shard)
+{
+    if (aicpu::CpuKernelUtils::GetCPUNum(ctx) <= 1 || units * unit_elements <= kMinShardElements) {
+        shard(0, units);
+        return 0;
+    }
+    int64_t units_per_shard = (kMinShardElements + unit_elements - 1) / unit_elements;
+    return aicpu::CpuKernelUtils::ParallelFor(ctx, units, units_per_shard, shard) != 0 ? -1 : 0;
+}
+
+template <typename T>
+uint32_t BatchNormCompute(const aicpu::CpuKernelContext &ctx, T *y, const T *x, const T *gamma, const T *beta,
+                          const BatchNormShape &shape)
+{
+    bool channel_last = shape.inner == 1;
+    // the pattern is never longer than x, small launches would spend their time building it
+    int64_t block_rows = (channel_last && shape.channels < kChannelBlock) ? kChannelBlock / shape.channels : 1;
+    block_rows = (block_rows < shape.outer) ? block_rows : shape.outer;
+    int64_t block = block_rows * shape.channels;
+    aicpu::ScopedWorkspace workspace(2 * aicpu::WorkspaceBytes<float>(block));
+    float *scale = workspace.Arena().Allocate<float>(block);
+    float *shift = workspace.Arena().Allocate<float>(block);
+    if (scale == nullptr || shift == nullptr) {
+        return -1;
+    }
+    FoldScaleShift(gamma, beta, shape.channels, block_rows, scale, shift);
+
+    if (!channel_last) {
+        // one plane per (n, c), a single multiply-add over its h * w elements
+        auto shard = [&](int64_t start, int64_t end) {
+            for (int64_t plane = start; plane < end; ++plane) {
+                int64_t c = plane % shape.channels;
+                NormalizePlane(y + plane * shape.inner, x + plane * shape.inner, shape.inner, scale[c], shift[c]);
+            }
+        };
+        return ShardUnits(ctx, shape.outer * shape.channels, shape.inner, shard);
+    }
+
+    bool widen = sizeof(T) < sizeof(float);
+    std::atomic<bool> failed(false);
+    auto shard = [&](int64_t start, int64_t end) {
+        aicpu::ScopedWorkspace rows_workspace(widen ? aicpu::WorkspaceBytes<float>(block) : 0);
+        float *buffer = widen ? rows_workspace.Arena().Allocate<float>(block) : nullptr;
+        if (widen && buffer == nullptr) {
+            failed = true;
+            return;
+        }
+        for (int64_t row = start; row < end; row += block_rows) {
+            int64_t rows = (end - row < block_rows) ? (end - row) : block_rows;
+            int64_t offset = row * shape.channels;
+            NormalizeRows(y + offset, x + offset, scale, shift, rows * shape.channels, buffer);
+        }
+    };
+    if (ShardUnits(ctx, shape.outer, shape.channels, shard) != 0) {
+        return -1;
+    }
+    return failed ? -1 : 0;
+}
+}
+
+namespace aicpu {
+uint32_t BatchNormCustCpuKernel::Compute(CpuKernelContext &ctx)
+{
+    KERNEL_TRACE_SCOPE(ctx, BATCH_NORM_CUST);
+    Tensor *x_tensor = ctx.Input(0);
+    Tensor *gamma_tensor = ctx.Input(1);
+    Tensor *beta_tensor = ctx.Input(2);
+    Tensor *y_tensor = ctx.Output(0);
+    if (x_tensor == nullptr || gamma_tensor == nullptr || beta_tensor == nullptr || y_tensor == nullptr) {
+        return -1;
+    }
+
+    bool nhwc = false;
+    AttrValue *data_format = ctx.GetAttr("data_format");
+    if (data_format != nullptr) {
+        std::string format = data_format->GetString();
+        if (format != "NCHW" && format != "NHWC") {
+            return -1;
+        }
+        nhwc = format == "NHWC";
+    }
+
+    std::vector<int64_t> x_dims = x_tensor->GetTensorShape()->GetDimSizes();
+    if (x_dims.size() < 2 || y_tensor->GetTensorShape()->GetDimSizes() != x_dims) {
+        return -1;
+    }
+    BatchNormShape shape;
+    shape.outer = 1;
+    shape.inner = 1;
+    size_t channel_axis = nhwc ? x_dims.size() - 1 : 1;
+    shape.channels = x_dims[channel_axis];
+    for (size_t i = 0; i < x_dims.size(); ++i) {
+        if (i < channel_axis) {
+            shape.outer *= x_dims[i];
+        } else if (i > channel_axis) {
+            shape.inner *= x_dims[i];
+        }
+    }
+    if (gamma_tensor->NumElements() != shape.channels || beta_tensor->NumElements() != shape.channels) {
+        return -1;
+    }
+    DataType dtype = x_tensor->GetDataType();
+    if (gamma_tensor->GetDataType() != dtype || beta_tensor->GetDataType() != dtype ||
+        y_tensor->GetDataType() != dtype) {
+        return -1;
+    }
+    if (shape.outer * shape.channels * shape.inner == 0) {
+        return 0;
+    }
+    void *x_data = x_tensor->GetData();
+    void *gamma_data = gamma_tensor->GetData();
+    void *beta_data = beta_tensor->GetData();
+    void *y_data = y_tensor->GetData();
+    if (x_data == nullptr || gamma_data == nullptr || beta_data == nullptr || y_data == nullptr) {
+        return -1;
+    }
+
+    switch (dtype) {
+        case DT_FLOAT16:
+            return BatchNormCompute(ctx, static_cast<Half *>(y_data), static_cast<const Half *>(x_data),
+                                    static_cast<const Half *>(gamma_data), static_cast<const Half *>(beta_data), shape);
+        case DT_FLOAT:
+            return BatchNormCompute(ctx, static_cast<float *>(y_data), static_cast<const float *>(x_data),
+                                    static_cast<const float *>(gamma_data), static_cast<const float *>(beta_data),
+                                    shape);
+        default:
+            return -1;
+    }
+}
+
+REGISTER_CPU_KERNEL(BATCH_NORM_CUST, BatchNormCustCpuKernel);
+} // namespace aicpu
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of BatchNormCust
+ */
+
+#ifndef _AICPU_BATCH_NORM_CUST_KERNELS_H_
+#define _AICPU_BATCH_NORM_CUST_KERNELS_H_
+
+#include "cpu_kernel.h"
+
+namespace aicpu {
+class BatchNormCustCpuKernel : public CpuKernel {
+public:
+    ~BatchNormCustCpuKernel() = default;
+    uint32_t Compute(CpuKernelContext &ctx) override;
+};
+} // namespace aicpu
+#endif
@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of broadcast dimension collapsing for binary kernels
+ */
+
+#ifndef _AICPU_BROADCAST_UTILS_H_
+#define _AICPU_BROADCAST_UTILS_H_
+
+#include <stdint.h>
+#include <vector>
+
+namespace aicpu {
+// one loop level of a binary broadcast, stride is 0 for the input being broadcast
+struct BroadcastDim {
+    int64_t size;
+    int64_t stride[2];
+};
+
+/*
+ * Right-align x1 and x2 against the output shape y, as the Add infer function
+ * does, drop the size 1 output dims and merge adjacent dims in which both
+ * inputs are contiguous or the same input is broadcast. The result has the
+ * fewest loop levels that still walk y in order, outermost first, and is
+ * never empty. Returns false when an input does not broadcast to y, or y
+ * has a dim that neither input has.
+ */
+inline bool CollapseBroadcastDims(const std::vector<int64_t> &x1, const std::vector<int64_t> &x2,
+                                  const std::vector<int64_t> &y, std::vector<BroadcastDim> &dims)
+{
+    const std::vector<int64_t> *inputs[2] = {&x1, &x2};
+    size_t rank = y.size();
+    if (x1.size() > rank || x2.size() > rank) {
+        return false;
+    }
+    dims.clear();
+    int prev_mask = -1;
+    for (size_t i = 0; i < rank; ++i) {
+        int64_t size = y[i];
+        int mask = 0;
+        for (int k = 0; k < 2; ++k) {
+            size_t pad = rank - inputs[k]->size();
+            int64_t in_size = (i < pad) ? 1 : (*inputs[k])[i - pad];
+            if (in_size != size && in_size != 1) {
+                return false;
+            }
+            if (in_size != size) {
+                mask |= 1 << k;
+            }
+        }
+        if (size == 1) {
+            continue;
+        }
+        if (mask == 3) {
+            // neither input has this dim, so y is not their broadcast shape
+            return false;
+        }
+        if (mask == prev_mask) {
+            dims.back().size *= size;
+        } else {
+            BroadcastDim dim;
+            dim.size = size;
+            dim.stride[0] = mask & 1;
+            dim.stride[1] = (mask >> 1) & 1;
+            dims.push_back(dim);
+            prev_mask = mask;
+        }
+    }
+    if (dims.empty()) {
+        BroadcastDim dim = {1, {0, 0}};
+        dims.push_back(dim);
+    }
+
+    // the broadcast flags become element strides, innermost first
+    int64_t running[2] = {1, 1};
+    for (size_t i = dims.size(); i > 0; --i) {
+        BroadcastDim &dim = dims[i - 1];
+        for (int k = 0; k < 2; ++k) {
+            bool broadcast = dim.stride[k] != 0;
+            dim.stride[k] = broadcast ? 0 : running[k];
+            if (!broadcast) {
+                running[k] *= dim.size;
+            }
+        }
+    }
+    return true;
+}
+} // namespace aicpu
+#endif
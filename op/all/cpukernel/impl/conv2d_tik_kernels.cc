@@ -0,0 +1,625 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of Conv2DTik
+ *
+ * NCHW input, [out_c, in_c / groups, k_h, k_w] filter, with the strides,
+ * pads and dilations written by ParseParamsConv2D. Unit-stride 3x3 float
+ * and float16 convolutions use Winograd F(2x2, 3x3); everything else, and
+ * every int8 convolution, runs a direct convolution blocked over kOcBlock
+ * output channels. Work is split over batch x groups x output channel
+ * blocks.
+ */
+
+#include "conv2d_tik_kernels.h"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "accumulate_utils.h"
+#include "cpu_kernel_utils.h"
+#include "cpu_types.h"
+#include "kernel_trace.h"
+#include "vector_ops.h"
+#include "workspace_arena.h"
+
+namespace {
+const char *CONV2D_TIK = "Conv2DTik";
+// output channels computed together, every input row loaded feeds all of them
+const int64_t kOcBlock = 4;
+// output elements per accumulator row, keeps kOcBlock rows in L1
+const int64_t kRowChunk = 256;
+// Winograd tiles accumulated together
+const int64_t kTileChunk = 32;
+const int64_t kWinogradTile = 16;
+// below this many multiply-adds the launch stays on the calling core
+const int64_t kMinParallelMacs = 64 * 1024;
+
+struct ConvParams {
+    int64_t batch;
+    int64_t in_c;
+    int64_t in_h;
+    int64_t in_w;
+    int64_t out_c;
+    int64_t out_h;
+    int64_t out_w;
+    int64_t k_h;
+    int64_t k_w;
+    int64_t stride_h;
+    int64_t stride_w;
+    int64_t dilation_h;
+    int64_t dilation_w;
+    int64_t pad_t;
+    int64_t pad_b;
+    int64_t pad_l;
+    int64_t pad_r;
+    int64_t groups;
+    int64_t offset_x;
+    // size of the padded input plane, Winograd rounds it up to whole tiles
+    int64_t plane_h;
+    int64_t plane_w;
+    bool winograd;
+
+    int64_t GroupInC() const { return in_c / groups; }
+    int64_t GroupOutC() const { return out_c / groups; }
+    int64_t GroupOcBlocks() const { return (GroupOutC() + kOcBlock - 1) / kOcBlock; }
+    int64_t TilesH() const { return (out_h + 1) / 2; }
+    int64_t TilesW() const { return (out_w + 1) / 2; }
+};
+
+// list attrs in NCHW order, the h and w entries are 2 and 3
+bool GetHwAttr(const aicpu::CpuKernelContext &ctx, const char *name, int64_t default_value, int64_t &h, int64_t &w)
+{
+    aicpu::AttrValue *attr = ctx.GetAttr(name);
+    if (attr == nullptr) {
+        h = default_value;
+        w = default_value;
+        return true;
+    }
+    std::vector<int64_t> values = attr->GetListInt();
+    if (values.size() != 4) {
+        return false;
+    }
+    h = values[2];
+    w = values[3];
+    return true;
+}
+
+bool ParseConvParams(const aicpu::CpuKernelContext &ctx, const std::vector<int64_t> &x_dims,
+                     const std::vector<int64_t> &w_dims, const std::vector<int64_t> &y_dims, ConvParams &params)
+{
+    if (x_dims.size() != 4 || w_dims.size() != 4 || y_dims.size() != 4) {
+        return false;
+    }
+    aicpu::AttrValue *data_format = ctx.GetAttr("data_format");
+    if (data_format != nullptr && data_format->GetString() != "NCHW") {
+        return false;
+    }
+    aicpu::AttrValue *strides = ctx.GetAttr("strides");
+    aicpu::AttrValue *pads = ctx.GetAttr("pads");
+    if (strides == nullptr || pads == nullptr || pads->GetListInt().size() != 4) {
+        return false;
+    }
+    if (!GetHwAttr(ctx, "strides", 1, params.stride_h, params.stride_w) ||
+        !GetHwAttr(ctx, "dilations", 1, params.dilation_h, params.dilation_w)) {
+        return false;
+    }
+    std::vector<int64_t> pad_list = pads->GetListInt();
+    params.pad_t = pad_list[0];
+    params.pad_b = pad_list[1];
+    params.pad_l = pad_list[2];
+    params.pad_r = pad_list[3];
+    aicpu::AttrValue *groups = ctx.GetAttr("groups");
+    params.groups = (groups == nullptr) ? 1 : groups->GetInt();
+    aicpu::AttrValue *offset_x = ctx.GetAttr("offset_x");
+    params.offset_x = (offset_x == nullptr) ? 0 : offset_x->GetInt();
+    if (params.stride_h <= 0 || params.stride_w <= 0 || params.dilation_h <= 0 || params.dilation_w <= 0 ||
+        params.pad_t < 0 || params.pad_b < 0 || params.pad_l < 0 || params.pad_r < 0 || params.groups <= 0) {
+        return false;
+    }
+
+    params.batch = x_dims[0];
+    params.in_c = x_dims[1];
+    params.in_h = x_dims[2];
+    params.in_w = x_dims[3];
+    params.out_c = w_dims[0];
+    params.k_h = w_dims[2];
+    params.k_w = w_dims[3];
+    if (params.in_c % params.groups != 0 || params.out_c % params.groups != 0 ||
+        w_dims[1] != params.GroupInC() || params.k_h <= 0 || params.k_w <= 0) {
+        return false;
+    }
+    params.plane_h = params.in_h + params.pad_t + params.pad_b;
+    params.plane_w = params.in_w + params.pad_l + params.pad_r;
+    // a window wider than the padded input leaves no output, and the division below would round that up to one
+    if (params.plane_h < params.dilation_h * (params.k_h - 1) + 1 ||
+        params.plane_w < params.dilation_w * (params.k_w - 1) + 1) {
+        return false;
+    }
+    params.out_h = (params.plane_h - params.dilation_h * (params.k_h - 1) - 1) / params.stride_h + 1;
+    params.out_w = (params.plane_w - params.dilation_w * (params.k_w - 1) - 1) / params.stride_w + 1;
+    if (params.out_h <= 0 || params.out_w <= 0 || y_dims[0] != params.batch || y_dims[1] != params.out_c ||
+        y_dims[2] != params.out_h || y_dims[3] != params.out_w) {
+        return false;
+    }
+    params.winograd = params.k_h == 3 && params.k_w == 3 && params.stride_h == 1 && params.stride_w == 1 &&
+                      params.dilation_h == 1 && params.dilation_w == 1;
+    return true;
+}
+
+// acc[o][i] += w[o] * x[i] for kOcBlock rows of acc
+template <typename TAcc>
+inline void MulAddBlock(TAcc *acc, int64_t acc_stride, const TAcc *w, const TAcc *x, int64_t n)
+{
+    typedef typename aicpu::VecTraits<TAcc>::Vec Vec;
+    const int64_t lanes = aicpu::VecTraits<TAcc>::kLanes;
+    static_assert(kOcBlock == 4, "MulAddBlock is unrolled for four output channels");
+    TAcc *acc0 = acc;
+    TAcc *acc1 = acc + acc_stride;
+    TAcc *acc2 = acc + 2 * acc_stride;
+    TAcc *acc3 = acc + 3 * acc_stride;
+    Vec w0 = Vec{} + w[0];
+    Vec w1 = Vec{} + w[1];
+    Vec w2 = Vec{} + w[2];
+    Vec w3 = Vec{} + w[3];
+    int64_t i = 0;
+    for (; i + lanes <= n; i += lanes) {
+        Vec xv = aicpu::VecLoad<Vec>(x + i);
+        aicpu::VecStore(acc0 + i, aicpu::VecLoad<Vec>(acc0 + i) + w0 * xv);
+        aicpu::VecStore(acc1 + i, aicpu::VecLoad<Vec>(acc1 + i) + w1 * xv);
+        aicpu::VecStore(acc2 + i, aicpu::VecLoad<Vec>(acc2 + i) + w2 * xv);
+        aicpu::VecStore(acc3 + i, aicpu::VecLoad<Vec>(acc3 + i) + w3 * xv);
+    }
+    for (; i < n; ++i) {
+        acc0[i] += w[0] * x[i];
+        acc1[i] += w[1] * x[i];
+        acc2[i] += w[2] * x[i];
+        acc3[i] += w[3] * x[i];
+    }
+}
+
+template <typename TAcc>
+inline void MulAddBlockStrided(TAcc *acc, int64_t acc_stride, const TAcc *w, const TAcc *x, int64_t stride, int64_t n)
+{
+    for (int64_t i = 0; i < n; ++i) {
+        TAcc value = x[i * stride];
+        for (int64_t o = 0; o < kOcBlock; ++o) {
+            acc[o * acc_stride + i] += w[o] * value;
+        }
+    }
+}
+
+// 4x4 input tile d with row stride ld into B^T d B
+template <typename TAcc>
+void WinogradInputTile(const TAcc *d, int64_t ld, TAcc *v)
+{
+    TAcc t[4][4];
+    for (int64_t c = 0; c < 4; ++c) {
+        TAcc d0 = d[c];
+        TAcc d1 = d[ld + c];
+        TAcc d2 = d[2 * ld + c];
+        TAcc d3 = d[3 * ld + c];
+        t[0][c] = d0 - d2;
+        t[1][c] = d1 + d2;
+        t[2][c] = d2 - d1;
+        t[3][c] = d1 - d3;
+    }
+    for (int64_t r = 0; r < 4; ++r) {
+        v[4 * r] = t[r][0] - t[r][2];
+        v[4 * r + 1] = t[r][1] + t[r][2];
+        v[4 * r + 2] = t[r][2] - t[r][1];
+        v[4 * r + 3] = t[r][1] - t[r][3];
+    }
+}
+
+// 3x3 filter g into G g G^T
+template <typename TAcc>
+void WinogradFilterTile(const TAcc *g, TAcc *u)
+{
+    TAcc t[4][3];
+    for (int64_t c = 0; c < 3; ++c) {
+        TAcc g0 = g[c];
+        TAcc g1 = g[3 + c];
+        TAcc g2 = g[6 + c];
+        t[0][c] = g0;
+        t[1][c] = (g0 + g1 + g2) * TAcc(0.5);
+        t[2][c] = (g0 - g1 + g2) * TAcc(0.5);
+        t[3][c] = g2;
+    }
+    for (int64_t r = 0; r < 4; ++r) {
+        u[4 * r] = t[r][0];
+        u[4 * r + 1] = (t[r][0] + t[r][1] + t[r][2]) * TAcc(0.5);
+        u[4 * r + 2] = (t[r][0] - t[r][1] + t[r][2]) * TAcc(0.5);
+        u[4 * r + 3] = t[r][2];
+    }
+}
+
+// 4x4 product m into the 2x2 output A^T m A
+template <typename TAcc>
+void WinogradOutputTile(const TAcc *m, TAcc y[2][2])
+{
+    TAcc s[2][4];
+    for (int64_t c = 0; c < 4; ++c) {
+        s[0][c] = m[c] + m[4 + c] + m[8 + c];
+        s[1][c] = m[4 + c] - m[8 + c] - m[12 + c];
+    }
+    for (int64_t r = 0; r < 2; ++r) {
+        y[r][0] = s[r][0] + s[r][1] + s[r][2];
+        y[r][1] = s[r][1] - s[r][2] - s[r][3];
+    }
+}
+
+template <typename T, typename TOut>
+class ConvRunner {
+public:
+    typedef typename aicpu::Accumulate<T>::Type TAcc;
+
+    ConvRunner(const ConvParams &params, const T *x, const T *w, TOut *y)
+        : params_(params), x_(x), w_(w), y_(y), bias_(nullptr), filter_(nullptr), input_(nullptr), failed_(false)
+    {
+        // Winograd needs fractions of the filter, integer paths stay exact with the direct convolution
+        params_.winograd = params_.winograd && std::is_floating_point<TAcc>::value;
+        if (params_.winograd) {
+            params_.plane_h = std::max(params_.plane_h, 2 * params_.TilesH() + 2);
+            params_.plane_w = std::max(params_.plane_w, 2 * params_.TilesW() + 2);
+        }
+    }
+
+    // scratch held for the whole launch: bias, packed filter and the padded or transformed input
+    uint64_t LaunchWorkspace() const
+    {
+        int64_t filter_size = params_.winograd ? params_.out_c * params_.GroupInC() * kWinogradTile :
+            params_.groups * params_.GroupOcBlocks() * params_.GroupInC() * params_.k_h * params_.k_w * kOcBlock;
+        int64_t plane_size = params_.winograd ? params_.TilesH() * params_.TilesW() * kWinogradTile :
+            params_.plane_h * params_.plane_w;
+        return aicpu::WorkspaceBytes<TAcc>(params_.out_c) + aicpu::WorkspaceBytes<TAcc>(filter_size) +
+               aicpu::WorkspaceBytes<TAcc>(params_.batch * params_.in_c * plane_size);
+    }
+
+    // scratch of one prepare or compute shard
+    uint64_t ShardWorkspace() const
+    {
+        if (params_.winograd) {
+            return aicpu::WorkspaceBytes<TAcc>(params_.plane_h * params_.plane_w) +
+                   aicpu::WorkspaceBytes<TAcc>(kOcBlock * kTileChunk * kWinogradTile);
+        }
+        return aicpu::WorkspaceBytes<TAcc>(kOcBlock * kRowChunk);
+    }
+
+    uint32_t Run(const aicpu::CpuKernelContext &ctx, aicpu::Tensor *bias)
+    {
+        aicpu::ScopedWorkspace workspace(LaunchWorkspace());
+        if (!workspace.Valid()) {
+            return -1;
+        }
+        int64_t planes = params_.batch * params_.in_c;
+        bias_ = workspace.Arena().Allocate<TAcc>(params_.out_c);
+        if (!LoadBias(bias)) {
+            return -1;
+        }
+        int64_t items = params_.batch * params_.groups * params_.GroupOcBlocks();
+        int64_t macs = params_.batch * params_.out_c * params_.out_h * params_.out_w * params_.GroupInC() *
+                       params_.k_h * params_.k_w;
+        bool parallel = aicpu::CpuKernelUtils::GetCPUNum(ctx) > 1 && macs >= kMinParallelMacs;
+        std::function<void(int64_t, int64_t)> prepare;
+        std::function<void(int64_t, int64_t)> compute;
+        if (params_.winograd) {
+            filter_ = workspace.Arena().Allocate<TAcc>(params_.out_c * params_.GroupInC() * kWinogradTile);
+            input_ = workspace.Arena().Allocate<TAcc>(planes * params_.TilesH() * params_.TilesW() * kWinogradTile);
+            PrepareWinogradFilter();
+            prepare = [this](int64_t start, int64_t end) { TransformInput(start, end); };
+            compute = [this](int64_t start, int64_t end) { ComputeWinograd(start, end); };
+        } else {
+            filter_ = workspace.Arena().Allocate<TAcc>(params_.groups * params_.GroupOcBlocks() * params_.GroupInC() *
+                                                       params_.k_h * params_.k_w * kOcBlock);
+            input_ = workspace.Arena().Allocate<TAcc>(planes * params_.plane_h * params_.plane_w);
+            PrepareDirectFilter();
+            prepare = [this](int64_t start, int64_t end) { PadInput(start, end); };
+            compute = [this](int64_t start, int64_t end) { ComputeDirect(start, end); };
+        }
+        if (!parallel) {
+            prepare(0, planes);
+            compute(0, items);
+        } else if (aicpu::CpuKernelUtils::ParallelFor(ctx, planes, 1, prepare) != 0 ||
+                   aicpu::CpuKernelUtils::ParallelFor(ctx, items, 1, compute) != 0) {
+            return -1;
+        }
+        return failed_ ? -1 : 0;
+    }
+
+private:
+    bool LoadBias(aicpu::Tensor *bias)
+    {
+        std::fill(bias_, bias_ + params_.out_c, TAcc(0));
+        if (bias == nullptr || bias->GetData() == nullptr) {
+            return true;
+        }
+        if (bias->GetTensorShape()->NumElements() != params_.out_c) {
+            return false;
+        }
+        const void *data = bias->GetData();
+        for (int64_t i = 0; i < params_.out_c; ++i) {
+            switch (bias->GetDataType()) {
+                case aicpu::DT_FLOAT:
+                    bias_[i] = static_cast<TAcc>(static_cast<const float *>(data)[i]);
+                    break;
+                case aicpu::DT_FLOAT16:
+                    bias_[i] = static_cast<TAcc>(aicpu::HalfToFloat(static_cast<const aicpu::Half *>(data)[i]));
+                    break;
+                case aicpu::DT_INT32:
+                    bias_[i] = static_cast<TAcc>(static_cast<const int32_t *>(data)[i]);
+                    break;
+                default:
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    // [group][oc block][ic][k_h][k_w][kOcBlock], channels past out_c / groups are zero
+    void PrepareDirectFilter()
+    {
+        int64_t cin = params_.GroupInC();
+        int64_t cout = params_.GroupOutC();
+        int64_t window = params_.k_h * params_.k_w;
+        int64_t block_size = cin * window * kOcBlock;
+        std::fill(filter_, filter_ + params_.groups * params_.GroupOcBlocks() * block_size, TAcc(0));
+        for (int64_t oc = 0; oc < params_.out_c; ++oc) {
+            int64_t g = oc / cout;
+            int64_t block = oc % cout / kOcBlock;
+            int64_t lane = oc % cout % kOcBlock;
+            TAcc *dst = filter_ + (g * params_.GroupOcBlocks() + block) * block_size + lane;
+            const T *src = w_ + oc * cin * window;
+            for (int64_t i = 0; i < cin * window; ++i) {
+                dst[i * kOcBlock] = aicpu::Widen(src[i]);
+            }
+        }
+    }
+
+    // [oc][ic][16]
+    void PrepareWinogradFilter()
+    {
+        int64_t filters = params_.out_c * params_.GroupInC();
+        TAcc g[9];
+        for (int64_t i = 0; i < filters; ++i) {
+            for (int64_t j = 0; j < 9; ++j) {
+                g[j] = aicpu::Widen(w_[i * 9 + j]);
+            }
+            WinogradFilterTile(g, filter_ + i * kWinogradTile);
+        }
+    }
+
+    // widen plane index of x into dst, surrounded by the pads
+    void PadPlane(int64_t index, TAcc *dst) const
+    {
+        TAcc pad_value = static_cast<TAcc>(std::is_floating_point<TAcc>::value ? 0 : params_.offset_x);
+        std::fill(dst, dst + params_.plane_h * params_.plane_w, pad_value);
+        const T *src = x_ + index * params_.in_h * params_.in_w;
+        for (int64_t h = 0; h < params_.in_h; ++h) {
+            TAcc *row = dst + (h + params_.pad_t) * params_.plane_w + params_.pad_l;
+            aicpu::Widen(src + h * params_.in_w, row, params_.in_w);
+        }
+    }
+
+    void PadInput(int64_t start, int64_t end)
+    {
+        for (int64_t index = start; index < end; ++index) {
+            PadPlane(index, input_ + index * params_.plane_h * params_.plane_w);
+        }
+    }
+
+    // [n][ic][tile][16]
+    void TransformInput(int64_t start, int64_t end)
+    {
+        aicpu::ScopedWorkspace workspace(ShardWorkspace());
+        TAcc *plane = workspace.Arena().Allocate<TAcc>(params_.plane_h * params_.plane_w);
+        if (plane == nullptr) {
+            failed_ = true;
+            return;
+        }
+        int64_t tiles_h = params_.TilesH();
+        int64_t tiles_w = params_.TilesW();
+        for (int64_t index = start; index < end; ++index) {
+            PadPlane(index, plane);
+            TAcc *dst = input_ + index * tiles_h * tiles_w * kWinogradTile;
+            for (int64_t th = 0; th < tiles_h; ++th) {
+                for (int64_t tw = 0; tw < tiles_w; ++tw) {
+                    WinogradInputTile(plane + 2 * th * params_.plane_w + 2 * tw, params_.plane_w, dst);
+                    dst += kWinogradTile;
+                }
+            }
+        }
+    }
+
+    // item is (n, group, oc block), returns the first output channel and the channel count
+    int64_t ItemChannels(int64_t item, int64_t &n, int64_t &g, int64_t &block) const
+    {
+        block = item % params_.GroupOcBlocks();
+        g = item / params_.GroupOcBlocks() % params_.groups;
+        n = item / params_.GroupOcBlocks() / params_.groups;
+        return std::min(kOcBlock, params_.GroupOutC() - block * kOcBlock);
+    }
+
+    void ComputeDirect(int64_t start, int64_t end)
+    {
+        const ConvParams &p = params_;
+        int64_t cin = p.GroupInC();
+        int64_t window = p.k_h * p.k_w;
+        // a pointwise unit-stride convolution without horizontal pads is one long row per plane
+        bool flat = p.k_h == 1 && p.k_w == 1 && p.stride_h == 1 && p.stride_w == 1 && p.plane_w == p.out_w;
+        int64_t rows = flat ? 1 : p.out_h;
+        int64_t row_len = flat ? p.out_h * p.out_w : p.out_w;
+        aicpu::ScopedWorkspace workspace(ShardWorkspace());
+        TAcc *acc = workspace.Arena().Allocate<TAcc>(kOcBlock * kRowChunk);
+        if (acc == nullptr) {
+            failed_ = true;
+            return;
+        }
+        for (int64_t item = start; item < end; ++item) {
+            int64_t n = 0;
+            int64_t g = 0;
+            int64_t block = 0;
+            int64_t channels = ItemChannels(item, n, g, block);
+            int64_t oc0 = g * p.GroupOutC() + block * kOcBlock;
+            const TAcc *filter = filter_ + (g * p.GroupOcBlocks() + block) * cin * window * kOcBlock;
+            const TAcc *planes = input_ + (n * p.in_c + g * cin) * p.plane_h * p.plane_w;
+            for (int64_t row = 0; row < rows; ++row) {
+                for (int64_t col0 = 0; col0 < row_len; col0 += kRowChunk) {
+                    int64_t len = std::min(kRowChunk, row_len - col0);
+                    for (int64_t o = 0; o < kOcBlock; ++o) {
+                        std::fill(acc + o * kRowChunk, acc + o * kRowChunk + len,
+                                  o < channels ? bias_[oc0 + o] : TAcc(0));
+                    }
+                    for (int64_t ic = 0; ic < cin; ++ic) {
+                        const TAcc *plane = planes + ic * p.plane_h * p.plane_w;
+                        for (int64_t kh = 0; kh < p.k_h; ++kh) {
+                            const TAcc *in_row = plane + (row * p.stride_h + kh * p.dilation_h) * p.plane_w +
+                                                 col0 * p.stride_w;
+                            for (int64_t kw = 0; kw < p.k_w; ++kw) {
+                                const TAcc *w = filter + ((ic * p.k_h + kh) * p.k_w + kw) * kOcBlock;
+                                const TAcc *x = in_row + kw * p.dilation_w;
+                                if (p.stride_w == 1) {
+                                    MulAddBlock(acc, kRowChunk, w, x, len);
+                                } else {
+                                    MulAddBlockStrided(acc, kRowChunk, w, x, p.stride_w, len);
+                                }
+                            }
+                        }
+                    }
+                    for (int64_t o = 0; o < channels; ++o) {
+                        TOut *dst = y_ + ((n * p.out_c + oc0 + o) * p.out_h + row) * p.out_w + col0;
+                        const TAcc *src = acc + o * kRowChunk;
+                        aicpu::Narrow(src, dst, len);
+                    }
+                }
+            }
+        }
+    }
+
+    void ComputeWinograd(int64_t start, int64_t end)
+    {
+        typedef typename aicpu::VecTraits<TAcc>::Vec Vec;
+        const int64_t lanes = aicpu::VecTraits<TAcc>::kLanes;
+        const int64_t vecs = kWinogradTile / lanes;
+        const ConvParams &p = params_;
+        int64_t cin = p.GroupInC();
+        int64_t tiles_w = p.TilesW();
+        int64_t tiles = p.TilesH() * tiles_w;
+        aicpu::ScopedWorkspace workspace(ShardWorkspace());
+        TAcc *acc = workspace.Arena().Allocate<TAcc>(kOcBlock * kTileChunk * kWinogradTile);
+        if (acc == nullptr) {
+            failed_ = true;
+            return;
+        }
+        for (int64_t item = start; item < end; ++item) {
+            int64_t n = 0;
+            int64_t g = 0;
+            int64_t block = 0;
+            int64_t channels = ItemChannels(item, n, g, block);
+            int64_t oc0 = g * p.GroupOutC() + block * kOcBlock;
+            for (int64_t t0 = 0; t0 < tiles; t0 += kTileChunk) {
+                int64_t chunk = std::min(kTileChunk, tiles - t0);
+                std::fill(acc, acc + kOcBlock * kTileChunk * kWinogradTile, TAcc(0));
+                for (int64_t ic = 0; ic < cin; ++ic) {
+                    const TAcc *v = input_ + ((n * p.in_c + g * cin + ic) * tiles + t0) * kWinogradTile;
+                    for (int64_t o = 0; o < channels; ++o) {
+                        const TAcc *u = filter_ + ((oc0 + o) * cin + ic) * kWinogradTile;
+                        TAcc *acc_o = acc + o * kTileChunk * kWinogradTile;
+                        for (int64_t j = 0; j < vecs; ++j) {
+                            Vec uv = aicpu::VecLoad<Vec>(u + j * lanes);
+                            for (int64_t t = 0; t < chunk; ++t) {
+                                TAcc *a = acc_o + t * kWinogradTile + j * lanes;
+                                aicpu::VecStore(a, aicpu::VecLoad<Vec>(a) + uv * aicpu::VecLoad<Vec>(
+                                    v + t * kWinogradTile + j * lanes));
+                            }
+                        }
+                    }
+                }
+                for (int64_t o = 0; o < channels; ++o) {
+                    TOut *dst = y_ + (n * p.out_c + oc0 + o) * p.out_h * p.out_w;
+                    for (int64_t t = 0; t < chunk; ++t) {
+                        TAcc out[2][2];
+                        WinogradOutputTile(acc + (o * kTileChunk + t) * kWinogradTile, out);
+                        int64_t h0 = (t0 + t) / tiles_w * 2;
+                        int64_t w0 = (t0 + t) % tiles_w * 2;
+                        for (int64_t r = 0; r < 2 && h0 + r < p.out_h; ++r) {
+                            for (int64_t c = 0; c < 2 && w0 + c < p.out_w; ++c) {
+                                aicpu::Narrow(out[r][c] + bias_[oc0 + o], dst + (h0 + r) * p.out_w + w0 + c);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    ConvParams params_;
+    const T *x_;
+    const T *w_;
+    TOut *y_;
+    // launch scratch, see LaunchWorkspace
+    TAcc *bias_;
+    TAcc *filter_;
+    // padded planes for the direct path, transformed tiles for Winograd
+    TAcc *input_;
+    std::atomic<bool> failed_;
+};
+
+template <typename T, typename TOut>
+uint32_t ConvCompute(const aicpu::CpuKernelContext &ctx, const ConvParams &params, aicpu::Tensor *x,
+                     aicpu::Tensor *filter, aicpu::Tensor *bias, aicpu::Tensor *y)
+{
+    ConvRunner<T, TOut> runner(params, static_cast<const T *>(x->GetData()), static_cast<const T *>(filter->GetData()),
+                               static_cast<TOut *>(y->GetData()));
+    return runner.Run(ctx, bias);
+}
+}
+
+namespace aicpu {
+uint32_t Conv2DTikCpuKernel::Compute(CpuKernelContext &ctx)
+{
+    KERNEL_TRACE_SCOPE(ctx, CONV2D_TIK);
+    Tensor *x = ctx.Input(0);
+    Tensor *filter = ctx.Input(1);
+    Tensor *y = ctx.Output(0);
+    if (x == nullptr || filter == nullptr || y == nullptr) {
+        return -1;
+    }
+    // bias is optional, offset_w is reserved and not read
+    Tensor *bias = (ctx.GetInputsSize() > 2) ? ctx.Input(2) : nullptr;
+
+    ConvParams params;
+    if (!ParseConvParams(ctx, x->GetTensorShape()->GetDimSizes(), filter->GetTensorShape()->GetDimSizes(),
+                         y->GetTensorShape()->GetDimSizes(), params)) {
+        return -1;
+    }
+    if (params.batch * params.out_c == 0) {
+        return 0;
+    }
+    if (x->GetData() == nullptr || filter->GetData() == nullptr || y->GetData() == nullptr) {
+        return -1;
+    }
+
+    DataType x_type = x->GetDataType();
+    DataType y_type = y->GetDataType();
+    if (filter->GetDataType() != x_type) {
+        return -1;
+    }
+    if (x_type == DT_FLOAT && y_type == DT_FLOAT) {
+        return ConvCompute<float, float>(ctx, params, x, filter, bias, y);
+    }
+    if (x_type == DT_FLOAT16 && y_type == DT_FLOAT16) {
+        return ConvCompute<Half, Half>(ctx, params, x, filter, bias, y);
+    }
+    if (x_type == DT_FLOAT16 && y_type == DT_FLOAT) {
+        return ConvCompute<Half, float>(ctx, params, x, filter, bias, y);
+    }
+    if (x_type == DT_INT8 && y_type == DT_INT32) {
+        return ConvCompute<int8_t, int32_t>(ctx, params, x, filter, bias, y);
+    }
+    return -1;
+}
+
+REGISTER_CPU_KERNEL(CONV2D_TIK, Conv2DTikCpuKernel);
+} // namespace aicpu
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of Conv2DTik
+ */
+
+#ifndef _AICPU_CONV2D_TIK_KERNELS_H_
+#define _AICPU_CONV2D_TIK_KERNELS_H_
+
+#include "cpu_kernel.h"
+
+namespace aicpu {
+class Conv2DTikCpuKernel : public CpuKernel {
+public:
+    ~Conv2DTikCpuKernel() = default;
+    uint32_t Compute(CpuKernelContext &ctx) override;
+};
+} // namespace aicpu
+#endif
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of DecodeBboxV2
+ *
+ * Decodes the box codes [ty, tx, th, tw] of the TF Faster R-CNN box coder
+ * against anchors [ymin, xmin, ymax, xmax] into [ymin, xmin, ymax, xmax].
+ * Both tensors are [n, 4], or [4, n] with reversed_box. Anchors are handled
+ * in chunks that are transposed into one array per coordinate, decoded a
+ * vector at a time and transposed back into the layout of the input.
+ */
+
+#include "decode_bbox_v2_kernels.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include "cpu_kernel_utils.h"
+#include "cpu_types.h"
+#include "fp16_utils.h"
+#include "kernel_trace.h"
+#include "vector_ops.h"
+#include "workspace_arena.h"
+
+namespace {
+const char *DECODE_BBOX_V2 = "DecodeBboxV2";
+const int64_t kCoords = 4;
+// anchors per chunk, the eight coordinate arrays of a chunk take 8 KB
+const int64_t kChunk = 256;
+// chunks below this count stay on the calling core
+const int64_t kMinParallelChunks = 8;
+
+struct DecodeParams {
+    int64_t num;
+    bool reversed;
+    float scales[kCoords];
+    float clip;
+};
+
+// one array per coordinate
+struct BoxChunk {
+    float c[kCoords][kChunk];
+};
+
+// [count, 4] boxes into one array per coordinate
+void Deinterleave(const float *box, int64_t count, BoxChunk &chunk)
+{
+    for (int64_t i = 0; i < count; ++i) {
+        for (int64_t k = 0; k < kCoords; ++k) {
+            chunk.c[k][i] = box[i * kCoords + k];
+        }
+    }
+}
+
+void Interleave(const BoxChunk &chunk, int64_t count, float *box)
+{
+    for (int64_t i = 0; i < count; ++i) {
+        for (int64_t k = 0; k < kCoords; ++k) {
+            box[i * kCoords + k] = chunk.c[k][i];
+        }
+    }
+}
+
+void LoadChunk(const float *src, const DecodeParams &params, int64_t start, int64_t count, BoxChunk &chunk)
+{
+    if (params.reversed) {
+        for (int64_t k = 0; k < kCoords; ++k) {
+            const float *row = src + k * params.num + start;
+            std::copy(row, row + count, chunk.c[k]);
+        }
+        return;
+    }
+    Deinterleave(src + start * kCoords, count, chunk);
+}
+
+// float16 is widened in bulk, boxes go through a float staging buffer
+void LoadChunk(const aicpu::Half *src, const DecodeParams &params, int64_t start, int64_t count, BoxChunk &chunk)
+{
+    if (params.reversed) {
+        for (int64_t k = 0; k < kCoords; ++k) {
+            aicpu::HalfToFloat(src + k * params.num + start, chunk.c[k], count);
+        }
+        return;
+    }
+    float staging[kCoords * kChunk];
+    aicpu::HalfToFloat(src + start * kCoords, staging, count * kCoords);
+    Deinterleave(staging, count, chunk);
+}
+
+void StoreChunk(float *dst, const DecodeParams &params, int64_t start, int64_t count, const BoxChunk &chunk)
+{
+    if (params.reversed) {
+        for (int64_t k = 0; k < kCoords; ++k) {
+            std::copy(chunk.c[k], chunk.c[k] + count, dst + k * params.num + start);
+        }
+        return;
+    }
+    Interleave(chunk, count, dst + start * kCoords);
+}
+
+void StoreChunk(aicpu::Half *dst, const DecodeParams &params, int64_t start, int64_t count, const BoxChunk &chunk)
+{
+    if (params.reversed) {
+        for (int64_t k = 0; k < kCoords; ++k) {
+            aicpu::FloatToHalf(chunk.c[k], dst + k * params.num + start, count);
+        }
+        return;
+    }
+    float staging[kCoords * kChunk];
+    Interleave(chunk, count, staging);
+    aicpu::FloatToHalf(staging, dst + start * kCoords, count * kCoords);
+}
+
+// codes become the decoded boxes, count is rounded up to whole vectors
+void DecodeChunk(BoxChunk &codes, const BoxChunk &anchors, const DecodeParams &params, int64_t count)
+{
+    using aicpu::VecFloat;
+    const int64_t lanes = aicpu::VecTraits<float>::kLanes;
+    VecFloat scale_y = VecFloat{} + params.scales[0];
+    VecFloat scale_x = VecFloat{} + params.scales[1];
+    VecFloat scale_h = VecFloat{} + params.scales[2];
+    VecFloat scale_w = VecFloat{} + params.scales[3];
+    VecFloat clip = VecFloat{} + params.clip;
+    bool need_clip = params.clip > 0.0f;
+    for (int64_t i = 0; i < count; i += lanes) {
+        VecFloat ymin_a = aicpu::VecLoad<VecFloat>(anchors.c[0] + i);
+        VecFloat xmin_a = aicpu::VecLoad<VecFloat>(anchors.c[1] + i);
+        VecFloat ha = aicpu::VecLoad<VecFloat>(anchors.c[2] + i) - ymin_a;
+        VecFloat wa = aicpu::VecLoad<VecFloat>(anchors.c[3] + i) - xmin_a;
+        VecFloat ycenter_a = ymin_a + ha * 0.5f;
+        VecFloat xcenter_a = xmin_a + wa * 0.5f;
+
+        // division rather than a reciprocal multiply, to match the RealDiv of the fused scope
+        VecFloat ty = aicpu::VecLoad<VecFloat>(codes.c[0] + i) / scale_y;
+        VecFloat tx = aicpu::VecLoad<VecFloat>(codes.c[1] + i) / scale_x;
+        VecFloat th = aicpu::VecLoad<VecFloat>(codes.c[2] + i) / scale_h;
+        VecFloat tw = aicpu::VecLoad<VecFloat>(codes.c[3] + i) / scale_w;
+        if (need_clip) {
+            th = th > clip ? clip : th;
+            tw = tw > clip ? clip : tw;
+        }
+        VecFloat half_h = aicpu::VecExp(th) * ha * 0.5f;
+        VecFloat half_w = aicpu::VecExp(tw) * wa * 0.5f;
+        VecFloat ycenter = ty * ha + ycenter_a;
+        VecFloat xcenter = tx * wa + xcenter_a;
+        aicpu::VecStore(codes.c[0] + i, ycenter - half_h);
+        aicpu::VecStore(codes.c[1] + i, xcenter - half_w);
+        aicpu::VecStore(codes.c[2] + i, ycenter + half_h);
+        aicpu::VecStore(codes.c[3] + i, xcenter + half_w);
+    }
+}
+
+template <typename T>
+uint32_t DecodeCompute(const aicpu::CpuKernelContext &ctx, const DecodeParams &params, const T *boxes,
+                       const T *anchors, T *y)
+{
+    int64_t chunks = (params.num + kChunk - 1) / kChunk;
+    std::atomic<bool> failed(false);
+    auto shard = [&](int64_t start, int64_t end) {
+        aicpu::ScopedWorkspace workspace(aicpu::WorkspaceBytes<BoxChunk>(2));
+        BoxChunk *buffers = workspace.Arena().Allocate<BoxChunk>(2);
+        if (buffers == nullptr) {
+            failed = true;
+            return;
+        }
+        // lanes past the last anchor of a chunk are decoded but never stored
+        std::fill(buffers, buffers + 2, BoxChunk());
+        BoxChunk &codes = buffers[0];
+        BoxChunk &anchor_chunk = buffers[1];
+        for (int64_t chunk = start; chunk < end; ++chunk) {
+            int64_t first = chunk * kChunk;
+            int64_t count = std::min(kChunk, params.num - first);
+            LoadChunk(boxes, params, first, count, codes);
+            LoadChunk(anchors, params, first, count, anchor_chunk);
+            DecodeChunk(codes, anchor_chunk, params, count);
+            StoreChunk(y, params, first, count, codes);
+        }
+    };
+    uint32_t cpu_num = aicpu::CpuKernelUtils::GetCPUNum(ctx);
+    if (cpu_num <= 1 || chunks < kMinParallelChunks) {
+        shard(0, chunks);
+    } else {
+        int64_t per_unit = std::max<int64_t>(1, (chunks + cpu_num - 1) / cpu_num);
+        if (aicpu::CpuKernelUtils::ParallelFor(ctx, chunks, per_unit, shard) != 0) {
+            return -1;
+        }
+    }
+    return failed ? -1 : 0;
+}
+}
+
+namespace aicpu {
+uint32_t DecodeBboxV2CpuKernel::Compute(CpuKernelContext &ctx)
+{
+    KERNEL_TRACE_SCOPE(ctx, DECODE_BBOX_V2);
+    Tensor *boxes = ctx.Input(0);
+    Tensor *anchors = ctx.Input(1);
+    Tensor *y = ctx.Output(0);
+    if (boxes == nullptr || anchors == nullptr || y == nullptr) {
+        return -1;
+    }
+
+    DecodeParams params;
+    for (int64_t k = 0; k < kCoords; ++k) {
+        params.scales[k] = 1.0f;
+    }
+    AttrValue *scales = ctx.GetAttr("scales");
+    if (scales != nullptr) {
+        std::vector<float> values = scales->GetListFloat();
+        if (values.size() != static_cast<size_t>(kCoords)) {
+            return -1;
+        }
+        std::copy(values.begin(), values.end(), params.scales);
+    }
+    AttrValue *clip = ctx.GetAttr("decode_clip");
+    params.clip = (clip == nullptr) ? 0.0f : clip->GetFloat();
+    AttrValue *reversed = ctx.GetAttr("reversed_box");
+    params.reversed = (reversed != nullptr) && reversed->GetBool();
+
+    int64_t elements = boxes->GetTensorShape()->NumElements();
+    if (elements % kCoords != 0 || anchors->GetTensorShape()->NumElements() != elements ||
+        y->GetTensorShape()->NumElements() != elements) {
+        return -1;
+    }
+    params.num = elements / kCoords;
+    if (params.num == 0) {
+        return 0;
+    }
+    if (boxes->GetData() == nullptr || anchors->GetData() == nullptr || y->GetData() == nullptr) {
+        return -1;
+    }
+    DataType type = boxes->GetDataType();
+    if (anchors->GetDataType() != type || y->GetDataType() != type) {
+        return -1;
+    }
+
+    switch (type) {
+        case DT_FLOAT16:
+            return DecodeCompute(ctx, params, static_cast<const Half *>(boxes->GetData()),
+                                 static_cast<const Half *>(anchors->GetData()), static_cast<Half *>(y->GetData()));
+        case DT_FLOAT:
+            return DecodeCompute(ctx, params, static_cast<const float *>(boxes->GetData()),
+                                 static_cast<const float *>(anchors->GetData()), static_cast<float *>(y->GetData()));
+        default:
+            return -1;
+    }
+}
+
+REGISTER_CPU_KERNEL(DECODE_BBOX_V2, DecodeBboxV2CpuKernel);
+} // namespace aicpu
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of DecodeBboxV2
+ */
+
+#ifndef _AICPU_DECODE_BBOX_V2_KERNELS_H_
+#define _AICPU_DECODE_BBOX_V2_KERNELS_H_
+
+#include "cpu_kernel.h"
+
+namespace aicpu {
+class DecodeBboxV2CpuKernel : public CpuKernel {
+public:
+    ~DecodeBboxV2CpuKernel() = default;
+    uint32_t Compute(CpuKernelContext &ctx) override;
+};
+} // namespace aicpu
+#endif
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of the shared elementwise kernel skeletons
+ *
+ * An elementwise op only supplies a functor whose operator() is a template
+ * over its argument type, so the same body runs on scalars and on the
+ * 128 bit vectors of vector_ops.h:
+ *
+ *     struct AddOp {
+ *         template <typename V>
+ *         V operator()(const V &a, const V &b) const { return a + b; }
+ *     };
+ *     return BinaryElementwiseCompute(ctx, AddOp(), TypeList<float, Half, int32_t>());
+ *
+ * The skeletons look up and check the tensors, dispatch on the input type,
+ * collapse the broadcast dims, run the vector loop with a scalar tail and
+ * shard the outer loop over the AI CPU cores, cutting the inner dim into
+ * chunks when there are fewer rows than cores. float16 is computed in float
+ * a block at a time, types without native lanes run the scalar loop.
+ */
+
+#ifndef _AICPU_ELEMENTWISE_UTILS_H_
+#define _AICPU_ELEMENTWISE_UTILS_H_
+
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "broadcast_utils.h"
+#include "cpu_kernel_utils.h"
+#include "cpu_types.h"
+#include "fp16_utils.h"
+#include "type_dispatch.h"
+#include "vector_ops.h"
+
+namespace aicpu {
+// each parallel shard covers at least this many output elements
+const int64_t kElementwiseShardElements = 32 * 1024;
+
+// type the functors see, float16 is computed in float
+template <typename T>
+struct ComputeType {
+    typedef T Type;
+};
+
+template <>
+struct ComputeType<Half> {
+    typedef float Type;
+};
+
+// inner loops of one contiguous run, a_scalar and b_scalar mark a broadcast input
+template <typename T, bool kNative = VecTraits<T>::kNative>
+struct ElementwiseLoop {
+    template <typename Op>
+    static void Unary(const Op &op, T *y, const T *x, int64_t n)
+    {
+        typedef typename VecTraits<T>::Vec Vec;
+        const int64_t lanes = VecTraits<T>::kLanes;
+        int64_t i = 0;
+        for (; i + lanes <= n; i += lanes) {
+            VecStore(y + i, op(VecLoad<Vec>(x + i)));
+        }
+        for (; i < n; ++i) {
+            y[i] = op(x[i]);
+        }
+    }
+
+    template <typename Op>
+    static void Binary(const Op &op, T *y, const T *a, const T *b, int64_t n, bool a_scalar, bool b_scalar)
+    {
+        typedef typename VecTraits<T>::Vec Vec;
+        const int64_t lanes = VecTraits<T>::kLanes;
+        int64_t i = 0;
+        if (a_scalar) {
+            T sa = a[0];
+            Vec va = Vec{} + sa;
+            for (; i + lanes <= n; i += lanes) {
+                VecStore(y + i, op(va, VecLoad<Vec>(b + i)));
+            }
+            for (; i < n; ++i) {
+                y[i] = op(sa, b[i]);
+            }
+        } else if (b_scalar) {
+            T sb = b[0];
+            Vec vb = Vec{} + sb;
+            for (; i + lanes <= n; i += lanes) {
+                VecStore(y + i, op(VecLoad<Vec>(a + i), vb));
+            }
+            for (; i < n; ++i) {
+                y[i] = op(a[i], sb);
+            }
+        } else {
+            for (; i + lanes <= n; i += lanes) {
+                VecStore(y + i, op(VecLoad<Vec>(a + i), VecLoad<Vec>(b + i)));
+            }
+            for (; i < n; ++i) {
+                y[i] = op(a[i], b[i]);
+            }
+        }
+    }
+};
+
+template <typename T>
+struct ElementwiseLoop<T, false> {
+    template <typename Op>
+    static void Unary(const Op &op, T *y, const T *x, int64_t n)
+    {
+        for (int64_t i = 0; i < n; ++i) {
+            y[i] = op(x[i]);
+        }
+    }
+
+    template <typename Op>
+    static void Binary(const Op &op, T *y, const T *a, const T *b, int64_t n, bool a_scalar, bool b_scalar)
+    {
+        for (int64_t i = 0; i < n; ++i) {
+            y[i] = op(a[a_scalar ? 0 : i], b[b_scalar ? 0 : i]);
+        }
+    }
+};
+
+template <>
+struct ElementwiseLoop<Half, false> {
+    template <typename Op>
+    static void Unary(const Op &op, Half *y, const Half *x, int64_t n)
+    {
+        HalfUnary(y, x, n, [&op](float *out, const float *in, int64_t len) {
+            ElementwiseLoop<float>::Unary(op, out, in, len);
+        });
+    }
+
+    template <typename Op>
+    static void Binary(const Op &op, Half *y, const Half *a, const Half *b, int64_t n, bool a_scalar,
+                       bool b_scalar)
+    {
+        float fa[kHalfBlock];
+        float fb[kHalfBlock];
+        float fy[kHalfBlock];
+        if (a_scalar) {
+            fa[0] = HalfToFloat(a[0]);
+        }
+        if (b_scalar) {
+            fb[0] = HalfToFloat(b[0]);
+        }
+        for (int64_t i = 0; i < n; i += kHalfBlock) {
+            int64_t len = (n - i < kHalfBlock) ? (n - i) : kHalfBlock;
+            if (!a_scalar) {
+                HalfToFloat(a + i, fa, len);
+            }
+            if (!b_scalar) {
+                HalfToFloat(b + i, fb, len);
+            }
+            ElementwiseLoop<float>::Binary(op, fy, fa, fb, len, a_scalar, b_scalar);
+            FloatToHalf(fy, y + i, len);
+        }
+    }
+};
+
+// runs shard(start, end) over [0, total) units of unit_elements each, in parallel when worth it
+template <typename Shard>
+uint32_t ShardElementwise(const CpuKernelContext &ctx, int64_t total, int64_t unit_elements, const Shard &shard)
+{
+    if (total * unit_elements <= kElementwiseShardElements || CpuKernelUtils::GetCPUNum(ctx) <= 1) {
+        shard(0, total);
+        return 0;
+    }
+    int64_t per_shard = (kElementwiseShardElements + unit_elements - 1) / unit_elements;
+    return CpuKernelUtils::ParallelFor(ctx, total, per_shard, shard);
+}
+
+// rows [start, end) of the broadcast loop nest, each over the inner elements [begin, finish),
+// coordinates advance like an odometer
+template <typename T, typename Op>
+void BroadcastRows(const Op &op, T *y, const T *x1, const T *x2, const std::vector<BroadcastDim> &dims,
+                   int64_t start, int64_t end, int64_t begin, int64_t finish)
+{
+    const BroadcastDim &inner = dims.back();
+    size_t outer_rank = dims.size() - 1;
+    std::vector<int64_t> coord(outer_rank, 0);
+    int64_t offset[2] = {begin * inner.stride[0], begin * inner.stride[1]};
+    int64_t rest = start;
+    for (size_t i = outer_rank; i > 0; --i) {
+        coord[i - 1] = rest % dims[i - 1].size;
+        rest /= dims[i - 1].size;
+        offset[0] += coord[i - 1] * dims[i - 1].stride[0];
+        offset[1] += coord[i - 1] * dims[i - 1].stride[1];
+    }
+
+    for (int64_t row = start; row < end; ++row) {
+        ElementwiseLoop<T>::Binary(op, y + row * inner.size + begin, x1 + offset[0], x2 + offset[1], finish - begin,
+                                   inner.stride[0] == 0, inner.stride[1] == 0);
+        for (size_t i = outer_rank; i > 0; --i) {
+            const BroadcastDim &dim = dims[i - 1];
+            offset[0] += dim.stride[0];
+            offset[1] += dim.stride[1];
+            if (++coord[i - 1] < dim.size) {
+                break;
+            }
+            offset[0] -= dim.size * dim.stride[0];
+            offset[1] -= dim.size * dim.stride[1];
+            coord[i - 1] = 0;
+        }
+    }
+}
+
+// y = op(x1, x2) over dims collapsed by CollapseBroadcastDims
+template <typename T, typename Op>
+uint32_t BinaryBroadcast(const CpuKernelContext &ctx, const Op &op, T *y, const T *x1, const T *x2,
+                         const std::vector<BroadcastDim> &dims)
+{
+    int64_t inner_size = dims.back().size;
+    int64_t rows = 1;
+    for (size_t i = 0; i + 1 < dims.size(); ++i) {
+        rows *= dims[i].size;
+    }
+    // too few rows to fill the cores, as in a same shape or scalar Add collapsed to one dim, then
+    // every row is also cut into chunks of at least kElementwiseShardElements inner elements
+    int64_t chunks = 1;
+    if (rows < static_cast<int64_t>(CpuKernelUtils::GetCPUNum(ctx))) {
+        chunks = std::max<int64_t>(1, inner_size / kElementwiseShardElements);
+    }
+    int64_t chunk_size = (inner_size + chunks - 1) / chunks;
+    auto shard = [&op, y, x1, x2, &dims, inner_size, chunks, chunk_size](int64_t start, int64_t end) {
+        if (chunks == 1) {
+            BroadcastRows(op, y, x1, x2, dims, start, end, 0, inner_size);
+            return;
+        }
+        for (int64_t unit = start; unit < end; ++unit) {
+            int64_t row = unit / chunks;
+            int64_t begin = (unit % chunks) * chunk_size;
+            BroadcastRows(op, y, x1, x2, dims, row, row + 1, begin, std::min(begin + chunk_size, inner_size));
+        }
+    };
+    return ShardElementwise(ctx, rows * chunks, chunk_size, shard);
+}
+
+template <typename Op>
+struct BinaryElementwiseRunner {
+    const CpuKernelContext &ctx;
+    const Op &op;
+    void *y;
+    const void *x1;
+    const void *x2;
+    const std::vector<BroadcastDim> &dims;
+
+    template <typename T>
+    uint32_t Run()
+    {
+        return BinaryBroadcast(ctx, op, static_cast<T *>(y), static_cast<const T *>(x1),
+                               static_cast<const T *>(x2), dims);
+    }
+};
+
+/*
+ * Compute of a kernel y = op(x1, x2), with inputs 0 and 1 broadcast to the
+ * shape of output 0 by the rules of the Add infer function. All three have
+ * the same type.
+ */
+template <typename Op, typename... Ts>
+uint32_t BinaryElementwiseCompute(CpuKernelContext &ctx, const Op &op, TypeList<Ts...> types)
+{
+    Tensor *x1_tensor = ctx.Input(0);
+    Tensor *x2_tensor = ctx.Input(1);
+    Tensor *y_tensor = ctx.Output(0);
+    if (x1_tensor == nullptr || x2_tensor == nullptr || y_tensor == nullptr) {
+        return -1;
+    }
+    DataType data_type = x1_tensor->GetDataType();
+    if (x2_tensor->GetDataType() != data_type || y_tensor->GetDataType() != data_type) {
+        return -1;
+    }
+
+    // y already carries the broadcast shape computed by the infer function
+    std::vector<BroadcastDim> dims;
+    if (!CollapseBroadcastDims(x1_tensor->GetTensorShape()->GetDimSizes(),
+                               x2_tensor->GetTensorShape()->GetDimSizes(),
+                               y_tensor->GetTensorShape()->GetDimSizes(), dims)) {
+        return -1;
+    }
+    if (y_tensor->NumElements() == 0) {
+        return 0;
+    }
+    void *x1_data = x1_tensor->GetData();
+    void *x2_data = x2_tensor->GetData();
+    void *y_data = y_tensor->GetData();
+    if (x1_data == nullptr || x2_data == nullptr || y_data == nullptr) {
+        return -1;
+    }
+    BinaryElementwiseRunner<Op> runner = {ctx, op, y_data, x1_data, x2_data, dims};
+    return DispatchType(types, data_type, runner);
+}
+} // namespace aicpu
+#endif
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of float16 storage type and conversion
+ *
+ * Bulk conversions use the native instructions where the target has them:
+ * NEON on the aarch64 device toolchain, F16C on x86 hosts built with
+ * -mf16c. Anything else, and the tail of every array, goes through the
+ * scalar conversion, which rounds the same way.
+ */
+
+#ifndef _AICPU_FP16_UTILS_H_
+#define _AICPU_FP16_UTILS_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__aarch64__)
+#include <arm_neon.h>
+#define AICPU_FP16_NEON 1
+#elif defined(__F16C__) && defined(__AVX__)
+#include <immintrin.h>
+#define AICPU_FP16_F16C 1
+#endif
+
+namespace aicpu {
+// storage of one IEEE 754 binary16 value, as laid out in a DT_FLOAT16 tensor
+struct Half {
+    uint16_t bits;
+};
+
+inline float HalfToFloat(Half value)
+{
+    uint32_t sign = static_cast<uint32_t>(value.bits & 0x8000) << 16;
+    uint32_t exponent = (value.bits >> 10) & 0x1f;
+    uint32_t mantissa = value.bits & 0x3ff;
+    uint32_t bits = 0;
+    if (exponent == 0x1f) {
+        // inf or nan
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa != 0) {
+        // subnormal, renormalize
+        exponent = 113;
+        while ((mantissa & 0x400) == 0) {
+            mantissa <<= 1;
+            --exponent;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+    } else {
+        bits = sign;
+    }
+    float result;
+    memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+// round to nearest even, overflow to inf, nan stays nan
+inline Half FloatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    uint32_t abs_bits = bits & 0x7fffffff;
+    Half result;
+    if (abs_bits >= 0x7f800000) {
+        result.bits = static_cast<uint16_t>(sign | 0x7c00 | ((abs_bits > 0x7f800000) ? 0x200 : 0));
+        return result;
+    }
+    if (abs_bits >= 0x477ff000) {
+        // rounds to a value above the largest half
+        result.bits = static_cast<uint16_t>(sign | 0x7c00);
+        return result;
+    }
+    if (abs_bits < 0x38800000) {
+        // result is subnormal or zero, shift with the implicit bit and round
+        if (abs_bits < 0x33000000) {
+            result.bits = sign;
+            return result;
+        }
+        uint32_t exponent = abs_bits >> 23;
+        uint32_t mantissa = (abs_bits & 0x7fffff) | 0x800000;
+        uint32_t shift = 126 - exponent;
+        uint32_t half_mantissa = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (half_mantissa & 1))) {
+            ++half_mantissa;
+        }
+        result.bits = static_cast<uint16_t>(sign | half_mantissa);
+        return result;
+    }
+    uint32_t rounded = abs_bits + 0xfff + ((abs_bits >> 13) & 1);
+    result.bits = static_cast<uint16_t>(sign | ((rounded - 0x38000000) >> 13));
+    return result;
+}
+
+// elements converted per step by the bulk conversions, 1 without a native path
+#if defined(AICPU_FP16_NEON) || defined(AICPU_FP16_F16C)
+const int64_t kHalfConvertLanes = 8;
+#else
+const int64_t kHalfConvertLanes = 1;
+#endif
+
+inline void HalfToFloatScalar(const Half *src, float *dst, int64_t n)
+{
+    for (int64_t i = 0; i < n; ++i) {
+        dst[i] = HalfToFloat(src[i]);
+    }
+}
+
+inline void FloatToHalfScalar(const float *src, Half *dst, int64_t n)
+{
+    for (int64_t i = 0; i < n; ++i) {
+        dst[i] = FloatToHalf(src[i]);
+    }
+}
+
+// dst[i] = float(src[i]) for i in [0, n)
+inline void HalfToFloat(const Half *src, float *dst, int64_t n)
+{
+    int64_t i = 0;
+#if defined(AICPU_FP16_NEON)
+    for (; i + 8 <= n; i += 8) {
+        float16x8_t value = vreinterpretq_f16_u16(vld1q_u16(&src[i].bits));
+        vst1q_f32(dst + i, vcvt_f32_f16(vget_low_f16(value)));
+        vst1q_f32(dst + i + 4, vcvt_high_f32_f16(value));
+    }
+#elif defined(AICPU_FP16_F16C)
+    for (; i + 8 <= n; i += 8) {
+        __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(value));
+    }
+#endif
+    HalfToFloatScalar(src + i, dst + i, n - i);
+}
+
+// dst[i] = half(src[i]) for i in [0, n), round to nearest even
+inline void FloatToHalf(const float *src, Half *dst, int64_t n)
+{
+    int64_t i = 0;
+#if defined(AICPU_FP16_NEON)
+    for (; i + 8 <= n; i += 8) {
+        float16x4_t low = vcvt_f16_f32(vld1q_f32(src + i));
+        float16x8_t value = vcvt_high_f16_f32(low, vld1q_f32(src + i + 4));
+        vst1q_u16(&dst[i].bits, vreinterpretq_u16_f16(value));
+    }
+#elif defined(AICPU_FP16_F16C)
+    for (; i + 8 <= n; i += 8) {
+        __m128i value = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), value);
+    }
+#endif
+    FloatToHalfScalar(src + i, dst + i, n - i);
+}
+} // namespace aicpu
+#endif
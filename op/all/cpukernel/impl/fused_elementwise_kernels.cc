@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of the fused elementwise chain
+ *
+ * The chain comes as a program of (opcode, a, b) triples in the ListInt
+ * attr "program". Values are numbered inputs first, then the ListFloat
+ * attr "constants", then one result per instruction; the last result is y.
+ * The program runs over kFusedBlock elements at a time, so intermediates
+ * stay in L1 and every input and the output cross memory once.
+ */
+
+#include "fused_elementwise_kernels.h"
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+#include "elementwise_utils.h"
+#include "kernel_trace.h"
+#include "workspace_arena.h"
+
+namespace {
+const char *FUSED_ELEMENTWISE = "FusedElementwise";
+
+// opcodes of the program attr, numbered as in op_proto/fused_elementwise.h
+enum FusedOpcode {
+    FUSED_ABS = 0,
+    FUSED_NEG,
+    FUSED_RELU,
+    FUSED_EXP,
+    FUSED_ADD,
+    FUSED_SUB,
+    FUSED_MUL,
+    FUSED_DIV,
+    FUSED_MAXIMUM,
+    FUSED_MINIMUM,
+    FUSED_OPCODE_END
+};
+
+const int64_t kFusedInstrFields = 3;
+// inputs, constants and instruction results together
+const int64_t kMaxFusedValues = 64;
+// elements of every value kept per step, small enough that all of them stay in L1
+const int64_t kFusedBlock = 256;
+
+struct FusedInstr {
+    int64_t opcode;
+    int64_t a;
+    int64_t b; // -1 for unary opcodes
+};
+
+struct FusedProgram {
+    int64_t num_inputs;
+    std::vector<float> constants;
+    std::vector<FusedInstr> instrs;
+
+    int64_t NumValues() const
+    {
+        return num_inputs + static_cast<int64_t>(constants.size() + instrs.size());
+    }
+};
+
+bool IsUnaryOpcode(int64_t opcode)
+{
+    return opcode < FUSED_ADD;
+}
+
+bool ParseFusedProgram(const aicpu::CpuKernelContext &ctx, FusedProgram &program)
+{
+    aicpu::AttrValue *program_attr = ctx.GetAttr("program");
+    if (program_attr == nullptr) {
+        return false;
+    }
+    std::vector<int64_t> code = program_attr->GetListInt();
+    aicpu::AttrValue *constants_attr = ctx.GetAttr("constants");
+    if (constants_attr != nullptr) {
+        program.constants = constants_attr->GetListFloat();
+    }
+    program.num_inputs = ctx.GetInputsSize();
+    if (code.empty() || code.size() % kFusedInstrFields != 0 || program.num_inputs == 0) {
+        return false;
+    }
+    for (size_t i = 0; i < code.size(); i += kFusedInstrFields) {
+        FusedInstr instr = {code[i], code[i + 1], code[i + 2]};
+        // operands only refer to values defined before the instruction
+        int64_t defined = program.num_inputs + static_cast<int64_t>(program.constants.size() + program.instrs.size());
+        bool unary = IsUnaryOpcode(instr.opcode);
+        if (instr.opcode < 0 || instr.opcode >= FUSED_OPCODE_END || instr.a < 0 || instr.a >= defined ||
+            (unary && instr.b != -1) || (!unary && (instr.b < 0 || instr.b >= defined))) {
+            return false;
+        }
+        program.instrs.push_back(instr);
+    }
+    return program.NumValues() <= kMaxFusedValues;
+}
+
+// clears the sign bit, so abs(-0) is +0 as in TF
+struct AbsOp {
+    float operator()(float x) const { return fabsf(x); }
+    double operator()(double x) const { return fabs(x); }
+    aicpu::VecFloat operator()(const aicpu::VecFloat &x) const
+    {
+        return (aicpu::VecFloat)((aicpu::VecInt32)x & 0x7fffffff);
+    }
+    aicpu::VecTraits<double>::Vec operator()(const aicpu::VecTraits<double>::Vec &x) const
+    {
+        return (aicpu::VecTraits<double>::Vec)((aicpu::VecTraits<int64_t>::Vec)x & 0x7fffffffffffffffLL);
+    }
+};
+
+struct NegOp {
+    template <typename V>
+    V operator()(const V &x) const { return -x; }
+};
+
+struct ReluOp {
+    template <typename V>
+    V operator()(const V &x) const { return x > V{} ? x : V{}; }
+};
+
+struct ExpOp {
+    float operator()(float x) const { return expf(x); }
+    double operator()(double x) const { return exp(x); }
+    aicpu::VecFloat operator()(const aicpu::VecFloat &x) const { return aicpu::VecExp(x); }
+    aicpu::VecTraits<double>::Vec operator()(const aicpu::VecTraits<double>::Vec &x) const
+    {
+        aicpu::VecTraits<double>::Vec y = x;
+        for (int64_t i = 0; i < aicpu::VecTraits<double>::kLanes; ++i) {
+            y[i] = exp(x[i]);
+        }
+        return y;
+    }
+};
+
+struct AddOp {
+    template <typename V>
+    V operator()(const V &a, const V &b) const { return a + b; }
+};
+
+struct SubOp {
+    template <typename V>
+    V operator()(const V &a, const V &b) const { return a - b; }
+};
+
+struct MulOp {
+    template <typename V>
+    V operator()(const V &a, const V &b) const { return a * b; }
+};
+
+struct DivOp {
+    template <typename V>
+    V operator()(const V &a, const V &b) const { return a / b; }
+};
+
+struct MaximumOp {
+    template <typename V>
+    V operator()(const V &a, const V &b) const { return a > b ? a : b; }
+};
+
+struct MinimumOp {
+    template <typename V>
+    V operator()(const V &a, const V &b) const { return a < b ? a : b; }
+};
+
+template <typename C>
+void ExecInstr(int64_t opcode, C *dst, const C *a, const C *b, int64_t len, bool a_scalar, bool b_scalar)
+{
+    typedef aicpu::ElementwiseLoop<C> Loop;
+    switch (opcode) {
+        case FUSED_ABS:
+            Loop::Unary(AbsOp(), dst, a, len);
+            break;
+        case FUSED_NEG:
+            Loop::Unary(NegOp(), dst, a, len);
+            break;
+        case FUSED_RELU:
+            Loop::Unary(ReluOp(), dst, a, len);
+            break;
+        case FUSED_EXP:
+            Loop::Unary(ExpOp(), dst, a, len);
+            break;
+        case FUSED_ADD:
+            Loop::Binary(AddOp(), dst, a, b, len, a_scalar, b_scalar);
+            break;
+        case FUSED_SUB:
+            Loop::Binary(SubOp(), dst, a, b, len, a_scalar, b_scalar);
+            break;
+        case FUSED_MUL:
+            Loop::Binary(MulOp(), dst, a, b, len, a_scalar, b_scalar);
+            break;
+        case FUSED_DIV:
+            Loop::Binary(DivOp(), dst, a, b, len, a_scalar, b_scalar);
+            break;
+        case FUSED_MAXIMUM:
+            Loop::Binary(MaximumOp(), dst, a, b, len, a_scalar, b_scalar);
+            break;
+        default:
+            Loop::Binary(MinimumOp(), dst, a, b, len, a_scalar, b_scalar);
+            break;
+    }
+}
+
+// inputs already in the compute type are read in place, float16 is widened into buf
+inline const float *LoadBlock(const float *src, float *, int64_t)
+{
+    return src;
+}
+
+inline const double *LoadBlock(const double *src, double *, int64_t)
+{
+    return src;
+}
+
+inline const float *LoadBlock(const aicpu::Half *src, float *buf, int64_t len)
+{
+    aicpu::HalfToFloat(src, buf, len);
+    return buf;
+}
+
+// the last instruction writes straight into y unless y needs narrowing
+inline float *BlockTarget(float *y, float *)
+{
+    return y;
+}
+
+inline double *BlockTarget(double *y, double *)
+{
+    return y;
+}
+
+inline float *BlockTarget(aicpu::Half *, float *buf)
+{
+    return buf;
+}
+
+inline void StoreBlock(const float *, float *, int64_t) {}
+
+inline void StoreBlock(const double *, double *, int64_t) {}
+
+inline void StoreBlock(const float *src, aicpu::Half *dst, int64_t len)
+{
+    aicpu::FloatToHalf(src, dst, len);
+}
+
+struct FusedRunner {
+    const aicpu::CpuKernelContext &ctx;
+    const FusedProgram &program;
+    // one element inputs broadcast over y
+    const std::vector<uint8_t> &input_scalar;
+    int64_t n;
+
+    template <typename T>
+    uint32_t Run()
+    {
+        typedef typename aicpu::ComputeType<T>::Type C;
+        const int64_t num_values = program.NumValues();
+        const int64_t first_instr = program.num_inputs + static_cast<int64_t>(program.constants.size());
+        const int64_t result = num_values - 1;
+        std::vector<const T *> inputs(program.num_inputs);
+        // values whose operands are all scalars are computed once per shard
+        std::vector<uint8_t> scalar(num_values, 1);
+        for (int64_t i = 0; i < program.num_inputs; ++i) {
+            inputs[i] = static_cast<const T *>(ctx.Input(i)->GetData());
+            scalar[i] = input_scalar[i];
+        }
+        for (size_t k = 0; k < program.instrs.size(); ++k) {
+            const FusedInstr &instr = program.instrs[k];
+            scalar[first_instr + k] = scalar[instr.a] && (instr.b < 0 || scalar[instr.b]);
+        }
+        T *y = static_cast<T *>(ctx.Output(0)->GetData());
+
+        std::atomic<bool> failed(false);
+        auto shard = [&](int64_t start, int64_t end) {
+            aicpu::ScopedWorkspace workspace(aicpu::WorkspaceBytes<C>(num_values * kFusedBlock));
+            C *buffers = workspace.Arena().Allocate<C>(num_values * kFusedBlock);
+            if (buffers == nullptr) {
+                failed = true;
+                return;
+            }
+            const C *values[kMaxFusedValues];
+            for (int64_t i = 0; i < program.num_inputs; ++i) {
+                if (scalar[i]) {
+                    values[i] = LoadBlock(inputs[i], buffers + i * kFusedBlock, 1);
+                }
+            }
+            for (size_t c = 0; c < program.constants.size(); ++c) {
+                C *value = buffers + (program.num_inputs + c) * kFusedBlock;
+                value[0] = static_cast<C>(program.constants[c]);
+                values[program.num_inputs + c] = value;
+            }
+            for (size_t k = 0; k < program.instrs.size(); ++k) {
+                const FusedInstr &instr = program.instrs[k];
+                int64_t v = first_instr + k;
+                if (scalar[v]) {
+                    C *value = buffers + v * kFusedBlock;
+                    ExecInstr(instr.opcode, value, values[instr.a], instr.b < 0 ? nullptr : values[instr.b], 1,
+                              true, true);
+                    values[v] = value;
+                }
+            }
+            if (scalar[result]) {
+                // every operand is a scalar, y is a broadcast of the single result
+                C *block = buffers + result * kFusedBlock;
+                C value = block[0];
+                for (int64_t pos = start; pos < end; pos += kFusedBlock) {
+                    int64_t len = std::min(kFusedBlock, end - pos);
+                    C *dst = BlockTarget(y + pos, block);
+                    std::fill(dst, dst + len, value);
+                    StoreBlock(dst, y + pos, len);
+                }
+                return;
+            }
+
+            for (int64_t pos = start; pos < end; pos += kFusedBlock) {
+                int64_t len = std::min(kFusedBlock, end - pos);
+                for (int64_t i = 0; i < program.num_inputs; ++i) {
+                    if (!scalar[i]) {
+                        values[i] = LoadBlock(inputs[i] + pos, buffers + i * kFusedBlock, len);
+                    }
+                }
+                for (size_t k = 0; k < program.instrs.size(); ++k) {
+                    const FusedInstr &instr = program.instrs[k];
+                    int64_t v = first_instr + k;
+                    if (scalar[v]) {
+                        continue;
+                    }
+                    C *dst = (v == result) ? BlockTarget(y + pos, buffers + v * kFusedBlock) :
+                                             buffers + v * kFusedBlock;
+                    const C *b = instr.b < 0 ? nullptr : values[instr.b];
+                    ExecInstr(instr.opcode, dst, values[instr.a], b, len, scalar[instr.a] != 0,
+                              instr.b >= 0 && scalar[instr.b]);
+                    values[v] = dst;
+                }
+                StoreBlock(values[result], y + pos, len);
+            }
+        };
+        if (aicpu::ShardElementwise(ctx, n, 1, shard) != 0) {
+            return -1;
+        }
+        return failed ? -1 : 0;
+    }
+};
+}
+
+namespace aicpu {
+uint32_t FusedElementwiseCpuKernel::Compute(CpuKernelContext &ctx)
+{
+    KERNEL_TRACE_SCOPE(ctx, FUSED_ELEMENTWISE);
+    FusedProgram program;
+    if (!ParseFusedProgram(ctx, program)) {
+        return -1;
+    }
+    Tensor *y_tensor = ctx.Output(0);
+    if (y_tensor == nullptr) {
+        return -1;
+    }
+    DataType data_type = y_tensor->GetDataType();
+    int64_t n = y_tensor->NumElements();
+    std::vector<uint8_t> input_scalar(program.num_inputs);
+    for (int64_t i = 0; i < program.num_inputs; ++i) {
+        Tensor *x_tensor = ctx.Input(i);
+        if (x_tensor == nullptr || x_tensor->GetDataType() != data_type) {
+            return -1;
+        }
+        // inputs either match y element for element or are a single broadcast element
+        int64_t elements = x_tensor->NumElements();
+        if (elements != n && elements != 1) {
+            return -1;
+        }
+        if (n != 0 && x_tensor->GetData() == nullptr) {
+            return -1;
+        }
+        input_scalar[i] = (elements == 1);
+    }
+    if (n == 0) {
+        return 0;
+    }
+    if (y_tensor->GetData() == nullptr) {
+        return -1;
+    }
+    FusedRunner runner = {ctx, program, input_scalar, n};
+    return DispatchType(TypeList<float, Half, double>(), data_type, runner);
+}
+
+REGISTER_CPU_KERNEL(FUSED_ELEMENTWISE, FusedElementwiseCpuKernel);
+} // namespace aicpu
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of the fused elementwise chain
+ */
+
+#ifndef _AICPU_FUSED_ELEMENTWISE_KERNELS_H_
+#define _AICPU_FUSED_ELEMENTWISE_KERNELS_H_
+
+#include "cpu_kernel.h"
+
+namespace aicpu {
+class FusedElementwiseCpuKernel : public CpuKernel {
+public:
+    ~FusedElementwiseCpuKernel() = default;
+    uint32_t Compute(CpuKernelContext &ctx) override;
+};
+} // namespace aicpu
+#endif
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of the packed, cache-blocked GEMM
+ *
+ * Goto style blocking: a kc x nc block of B and an mc x kc block of A are
+ * packed into panels of kNr columns and kMr rows, and a kMr x kNr register
+ * tile of C is computed from one A panel and one B panel. The B panel stays
+ * in L1 while the A block streams from L2.
+ */
+
+#include "gemm.h"
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include "accumulate_utils.h"
+#include "cpu_kernel_utils.h"
+#include "vector_ops.h"
+#include "workspace_arena.h"
+
+namespace {
+// register tile, kMr rows of two vectors each: 12 accumulators fit both NEON and SSE
+const int64_t kMr = 6;
+const int64_t kNr = 8;
+// cache blocks, a packed A block of float is 96 KB and a packed B block 256 KB
+const int64_t kMc = 96;
+const int64_t kNc = 256;
+const int64_t kKc = 256;
+// below this many multiply-adds the launch stays on the calling core
+const int64_t kMinParallelMacs = 256 * 1024;
+
+inline int64_t RoundUp(int64_t value, int64_t align) { return (value + align - 1) / align * align; }
+
+/*
+ * Pack rows [m0, m0 + mb) and depth [p0, p0 + kb) of op(A) into panels of
+ * kMr rows, laid out [panel][p][kMr]. Rows past mb are zero.
+ */
+template <typename TA, typename TAcc>
+void PackA(TAcc *dst, const TA *a, const aicpu::GemmShape &shape, int64_t m0, int64_t mb, int64_t p0, int64_t kb)
+{
+    int64_t row_stride = shape.trans_a ? 1 : shape.lda;
+    int64_t depth_stride = shape.trans_a ? shape.lda : 1;
+    for (int64_t i = 0; i < mb; i += kMr) {
+        int64_t rows = std::min(kMr, mb - i);
+        const TA *src = a + (m0 + i) * row_stride + p0 * depth_stride;
+        for (int64_t p = 0; p < kb; ++p) {
+            const TA *col = src + p * depth_stride;
+            int64_t r = 0;
+            if (row_stride == 1) {
+                aicpu::Widen(col, dst, rows);
+                r = rows;
+            }
+            for (; r < rows; ++r) {
+                dst[r] = aicpu::Widen(col[r * row_stride]);
+            }
+            for (; r < kMr; ++r) {
+                dst[r] = TAcc(0);
+            }
+            dst += kMr;
+        }
+    }
+}
+
+/*
+ * Pack depth [p0, p0 + kb) and columns [n0, n0 + nb) of op(B) into panels
+ * of kNr columns, laid out [panel][p][kNr]. Columns past nb are zero.
+ */
+template <typename TB, typename TAcc>
+void PackB(TAcc *dst, const TB *b, const aicpu::GemmShape &shape, int64_t n0, int64_t nb, int64_t p0, int64_t kb)
+{
+    int64_t col_stride = shape.trans_b ? shape.ldb : 1;
+    int64_t depth_stride = shape.trans_b ? 1 : shape.ldb;
+    for (int64_t j = 0; j < nb; j += kNr) {
+        int64_t cols = std::min(kNr, nb - j);
+        const TB *src = b + p0 * depth_stride + (n0 + j) * col_stride;
+        for (int64_t p = 0; p < kb; ++p) {
+            const TB *row = src + p * depth_stride;
+            int64_t c = 0;
+            if (col_stride == 1) {
+                aicpu::Widen(row, dst, cols);
+                c = cols;
+            }
+            for (; c < cols; ++c) {
+                dst[c] = aicpu::Widen(row[c * col_stride]);
+            }
+            for (; c < kNr; ++c) {
+                dst[c] = TAcc(0);
+            }
+            dst += kNr;
+        }
+    }
+}
+
+// c[kMr, kNr] (+)= a_panel * b_panel over depth kb, c has row stride ldc
+template <typename TAcc>
+void MicroKernel(int64_t kb, const TAcc *a, const TAcc *b, TAcc *c, int64_t ldc, bool accumulate)
+{
+    typedef typename aicpu::VecTraits<TAcc>::Vec Vec;
+    const int64_t lanes = aicpu::VecTraits<TAcc>::kLanes;
+    static_assert(kNr == 2 * (16 / sizeof(TAcc)), "kNr must be two vectors of the accumulation type");
+    Vec c00 = Vec{}, c01 = Vec{}, c10 = Vec{}, c11 = Vec{}, c20 = Vec{}, c21 = Vec{};
+    Vec c30 = Vec{}, c31 = Vec{}, c40 = Vec{}, c41 = Vec{}, c50 = Vec{}, c51 = Vec{};
+    for (int64_t p = 0; p < kb; ++p) {
+        Vec b0 = aicpu::VecLoad<Vec>(b);
+        Vec b1 = aicpu::VecLoad<Vec>(b + lanes);
+        Vec a0 = Vec{} + a[0];
+        c00 += a0 * b0;
+        c01 += a0 * b1;
+        Vec a1 = Vec{} + a[1];
+        c10 += a1 * b0;
+        c11 += a1 * b1;
+        Vec a2 = Vec{} + a[2];
+        c20 += a2 * b0;
+        c21 += a2 * b1;
+        Vec a3 = Vec{} + a[3];
+        c30 += a3 * b0;
+        c31 += a3 * b1;
+        Vec a4 = Vec{} + a[4];
+        c40 += a4 * b0;
+        c41 += a4 * b1;
+        Vec a5 = Vec{} + a[5];
+        c50 += a5 * b0;
+        c51 += a5 * b1;
+        a += kMr;
+        b += kNr;
+    }
+    Vec acc[kMr][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}, {c40, c41}, {c50, c51}};
+    for (int64_t r = 0; r < kMr; ++r) {
+        TAcc *row = c + r * ldc;
+        if (accumulate) {
+            acc[r][0] += aicpu::VecLoad<Vec>(row);
+            acc[r][1] += aicpu::VecLoad<Vec>(row + lanes);
+        }
+        aicpu::VecStore(row, acc[r][0]);
+        aicpu::VecStore(row + lanes, acc[r][1]);
+    }
+}
+
+template <typename TA, typename TB, typename TC, typename TAcc>
+class GemmDriver {
+public:
+    GemmDriver(const aicpu::GemmShape &shape, const TA *a, const TB *b, TC *c)
+        : shape_(shape), a_(a), b_(b), c_(c), mc_(kMc), nc_(kNc), failed_(false) {}
+
+    uint32_t Run(const aicpu::CpuKernelContext &ctx)
+    {
+        uint32_t cpu_num = aicpu::CpuKernelUtils::GetCPUNum(ctx);
+        bool parallel = cpu_num > 1 && shape_.m * shape_.n * shape_.k >= kMinParallelMacs;
+        if (parallel) {
+            // shrink the blocks until every core has at least one, narrowing n first keeps A reuse
+            while (BlockNum() < cpu_num && nc_ > 4 * kNr) {
+                nc_ = RoundUp(nc_ / 2, kNr);
+            }
+            while (BlockNum() < cpu_num && mc_ > 2 * kMr) {
+                mc_ = RoundUp(mc_ / 2, kMr);
+            }
+        }
+        auto shard = [this](int64_t start, int64_t end) {
+            if (!ComputeBlocks(start, end)) {
+                failed_ = true;
+            }
+        };
+        if (!parallel || BlockNum() <= 1) {
+            shard(0, BlockNum());
+        } else if (aicpu::CpuKernelUtils::ParallelFor(ctx, BlockNum(), 1, shard) != 0) {
+            return -1;
+        }
+        return failed_ ? -1 : 0;
+    }
+
+private:
+    int64_t MBlocks() const { return (shape_.m + mc_ - 1) / mc_; }
+    int64_t NBlocks() const { return (shape_.n + nc_ - 1) / nc_; }
+    int64_t BlockNum() const { return MBlocks() * NBlocks(); }
+
+    // scratch of one shard: the packed A and B blocks and the accumulators of a C block
+    uint64_t ShardWorkspace(int64_t kc) const
+    {
+        return aicpu::WorkspaceBytes<TAcc>(RoundUp(mc_, kMr) * kc) +
+               aicpu::WorkspaceBytes<TAcc>(RoundUp(nc_, kNr) * kc) +
+               aicpu::WorkspaceBytes<TAcc>(RoundUp(mc_, kMr) * RoundUp(nc_, kNr));
+    }
+
+    bool ComputeBlocks(int64_t start, int64_t end)
+    {
+        int64_t kc = std::min(kKc, std::max<int64_t>(shape_.k, 1));
+        aicpu::ScopedWorkspace workspace(ShardWorkspace(kc));
+        if (!workspace.Valid()) {
+            return false;
+        }
+        TAcc *packed_a = workspace.Arena().Allocate<TAcc>(RoundUp(mc_, kMr) * kc);
+        TAcc *packed_b = workspace.Arena().Allocate<TAcc>(RoundUp(nc_, kNr) * kc);
+        TAcc *block_c = workspace.Arena().Allocate<TAcc>(RoundUp(mc_, kMr) * RoundUp(nc_, kNr));
+        for (int64_t block = start; block < end; ++block) {
+            int64_t m0 = (block % MBlocks()) * mc_;
+            int64_t n0 = (block / MBlocks()) * nc_;
+            ComputeBlock(m0, std::min(mc_, shape_.m - m0), n0, std::min(nc_, shape_.n - n0), kc,
+                         packed_a, packed_b, block_c);
+        }
+        return true;
+    }
+
+    void ComputeBlock(int64_t m0, int64_t mb, int64_t n0, int64_t nb, int64_t kc, TAcc *packed_a, TAcc *packed_b,
+                      TAcc *block_c)
+    {
+        int64_t ldc = RoundUp(nb, kNr);
+        if (shape_.k == 0) {
+            std::fill(block_c, block_c + RoundUp(mb, kMr) * ldc, TAcc(0));
+        }
+        for (int64_t p0 = 0; p0 < shape_.k; p0 += kc) {
+            int64_t kb = std::min(kc, shape_.k - p0);
+            PackB(packed_b, b_, shape_, n0, nb, p0, kb);
+            PackA(packed_a, a_, shape_, m0, mb, p0, kb);
+            for (int64_t j = 0; j < nb; j += kNr) {
+                for (int64_t i = 0; i < mb; i += kMr) {
+                    MicroKernel(kb, packed_a + i * kb, packed_b + j * kb, block_c + i * ldc + j, ldc, p0 > 0);
+                }
+            }
+        }
+        for (int64_t i = 0; i < mb; ++i) {
+            const TAcc *src = block_c + i * ldc;
+            TC *dst = c_ + (m0 + i) * shape_.ldc + n0;
+            aicpu::Narrow(src, dst, nb);
+        }
+    }
+
+    aicpu::GemmShape shape_;
+    const TA *a_;
+    const TB *b_;
+    TC *c_;
+    int64_t mc_;
+    int64_t nc_;
+    std::atomic<bool> failed_;
+};
+
+template <typename TAcc, typename TA, typename TB, typename TC>
+uint32_t RunGemm(const aicpu::CpuKernelContext &ctx, const aicpu::GemmShape &shape, const TA *a, const TB *b, TC *c)
+{
+    if (shape.m < 0 || shape.n < 0 || shape.k < 0) {
+        return -1;
+    }
+    if (shape.m == 0 || shape.n == 0) {
+        return 0;
+    }
+    if (c == nullptr || (shape.k > 0 && (a == nullptr || b == nullptr))) {
+        return -1;
+    }
+    GemmDriver<TA, TB, TC, TAcc> driver(shape, a, b, c);
+    return driver.Run(ctx);
+}
+}
+
+namespace aicpu {
+GemmShape MakeGemmShape(int64_t m, int64_t n, int64_t k)
+{
+    GemmShape shape;
+    shape.m = m;
+    shape.n = n;
+    shape.k = k;
+    shape.lda = k;
+    shape.ldb = n;
+    shape.ldc = n;
+    shape.trans_a = false;
+    shape.trans_b = false;
+    return shape;
+}
+
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const Half *a, const Half *b, float *c)
+{
+    return RunGemm<float>(ctx, shape, a, b, c);
+}
+
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const Half *a, const Half *b, Half *c)
+{
+    return RunGemm<float>(ctx, shape, a, b, c);
+}
+
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const float *a, const float *b, float *c)
+{
+    return RunGemm<float>(ctx, shape, a, b, c);
+}
+
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const int8_t *a, const int8_t *b, int32_t *c)
+{
+    return RunGemm<int32_t>(ctx, shape, a, b, c);
+}
+
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const uint8_t *a, const int8_t *b, int32_t *c)
+{
+    return RunGemm<int32_t>(ctx, shape, a, b, c);
+}
+
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const int32_t *a, const int32_t *b, int32_t *c)
+{
+    return RunGemm<int32_t>(ctx, shape, a, b, c);
+}
+} // namespace aicpu
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of the packed, cache-blocked GEMM shared by AI CPU kernels
+ */
+
+#ifndef _AICPU_GEMM_H_
+#define _AICPU_GEMM_H_
+
+#include <stdint.h>
+#include "fp16_utils.h"
+
+namespace aicpu {
+class CpuKernelContext;
+
+/*
+ * C[m, n] = op(A)[m, k] * op(B)[k, n], all row-major. op transposes when
+ * trans_a / trans_b is set, in which case A is stored as [k, m] and B as
+ * [n, k]. lda, ldb and ldc are the row strides in elements of the stored
+ * matrices.
+ */
+struct GemmShape {
+    int64_t m;
+    int64_t n;
+    int64_t k;
+    int64_t lda;
+    int64_t ldb;
+    int64_t ldc;
+    bool trans_a;
+    bool trans_b;
+};
+
+// dense row-major shape without transposes
+GemmShape MakeGemmShape(int64_t m, int64_t n, int64_t k);
+
+/*
+ * A and B are widened into packed panels while being copied, so the
+ * micro-kernel always runs in the accumulation type: float for float16
+ * and float, int32 for the integer types. C is written once per element
+ * after the whole k loop, any dimension is accepted. Work is split over
+ * blocks of m and n with CpuKernelUtils::ParallelFor. Returns 0 on success.
+ */
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const Half *a, const Half *b, float *c);
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const Half *a, const Half *b, Half *c);
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const float *a, const float *b, float *c);
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const int8_t *a, const int8_t *b, int32_t *c);
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const uint8_t *a, const int8_t *b, int32_t *c);
+uint32_t Gemm(const CpuKernelContext &ctx, const GemmShape &shape, const int32_t *a, const int32_t *b, int32_t *c);
+} // namespace aicpu
+#endif
@@ -0,0 +1,370 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of per-launch tracing of AI CPU kernels
+ */
+
+#include "kernel_trace.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <new>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "cpu_kernel.h"
+#include "cpu_kernel_utils.h"
+
+namespace aicpu {
+// type and data size of 8 tensors
+const uint32_t kKernelTraceTensorValues = 16;
+
+// what a launch leaves in its ring, KernelTraceSnapshot turns it into a KernelTraceRecord
+struct KernelTraceLaunch {
+    const char *op_type;
+    uint64_t start_ticks;
+    uint64_t duration_ticks;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+    // FNV-1a of the values past kKernelTraceTensorValues and the dims past kKernelTraceDims
+    uint64_t overflow_hash;
+    int64_t dims[kKernelTraceDims];
+    int32_t rank;
+    uint32_t threads;
+    uint32_t value_count;
+    // per input then per output the type and the data size, kMissingTensor for both when it is missing
+    int64_t values[kKernelTraceTensorValues];
+};
+
+/*
+ * Written only by the thread of its ring, as a seqlock: odd from the
+ * start of launch index to its end, 2 * index + 2 after, so a dump
+ * running alongside drops the launches it sees in flight.
+ */
+struct KernelTraceSlot {
+    std::atomic<uint64_t> seq;
+    KernelTraceLaunch launch;
+};
+} // namespace aicpu
+
+namespace {
+const char *KERNEL_TRACE_ENV = "CUST_AICPU_KERNEL_TRACE";
+const char kKernelTraceMagic[8] = {'A', 'I', 'C', 'P', 'U', 'T', 'R', 'C'};
+const uint64_t kFnvOffset = 14695981039346656037ULL;
+const uint64_t kFnvPrime = 1099511628211ULL;
+const int64_t kMissingTensor = -1;
+// the least steady clock time the tick rate is measured over
+const uint64_t kCalibrateNs = 1000000;
+
+struct KernelTraceRing {
+    aicpu::KernelTraceSlot slots[aicpu::kKernelTraceRingSize];
+    std::atomic<uint64_t> head;
+    uint32_t thread;
+};
+
+// rings outlive their threads and the list is never destroyed, so a dump at exit still sees every launch
+std::mutex g_rings_mutex;
+std::vector<KernelTraceRing *> &Rings()
+{
+    static std::vector<KernelTraceRing *> *rings = new std::vector<KernelTraceRing *>();
+    return *rings;
+}
+thread_local KernelTraceRing *g_thread_ring = nullptr;
+
+KernelTraceRing *ThreadRing()
+{
+    if (g_thread_ring == nullptr) {
+        KernelTraceRing *ring = new (std::nothrow) KernelTraceRing();
+        if (ring == nullptr) {
+            return nullptr;
+        }
+        std::lock_guard<std::mutex> lock(g_rings_mutex);
+        ring->head = 0;
+        ring->thread = static_cast<uint32_t>(Rings().size());
+        Rings().push_back(ring);
+        g_thread_ring = ring;
+    }
+    return g_thread_ring;
+}
+
+uint64_t NowNs()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// the constant rate counter of the CPU, a fraction of the cost of the steady clock
+inline uint64_t NowTicks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return NowNs();
+#endif
+}
+
+// a steady clock time and the ticks read next to it
+struct TickBase {
+    uint64_t ns;
+    uint64_t ticks;
+};
+
+TickBase NowTickBase()
+{
+    TickBase base;
+    base.ns = NowNs();
+    base.ticks = NowTicks();
+    return base;
+}
+
+// taken when tracing is enabled, before any launch
+TickBase g_tick_base = {0, 0};
+
+// ns per tick since g_tick_base, waiting until kCalibrateNs passed
+double NsPerTick()
+{
+    TickBase now = NowTickBase();
+    while (now.ns - g_tick_base.ns < kCalibrateNs) {
+        now = NowTickBase();
+    }
+    return static_cast<double>(now.ns - g_tick_base.ns) / static_cast<double>(now.ticks - g_tick_base.ticks);
+}
+
+inline uint64_t FnvMix(uint64_t hash, uint64_t value)
+{
+    return (hash ^ value) * kFnvPrime;
+}
+
+inline void PushValue(aicpu::KernelTraceLaunch &launch, int64_t value)
+{
+    if (launch.value_count < aicpu::kKernelTraceTensorValues) {
+        launch.values[launch.value_count++] = value;
+    } else {
+        launch.overflow_hash = FnvMix(launch.overflow_hash, static_cast<uint64_t>(value));
+    }
+}
+
+// dims of other tensors are left out, fetching a shape costs as much as the rest of a tensor
+void PushTensor(aicpu::KernelTraceLaunch &launch, const aicpu::Tensor *tensor, uint64_t &bytes)
+{
+    if (tensor == nullptr) {
+        PushValue(launch, kMissingTensor);
+        PushValue(launch, kMissingTensor);
+        return;
+    }
+    uint64_t size = tensor->GetDataSize();
+    bytes += size;
+    PushValue(launch, static_cast<int64_t>(tensor->GetDataType()));
+    PushValue(launch, static_cast<int64_t>(size));
+}
+
+void PushDims(aicpu::KernelTraceLaunch &launch, const aicpu::Tensor *tensor)
+{
+    std::shared_ptr<aicpu::TensorShape> shape = (tensor == nullptr) ? nullptr : tensor->GetTensorShape();
+    launch.rank = (shape == nullptr) ? 0 : shape->GetDims();
+    for (int32_t i = 0; i < launch.rank; ++i) {
+        if (i < aicpu::kKernelTraceDims) {
+            launch.dims[i] = shape->GetDimSize(i);
+        } else {
+            launch.overflow_hash = FnvMix(launch.overflow_hash, static_cast<uint64_t>(shape->GetDimSize(i)));
+        }
+    }
+}
+
+aicpu::KernelTraceRecord ToRecord(const aicpu::KernelTraceLaunch &launch, uint32_t thread, double ns_per_tick)
+{
+    aicpu::KernelTraceRecord record;
+    memset(&record, 0, sizeof(record));
+    record.op_type = launch.op_type;
+    int64_t since_base = static_cast<int64_t>(launch.start_ticks - g_tick_base.ticks);
+    record.start_ns = g_tick_base.ns + static_cast<uint64_t>(static_cast<double>(since_base) * ns_per_tick);
+    record.duration_ns = static_cast<uint64_t>(static_cast<double>(launch.duration_ticks) * ns_per_tick);
+    record.bytes_read = launch.bytes_read;
+    record.bytes_written = launch.bytes_written;
+    uint32_t count = std::min(launch.value_count, aicpu::kKernelTraceTensorValues);
+    uint64_t hash = kFnvOffset;
+    for (uint32_t i = 0; i < count; ++i) {
+        hash = FnvMix(hash, static_cast<uint64_t>(launch.values[i]));
+    }
+    record.rank = launch.rank;
+    hash = FnvMix(hash, static_cast<uint64_t>(launch.rank));
+    for (int32_t i = 0; i < launch.rank && i < aicpu::kKernelTraceDims; ++i) {
+        record.dims[i] = launch.dims[i];
+        hash = FnvMix(hash, static_cast<uint64_t>(launch.dims[i]));
+    }
+    record.shape_signature = FnvMix(hash, launch.overflow_hash);
+    record.threads = launch.threads;
+    record.thread = thread;
+    return record;
+}
+
+void DumpAtExit()
+{
+    const char *path = getenv(KERNEL_TRACE_ENV);
+    if (path != nullptr && *path != '\0') {
+        (void)aicpu::KernelTraceDump(path);
+    }
+}
+
+bool LoadKernelTraceEnabled()
+{
+    const char *path = getenv(KERNEL_TRACE_ENV);
+    if (path == nullptr || *path == '\0') {
+        return false;
+    }
+    g_tick_base = NowTickBase();
+    atexit(DumpAtExit);
+    return true;
+}
+
+bool EndsWith(const char *str, const char *suffix)
+{
+    size_t len = strlen(str);
+    size_t suffix_len = strlen(suffix);
+    return len >= suffix_len && strcmp(str + len - suffix_len, suffix) == 0;
+}
+
+uint32_t DumpCsv(FILE *file, const std::vector<aicpu::KernelTraceRecord> &records)
+{
+    fprintf(file, "thread,op_type,start_ns,duration_ns,bytes_read,bytes_written,threads,shape_signature,dims\n");
+    for (const aicpu::KernelTraceRecord &record : records) {
+        fprintf(file, "%u,%s,%llu,%llu,%llu,%llu,%u,%016llx,", record.thread, record.op_type,
+                static_cast<unsigned long long>(record.start_ns), static_cast<unsigned long long>(record.duration_ns),
+                static_cast<unsigned long long>(record.bytes_read),
+                static_cast<unsigned long long>(record.bytes_written), record.threads,
+                static_cast<unsigned long long>(record.shape_signature));
+        // 1x3x224x224, dims past kKernelTraceDims show as "..."
+        for (int32_t i = 0; i < record.rank && i < aicpu::kKernelTraceDims; ++i) {
+            fprintf(file, i == 0 ? "%lld" : "x%lld", static_cast<long long>(record.dims[i]));
+        }
+        fprintf(file, record.rank > aicpu::kKernelTraceDims ? "x...\n" : "\n");
+    }
+    return 0;
+}
+
+uint32_t DumpBinary(FILE *file, const std::vector<aicpu::KernelTraceRecord> &records)
+{
+    uint32_t header[2] = {aicpu::kKernelTraceVersion, static_cast<uint32_t>(records.size())};
+    if (fwrite(kKernelTraceMagic, sizeof(kKernelTraceMagic), 1, file) != 1 ||
+        fwrite(header, sizeof(header), 1, file) != 1) {
+        return -1;
+    }
+    for (const aicpu::KernelTraceRecord &record : records) {
+        aicpu::KernelTraceFileRecord out;
+        memset(&out, 0, sizeof(out));
+        strncpy(out.op_type, record.op_type, aicpu::kKernelTraceOpTypeSize - 1);
+        out.start_ns = record.start_ns;
+        out.duration_ns = record.duration_ns;
+        out.bytes_read = record.bytes_read;
+        out.bytes_written = record.bytes_written;
+        out.shape_signature = record.shape_signature;
+        memcpy(out.dims, record.dims, sizeof(out.dims));
+        out.rank = record.rank;
+        out.threads = record.threads;
+        out.thread = record.thread;
+        if (fwrite(&out, sizeof(out), 1, file) != 1) {
+            return -1;
+        }
+    }
+    return 0;
+}
+}
+
+namespace aicpu {
+bool KernelTraceEnabled()
+{
+    static const bool enabled = LoadKernelTraceEnabled();
+    return enabled;
+}
+
+KernelTraceScope::KernelTraceScope(const CpuKernelContext &ctx, const char *op_type) : slot_(nullptr)
+{
+    if (!KernelTraceEnabled()) {
+        return;
+    }
+    KernelTraceRing *ring = ThreadRing();
+    if (ring == nullptr) {
+        return;
+    }
+    uint64_t index = ring->head.load(std::memory_order_relaxed);
+    slot_ = &ring->slots[index % kKernelTraceRingSize];
+    slot_->seq.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    ring->head.store(index + 1, std::memory_order_release);
+
+    KernelTraceLaunch &launch = slot_->launch;
+    launch.op_type = op_type;
+    launch.bytes_read = 0;
+    launch.bytes_written = 0;
+    launch.overflow_hash = kFnvOffset;
+    launch.value_count = 0;
+    uint32_t inputs = ctx.GetInputsSize();
+    for (uint32_t i = 0; i < inputs; ++i) {
+        PushTensor(launch, ctx.Input(i), launch.bytes_read);
+    }
+    uint32_t outputs = ctx.GetOutputsSize();
+    for (uint32_t i = 0; i < outputs; ++i) {
+        PushTensor(launch, ctx.Output(i), launch.bytes_written);
+    }
+    PushDims(launch, (inputs > 0) ? ctx.Input(0) : nullptr);
+    launch.threads = CpuKernelUtils::GetCPUNum(ctx);
+    // last, so the time spent above is not charged to the kernel
+    launch.start_ticks = NowTicks();
+}
+
+KernelTraceScope::~KernelTraceScope()
+{
+    if (slot_ == nullptr) {
+        return;
+    }
+    slot_->launch.duration_ticks = NowTicks() - slot_->launch.start_ticks;
+    slot_->seq.store(slot_->seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+std::vector<KernelTraceRecord> KernelTraceSnapshot()
+{
+    std::vector<KernelTraceRecord> records;
+    double ns_per_tick = NsPerTick();
+    std::lock_guard<std::mutex> lock(g_rings_mutex);
+    for (KernelTraceRing *ring : Rings()) {
+        uint64_t end = ring->head.load(std::memory_order_acquire);
+        uint64_t begin = (end > kKernelTraceRingSize) ? end - kKernelTraceRingSize : 0;
+        for (uint64_t index = begin; index < end; ++index) {
+            KernelTraceSlot &slot = ring->slots[index % kKernelTraceRingSize];
+            uint64_t seq = slot.seq.load(std::memory_order_acquire);
+            KernelTraceLaunch launch = slot.launch;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq == 2 * index + 2 && slot.seq.load(std::memory_order_relaxed) == seq) {
+                records.push_back(ToRecord(launch, ring->thread, ns_per_tick));
+            }
+        }
+    }
+    return records;
+}
+
+uint32_t KernelTraceDump(const char *path)
+{
+    if (path == nullptr) {
+        return -1;
+    }
+    std::vector<KernelTraceRecord> records = KernelTraceSnapshot();
+    bool csv = EndsWith(path, ".csv");
+    FILE *file = fopen(path, csv ? "w" : "wb");
+    if (file == nullptr) {
+        return -1;
+    }
+    uint32_t ret = csv ? DumpCsv(file, records) : DumpBinary(file, records);
+    if (fclose(file) != 0) {
+        return -1;
+    }
+    return ret;
+}
+} // namespace aicpu
@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of per-launch tracing of AI CPU kernels
+ *
+ * A kernel opens KERNEL_TRACE_SCOPE(ctx, op_type) first thing in Compute.
+ * Built with -DAICPU_KERNEL_TRACE and run with CUST_AICPU_KERNEL_TRACE set
+ * to a file path, every launch appends a KernelTraceRecord to a ring of
+ * the launching thread and the rings are written to that path at exit,
+ * as CSV when it ends in ".csv" and in the binary layout below otherwise.
+ * Without the define the macro expands to nothing. A launch only reads
+ * the CPU counter and copies what it records into the ring, the counter
+ * is converted to steady clock ns and the shape signature hashed when the
+ * rings are read.
+ *
+ * Binary layout, little endian: the 8 byte magic "AICPUTRC", a uint32_t
+ * version and a uint32_t record count, then the records as
+ * KernelTraceFileRecord.
+ */
+
+#ifndef _AICPU_KERNEL_TRACE_H_
+#define _AICPU_KERNEL_TRACE_H_
+
+#include <stdint.h>
+#include <vector>
+
+namespace aicpu {
+class CpuKernelContext;
+struct KernelTraceSlot;
+
+// records a thread keeps, older ones are overwritten
+const uint64_t kKernelTraceRingSize = 4096;
+// leading dims of input 0 kept in a record, the signature covers all of them
+const int32_t kKernelTraceDims = 6;
+const uint32_t kKernelTraceVersion = 1;
+const uint32_t kKernelTraceOpTypeSize = 32;
+
+struct KernelTraceRecord {
+    const char *op_type;
+    uint64_t start_ns; // steady clock
+    uint64_t duration_ns;
+    uint64_t bytes_read;    // data size of every input
+    uint64_t bytes_written; // data size of every output
+    // FNV-1a of the type and data size of every input and output and the dims of input 0,
+    // equal for launches of one shape
+    uint64_t shape_signature;
+    int64_t dims[kKernelTraceDims];
+    int32_t rank;
+    uint32_t threads; // cores CpuKernelUtils::ParallelFor may use
+    uint32_t thread;  // ring the record came from
+};
+
+struct KernelTraceFileRecord {
+    char op_type[kKernelTraceOpTypeSize];
+    uint64_t start_ns;
+    uint64_t duration_ns;
+    uint64_t bytes_read;
+    uint64_t bytes_written;
+    uint64_t shape_signature;
+    int64_t dims[kKernelTraceDims];
+    int32_t rank;
+    uint32_t threads;
+    uint32_t thread;
+    uint32_t reserved;
+};
+
+// times one launch from construction to destruction
+class KernelTraceScope {
+public:
+    KernelTraceScope(const CpuKernelContext &ctx, const char *op_type);
+    ~KernelTraceScope();
+
+private:
+    KernelTraceScope(const KernelTraceScope &) = delete;
+    KernelTraceScope &operator=(const KernelTraceScope &) = delete;
+
+    KernelTraceSlot *slot_; // null when tracing is off
+};
+
+// true when CUST_AICPU_KERNEL_TRACE is set, scopes record nothing otherwise
+bool KernelTraceEnabled();
+
+// records still held by all rings, oldest first per thread
+std::vector<KernelTraceRecord> KernelTraceSnapshot();
+
+// write KernelTraceSnapshot to path, CSV when it ends in ".csv". Returns 0 on success
+uint32_t KernelTraceDump(const char *path);
+} // namespace aicpu
+
+#ifdef AICPU_KERNEL_TRACE
+#define KERNEL_TRACE_SCOPE(ctx, op_type) aicpu::KernelTraceScope kernel_trace_scope_((ctx), (op_type))
+#else
+#define KERNEL_TRACE_SCOPE(ctx, op_type)
+#endif
+#endif
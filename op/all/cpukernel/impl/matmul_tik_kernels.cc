@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of MatmulTik
+ *
+ * Fallback for the shapes matmul_tik.py rejects: any m, k and n, any core
+ * count, batch dims broadcast as in Add. float16 accumulates in float and
+ * int8 / uint8 in int32, matching the fractal kernel; float and int32 run
+ * as themselves.
+ */
+
+#include "matmul_tik_kernels.h"
+#include <vector>
+#include "broadcast_utils.h"
+#include "cpu_types.h"
+#include "gemm.h"
+#include "kernel_trace.h"
+
+namespace {
+const char *MATMUL_TIK = "MatmulTik";
+
+bool GetBoolAttr(const aicpu::CpuKernelContext &ctx, const char *name)
+{
+    aicpu::AttrValue *attr = ctx.GetAttr(name);
+    return attr != nullptr && attr->GetBool();
+}
+
+/*
+ * One Gemm per matrix of y, the batch walked as an odometer over the
+ * collapsed broadcast dims. Their strides count whole matrices, 0 for the
+ * input shared along that dim, so a weight broadcast over the batch is
+ * read in place rather than copied out per matrix.
+ */
+template <typename TA, typename TB, typename TC>
+uint32_t MatmulCompute(const aicpu::CpuKernelContext &ctx, const aicpu::GemmShape &shape,
+                       const std::vector<aicpu::BroadcastDim> &batch, aicpu::Tensor *x1, aicpu::Tensor *x2,
+                       aicpu::Tensor *y)
+{
+    const TA *a = static_cast<const TA *>(x1->GetData());
+    const TB *b = static_cast<const TB *>(x2->GetData());
+    TC *c = static_cast<TC *>(y->GetData());
+    int64_t count = 1;
+    for (const aicpu::BroadcastDim &dim : batch) {
+        count *= dim.size;
+    }
+    if (count == 1) {
+        return aicpu::Gemm(ctx, shape, a, b, c);
+    }
+    std::vector<int64_t> index(batch.size(), 0);
+    int64_t a_matrix = 0;
+    int64_t b_matrix = 0;
+    for (int64_t i = 0; i < count; ++i) {
+        if (aicpu::Gemm(ctx, shape, a + a_matrix * shape.m * shape.k, b + b_matrix * shape.k * shape.n,
+                        c + i * shape.m * shape.n) != 0) {
+            return -1;
+        }
+        for (size_t d = batch.size(); d-- > 0;) {
+            a_matrix += batch[d].stride[0];
+            b_matrix += batch[d].stride[1];
+            if (++index[d] < batch[d].size) {
+                break;
+            }
+            a_matrix -= index[d] * batch[d].stride[0];
+            b_matrix -= index[d] * batch[d].stride[1];
+            index[d] = 0;
+        }
+    }
+    return 0;
+}
+}
+
+namespace aicpu {
+uint32_t MatmulTikCpuKernel::Compute(CpuKernelContext &ctx)
+{
+    KERNEL_TRACE_SCOPE(ctx, MATMUL_TIK);
+    Tensor *x1 = ctx.Input(0);
+    Tensor *x2 = ctx.Input(1);
+    Tensor *y = ctx.Output(0);
+    if (x1 == nullptr || x2 == nullptr || y == nullptr) {
+        return -1;
+    }
+
+    std::vector<int64_t> x1_dims = x1->GetTensorShape()->GetDimSizes();
+    std::vector<int64_t> x2_dims = x2->GetTensorShape()->GetDimSizes();
+    std::vector<int64_t> y_dims = y->GetTensorShape()->GetDimSizes();
+    if (x1_dims.size() < 2 || x2_dims.size() < 2 || y_dims.size() < 2) {
+        return -1;
+    }
+    // transposed inputs are read in place, the stored rows are [k, m] and [n, k]
+    bool transpose_x1 = GetBoolAttr(ctx, "transpose_x1");
+    bool transpose_x2 = GetBoolAttr(ctx, "transpose_x2");
+    size_t rank1 = x1_dims.size();
+    size_t rank2 = x2_dims.size();
+    size_t rank = y_dims.size();
+    GemmShape shape = MakeGemmShape(transpose_x1 ? x1_dims[rank1 - 1] : x1_dims[rank1 - 2],
+                                    transpose_x2 ? x2_dims[rank2 - 2] : x2_dims[rank2 - 1],
+                                    transpose_x1 ? x1_dims[rank1 - 2] : x1_dims[rank1 - 1]);
+    shape.trans_a = transpose_x1;
+    shape.trans_b = transpose_x2;
+    shape.lda = x1_dims[rank1 - 1];
+    shape.ldb = x2_dims[rank2 - 1];
+    int64_t k2 = transpose_x2 ? x2_dims[rank2 - 1] : x2_dims[rank2 - 2];
+    if (k2 != shape.k || y_dims[rank - 2] != shape.m || y_dims[rank - 1] != shape.n) {
+        return -1;
+    }
+    std::vector<BroadcastDim> batch;
+    if (!CollapseBroadcastDims(std::vector<int64_t>(x1_dims.begin(), x1_dims.end() - 2),
+                               std::vector<int64_t>(x2_dims.begin(), x2_dims.end() - 2),
+                               std::vector<int64_t>(y_dims.begin(), y_dims.end() - 2), batch)) {
+        return -1;
+    }
+
+    // Gemm rejects missing buffers unless the product is empty
+    DataType a_type = x1->GetDataType();
+    DataType b_type = x2->GetDataType();
+    DataType c_type = y->GetDataType();
+    if (a_type == DT_FLOAT16 && b_type == DT_FLOAT16 && c_type == DT_FLOAT) {
+        return MatmulCompute<Half, Half, float>(ctx, shape, batch, x1, x2, y);
+    }
+    if (a_type == DT_FLOAT16 && b_type == DT_FLOAT16 && c_type == DT_FLOAT16) {
+        return MatmulCompute<Half, Half, Half>(ctx, shape, batch, x1, x2, y);
+    }
+    if (a_type == DT_FLOAT && b_type == DT_FLOAT && c_type == DT_FLOAT) {
+        return MatmulCompute<float, float, float>(ctx, shape, batch, x1, x2, y);
+    }
+    if (a_type == DT_INT8 && b_type == DT_INT8 && c_type == DT_INT32) {
+        return MatmulCompute<int8_t, int8_t, int32_t>(ctx, shape, batch, x1, x2, y);
+    }
+    if (a_type == DT_UINT8 && b_type == DT_INT8 && c_type == DT_INT32) {
+        return MatmulCompute<uint8_t, int8_t, int32_t>(ctx, shape, batch, x1, x2, y);
+    }
+    if (a_type == DT_INT32 && b_type == DT_INT32 && c_type == DT_INT32) {
+        return MatmulCompute<int32_t, int32_t, int32_t>(ctx, shape, batch, x1, x2, y);
+    }
+    return -1;
+}
+
+REGISTER_CPU_KERNEL(MATMUL_TIK, MatmulTikCpuKernel);
+} // namespace aicpu
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of MatmulTik
+ */
+
+#ifndef _AICPU_MATMUL_TIK_KERNELS_H_
+#define _AICPU_MATMUL_TIK_KERNELS_H_
+
+#include "cpu_kernel.h"
+
+namespace aicpu {
+class MatmulTikCpuKernel : public CpuKernel {
+public:
+    ~MatmulTikCpuKernel() = default;
+    uint32_t Compute(CpuKernelContext &ctx) override;
+};
+} // namespace aicpu
+#endif
@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of sharded multi-core memory copy
+ */
+
+#include "parallel_copy.h"
+#include <stdlib.h>
+#include "cpu_kernel_utils.h"
+
+namespace {
+const char *PARALLEL_COPY_THRESHOLD_ENV = "CUST_AICPU_PARALLEL_COPY_THRESHOLD";
+
+uint64_t LoadParallelCopyThreshold()
+{
+    const char *value = getenv(PARALLEL_COPY_THRESHOLD_ENV);
+    if (value == nullptr || *value == '\0') {
+        return aicpu::kDefaultParallelCopyThreshold;
+    }
+    char *end = nullptr;
+    unsigned long long threshold = strtoull(value, &end, 10);
+    if (end == value || *end != '\0') {
+        return aicpu::kDefaultParallelCopyThreshold;
+    }
+    return static_cast<uint64_t>(threshold);
+}
+}
+
+namespace aicpu {
+uint64_t ParallelCopyThreshold()
+{
+    static const uint64_t threshold = LoadParallelCopyThreshold();
+    return threshold;
+}
+
+uint32_t ParallelCopy(const CpuKernelContext &ctx, void *dst, const void *src, uint64_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+    if (dst == nullptr || src == nullptr) {
+        return -1;
+    }
+
+    uint32_t cpu_num = CpuKernelUtils::GetCPUNum(ctx);
+    if (size <= ParallelCopyThreshold() || cpu_num <= 1) {
+        memcpy(dst, src, size);
+        return 0;
+    }
+
+    CopyShardPlan plan = PlanCopyShards(dst, size, cpu_num);
+    if (plan.shard_num <= 1) {
+        memcpy(dst, src, size);
+        return 0;
+    }
+    auto shard_copy = [dst, src, size, &plan](int64_t start, int64_t end) {
+        for (int64_t i = start; i < end; ++i) {
+            CopyShard(dst, src, size, plan, i);
+        }
+    };
+    if (CpuKernelUtils::ParallelFor(ctx, plan.shard_num, 1, shard_copy) != 0) {
+        // shards are idempotent, so redoing the whole copy is always safe
+        memcpy(dst, src, size);
+    }
+    return 0;
+}
+} // namespace aicpu
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of sharded multi-core memory copy
+ */
+
+#ifndef _AICPU_PARALLEL_COPY_H_
+#define _AICPU_PARALLEL_COPY_H_
+
+#include <stdint.h>
+#include <string.h>
+
+namespace aicpu {
+class CpuKernelContext;
+
+// copies smaller than this stay on the calling core, see ParallelCopyThreshold
+const uint64_t kDefaultParallelCopyThreshold = 4 * 1024 * 1024;
+const uint64_t kCopyCacheLineSize = 64;
+// a shard is never smaller than this, so each core gets a worthwhile burst
+const uint64_t kMinCopyShardSize = 256 * 1024;
+
+struct CopyShardPlan {
+    uint64_t head;       // bytes before the first cache line boundary of dst
+    uint64_t shard_size; // multiple of kCopyCacheLineSize
+    int64_t shard_num;
+};
+
+/*
+ * Split a copy of size bytes into at most max_shards shards. Every shard but
+ * the first starts on a cache line boundary of dst, so no two cores ever
+ * write the same line.
+ */
+inline CopyShardPlan PlanCopyShards(const void *dst, uint64_t size, uint32_t max_shards)
+{
+    CopyShardPlan plan;
+    uint64_t misalign = reinterpret_cast<uintptr_t>(dst) % kCopyCacheLineSize;
+    plan.head = (misalign == 0) ? 0 : (kCopyCacheLineSize - misalign);
+    if (plan.head > size) {
+        plan.head = size;
+    }
+    uint64_t body = size - plan.head;
+    uint64_t shards = (max_shards == 0) ? 1 : max_shards;
+    uint64_t shard_size = (body + shards - 1) / shards;
+    shard_size = (shard_size + kCopyCacheLineSize - 1) / kCopyCacheLineSize * kCopyCacheLineSize;
+    if (shard_size < kMinCopyShardSize) {
+        shard_size = kMinCopyShardSize;
+    }
+    plan.shard_size = shard_size;
+    plan.shard_num = (body == 0) ? 1 : static_cast<int64_t>((body + shard_size - 1) / shard_size);
+    return plan;
+}
+
+// copy shard index of plan, the first shard also carries the unaligned head
+inline void CopyShard(void *dst, const void *src, uint64_t size, const CopyShardPlan &plan, int64_t index)
+{
+    uint64_t start = (index == 0) ? 0 : plan.head + static_cast<uint64_t>(index) * plan.shard_size;
+    uint64_t end = plan.head + static_cast<uint64_t>(index + 1) * plan.shard_size;
+    if (end > size) {
+        end = size;
+    }
+    if (start >= end) {
+        return;
+    }
+    memcpy(static_cast<uint8_t *>(dst) + start, static_cast<const uint8_t *>(src) + start, end - start);
+}
+
+/*
+ * Size in bytes above which ParallelCopy shards the copy. Defaults to
+ * kDefaultParallelCopyThreshold and can be overridden through the
+ * CUST_AICPU_PARALLEL_COPY_THRESHOLD environment variable.
+ */
+uint64_t ParallelCopyThreshold();
+
+/*
+ * Copy size bytes from src to dst. Copies above ParallelCopyThreshold are
+ * spread over the AI CPU cores with CpuKernelUtils::ParallelFor, smaller
+ * ones are a single memcpy. Returns 0 on success.
+ */
+uint32_t ParallelCopy(const CpuKernelContext &ctx, void *dst, const void *src, uint64_t size);
+} // namespace aicpu
+#endif
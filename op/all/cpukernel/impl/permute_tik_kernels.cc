@@ -0,0 +1,341 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of PermuteTik
+ */
+
+#include "permute_tik_kernels.h"
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "cpu_kernel_utils.h"
+#include "cpu_types.h"
+#include "kernel_trace.h"
+#include "parallel_copy.h"
+
+namespace {
+const char *PERMUTE_TIK = "PermuteTik";
+// a tile of input and its transposed output together stay well inside a 32 KB L1
+const int64_t kTileBytes = 8 * 1024;
+const int64_t kMinShardBytes = 64 * 1024;
+
+struct Element16 {
+    uint64_t value[2];
+};
+
+// one output axis: its extent and the element strides it steps in input and output
+struct PermuteDim {
+    int64_t size;
+    int64_t in_stride;
+    int64_t out_stride;
+};
+
+/*
+ * Drop size 1 axes and merge input axes that stay adjacent and in order in
+ * the output, then describe every output axis. A [n, c, h, w] -> [n, h, w, c]
+ * permute, for example, becomes the 2D transpose [n, c, h*w] -> [n, h*w, c].
+ */
+bool BuildPermuteDims(const std::vector<int64_t> &in_dims, const std::vector<int64_t> &order,
+                      std::vector<PermuteDim> &dims)
+{
+    size_t rank = in_dims.size();
+    if (order.size() != rank) {
+        return false;
+    }
+    std::vector<bool> seen(rank, false);
+    for (int64_t axis : order) {
+        if (axis < 0 || axis >= static_cast<int64_t>(rank) || seen[axis]) {
+            return false;
+        }
+        seen[axis] = true;
+    }
+
+    // groups[g] lists the input axes merged into output group g, in order
+    std::vector<std::vector<int64_t>> groups;
+    for (int64_t axis : order) {
+        if (in_dims[axis] == 1) {
+            continue;
+        }
+        if (!groups.empty() && groups.back().back() < axis) {
+            // merge only if every axis between the two is size 1
+            bool adjacent = true;
+            for (int64_t k = groups.back().back() + 1; k < axis; ++k) {
+                adjacent = adjacent && (in_dims[k] == 1);
+            }
+            if (adjacent) {
+                groups.back().push_back(axis);
+                continue;
+            }
+        }
+        groups.push_back(std::vector<int64_t>(1, axis));
+    }
+
+    // merged input dims in input order give the input strides
+    std::vector<size_t> by_input(groups.size());
+    for (size_t g = 0; g < groups.size(); ++g) {
+        by_input[g] = g;
+    }
+    std::sort(by_input.begin(), by_input.end(),
+              [&groups](size_t a, size_t b) { return groups[a].front() < groups[b].front(); });
+    dims.assign(groups.size(), PermuteDim());
+    int64_t stride = 1;
+    for (size_t i = by_input.size(); i > 0; --i) {
+        PermuteDim &dim = dims[by_input[i - 1]];
+        dim.size = 1;
+        for (int64_t axis : groups[by_input[i - 1]]) {
+            dim.size *= in_dims[axis];
+        }
+        dim.in_stride = stride;
+        stride *= dim.size;
+    }
+    stride = 1;
+    for (size_t i = dims.size(); i > 0; --i) {
+        dims[i - 1].out_stride = stride;
+        stride *= dims[i - 1].size;
+    }
+    return true;
+}
+
+// odometer over the outer axes, yields the input and output offset of each step
+class OuterIndex {
+public:
+    OuterIndex(const std::vector<PermuteDim> &dims, int64_t start) : dims_(dims), coord_(dims.size(), 0)
+    {
+        for (size_t i = dims_.size(); i > 0; --i) {
+            coord_[i - 1] = start % dims_[i - 1].size;
+            start /= dims_[i - 1].size;
+            in_offset_ += coord_[i - 1] * dims_[i - 1].in_stride;
+            out_offset_ += coord_[i - 1] * dims_[i - 1].out_stride;
+        }
+    }
+
+    void Next()
+    {
+        for (size_t i = dims_.size(); i > 0; --i) {
+            const PermuteDim &dim = dims_[i - 1];
+            in_offset_ += dim.in_stride;
+            out_offset_ += dim.out_stride;
+            if (++coord_[i - 1] < dim.size) {
+                return;
+            }
+            in_offset_ -= dim.size * dim.in_stride;
+            out_offset_ -= dim.size * dim.out_stride;
+            coord_[i - 1] = 0;
+        }
+    }
+
+    int64_t InOffset() const { return in_offset_; }
+    int64_t OutOffset() const { return out_offset_; }
+
+private:
+    const std::vector<PermuteDim> &dims_;
+    std::vector<int64_t> coord_;
+    int64_t in_offset_ = 0;
+    int64_t out_offset_ = 0;
+};
+
+/*
+ * Output innermost axis a reads input with stride a.in_stride, input innermost
+ * axis b is written with stride b.out_stride. A tile x tile block of both
+ * stays in L1 while input rows are read along b and output rows filled
+ * along a.
+ */
+template <typename T>
+void TransposeTile(T *y, const T *x, const PermuteDim &a, const PermuteDim &b, int64_t a_begin, int64_t a_end,
+                   int64_t b_begin, int64_t b_end)
+{
+    int64_t i = a_begin;
+    // four input rows at a time, so every output write covers four adjacent elements
+    for (; i + 4 <= a_end; i += 4) {
+        const T *src0 = x + i * a.in_stride;
+        const T *src1 = src0 + a.in_stride;
+        const T *src2 = src1 + a.in_stride;
+        const T *src3 = src2 + a.in_stride;
+        T *dst = y + i;
+        for (int64_t j = b_begin; j < b_end; ++j) {
+            T *out = dst + j * b.out_stride;
+            out[0] = src0[j];
+            out[1] = src1[j];
+            out[2] = src2[j];
+            out[3] = src3[j];
+        }
+    }
+    for (; i < a_end; ++i) {
+        const T *src = x + i * a.in_stride;
+        T *dst = y + i;
+        for (int64_t j = b_begin; j < b_end; ++j) {
+            dst[j * b.out_stride] = src[j];
+        }
+    }
+}
+
+template <typename T>
+uint32_t PermuteTranspose(const aicpu::CpuKernelContext &ctx, T *y, const T *x, const std::vector<PermuteDim> &dims)
+{
+    const PermuteDim &a = dims.back();
+    size_t b_index = 0;
+    std::vector<PermuteDim> outer;
+    for (size_t i = 0; i + 1 < dims.size(); ++i) {
+        if (dims[i].in_stride == 1) {
+            b_index = i;
+        } else {
+            outer.push_back(dims[i]);
+        }
+    }
+    const PermuteDim &b = dims[b_index];
+    int64_t tile = 1;
+    while (tile * tile * 2 * static_cast<int64_t>(sizeof(T)) < kTileBytes) {
+        tile *= 2;
+    }
+    int64_t outer_num = 1;
+    for (const PermuteDim &dim : outer) {
+        outer_num *= dim.size;
+    }
+    int64_t b_tiles = (b.size + tile - 1) / tile;
+
+    // a unit is one b tile row of one outer step, covering all of axis a
+    auto shard = [&](int64_t start, int64_t end) {
+        OuterIndex index(outer, start / b_tiles);
+        int64_t outer_step = start / b_tiles;
+        for (int64_t unit = start; unit < end; ++unit) {
+            if (unit / b_tiles != outer_step) {
+                index.Next();
+                outer_step = unit / b_tiles;
+            }
+            int64_t b_begin = (unit % b_tiles) * tile;
+            int64_t b_end = std::min(b.size, b_begin + tile);
+            for (int64_t a_begin = 0; a_begin < a.size; a_begin += tile) {
+                TransposeTile(y + index.OutOffset(), x + index.InOffset(), a, b, a_begin,
+                    std::min(a.size, a_begin + tile), b_begin, b_end);
+            }
+        }
+    };
+    int64_t units = outer_num * b_tiles;
+    int64_t unit_bytes = tile * a.size * static_cast<int64_t>(sizeof(T));
+    if (aicpu::CpuKernelUtils::GetCPUNum(ctx) <= 1 || units * unit_bytes <= kMinShardBytes) {
+        shard(0, units);
+        return 0;
+    }
+    return aicpu::CpuKernelUtils::ParallelFor(ctx, units, std::max<int64_t>(1, kMinShardBytes / unit_bytes), shard);
+}
+
+// the input innermost axis stays innermost, so whole rows move with memcpy
+uint32_t PermuteRows(const aicpu::CpuKernelContext &ctx, uint8_t *y, const uint8_t *x,
+                     const std::vector<PermuteDim> &dims, int64_t elem_size)
+{
+    std::vector<PermuteDim> outer(dims.begin(), dims.end() - 1);
+    int64_t row_bytes = dims.back().size * elem_size;
+    int64_t rows = 1;
+    for (const PermuteDim &dim : outer) {
+        rows *= dim.size;
+    }
+    auto shard = [&](int64_t start, int64_t end) {
+        OuterIndex index(outer, start);
+        for (int64_t row = start; row < end; ++row) {
+            memcpy(y + index.OutOffset() * elem_size, x + index.InOffset() * elem_size, row_bytes);
+            index.Next();
+        }
+    };
+    if (aicpu::CpuKernelUtils::GetCPUNum(ctx) <= 1 || rows * row_bytes <= kMinShardBytes) {
+        shard(0, rows);
+        return 0;
+    }
+    return aicpu::CpuKernelUtils::ParallelFor(ctx, rows, std::max<int64_t>(1, kMinShardBytes / row_bytes), shard);
+}
+
+int64_t ElementSize(aicpu::DataType type)
+{
+    switch (type) {
+        case aicpu::DT_BOOL:
+        case aicpu::DT_INT8:
+        case aicpu::DT_UINT8:
+            return 1;
+        case aicpu::DT_FLOAT16:
+        case aicpu::DT_INT16:
+        case aicpu::DT_UINT16:
+            return 2;
+        case aicpu::DT_FLOAT:
+        case aicpu::DT_INT32:
+        case aicpu::DT_UINT32:
+            return 4;
+        case aicpu::DT_INT64:
+        case aicpu::DT_UINT64:
+        case aicpu::DT_DOUBLE:
+        case aicpu::DT_COMPLEX64:
+            return 8;
+        case aicpu::DT_COMPLEX128:
+            return 16;
+        default:
+            return 0;
+    }
+}
+}
+
+namespace aicpu {
+uint32_t PermuteTikCpuKernel::Compute(CpuKernelContext &ctx)
+{
+    KERNEL_TRACE_SCOPE(ctx, PERMUTE_TIK);
+    Tensor *x_tensor = ctx.Input(0);
+    Tensor *y_tensor = ctx.Output(0);
+    if (x_tensor == nullptr || y_tensor == nullptr) {
+        return -1;
+    }
+    int64_t elem_size = ElementSize(x_tensor->GetDataType());
+    if (elem_size == 0 || y_tensor->GetDataType() != x_tensor->GetDataType()) {
+        return -1;
+    }
+
+    // same completion of a partial order as PermuteTikInferShape
+    std::vector<int64_t> in_dims = x_tensor->GetTensorShape()->GetDimSizes();
+    std::vector<int64_t> order;
+    AttrValue *order_attr = ctx.GetAttr("order");
+    if (order_attr != nullptr) {
+        order = order_attr->GetListInt();
+    }
+    for (int64_t i = 0; i < static_cast<int64_t>(in_dims.size()); ++i) {
+        if (std::find(order.begin(), order.end(), i) == order.end()) {
+            order.push_back(i);
+        }
+    }
+    std::vector<PermuteDim> dims;
+    if (!BuildPermuteDims(in_dims, order, dims)) {
+        return -1;
+    }
+
+    uint64_t data_size = static_cast<uint64_t>(x_tensor->NumElements() * elem_size);
+    if (data_size == 0) {
+        return 0;
+    }
+    void *x_data = x_tensor->GetData();
+    void *y_data = y_tensor->GetData();
+    if (x_data == nullptr || y_data == nullptr || y_tensor->GetDataSize() < data_size) {
+        return -1;
+    }
+
+    // order is the identity once merged, the bytes do not move
+    if (dims.size() <= 1) {
+        return ParallelCopy(ctx, y_data, x_data, data_size);
+    }
+    if (dims.back().in_stride == 1) {
+        return PermuteRows(ctx, static_cast<uint8_t *>(y_data), static_cast<const uint8_t *>(x_data), dims,
+            elem_size);
+    }
+    switch (elem_size) {
+        case 1:
+            return PermuteTranspose(ctx, static_cast<uint8_t *>(y_data), static_cast<const uint8_t *>(x_data), dims);
+        case 2:
+            return PermuteTranspose(ctx, static_cast<uint16_t *>(y_data), static_cast<const uint16_t *>(x_data),
+                dims);
+        case 4:
+            return PermuteTranspose(ctx, static_cast<uint32_t *>(y_data), static_cast<const uint32_t *>(x_data),
+                dims);
+        case 8:
+            return PermuteTranspose(ctx, static_cast<uint64_t *>(y_data), static_cast<const uint64_t *>(x_data),
+                dims);
+        default:
+            return PermuteTranspose(ctx, static_cast<Element16 *>(y_data), static_cast<const Element16 *>(x_data),
+                dims);
+    }
+}
+
+REGISTER_CPU_KERNEL(PERMUTE_TIK, PermuteTikCpuKernel);
+} // namespace aicpu
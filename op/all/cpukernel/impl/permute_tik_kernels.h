@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of PermuteTik
+ */
+
+#ifndef _AICPU_PERMUTE_TIK_KERNELS_H_
+#define _AICPU_PERMUTE_TIK_KERNELS_H_
+
+#include "cpu_kernel.h"
+
+namespace aicpu {
+class PermuteTikCpuKernel : public CpuKernel {
+public:
+    ~PermuteTikCpuKernel() = default;
+    uint32_t Compute(CpuKernelContext &ctx) override;
+};
+} // namespace aicpu
+#endif
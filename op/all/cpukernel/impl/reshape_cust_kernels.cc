@@ -5,15 +5,243 @@
 
 #include "reshape_cust_kernels.h"
 #include <string.h>
+#include <vector>
+#include "cpu_kernel_utils.h"
 #include "cpu_types.h"
+#include "kernel_trace.h"
+#include "parallel_copy.h"
 
 namespace {
 const char *RESHAPE_CUST = "ReshapeCust";
+const int64_t kMaxViewDims = 8;
+
+// bytes of one element of the types ReshapeCust is registered for, 0 for the others
+int64_t ElementBytes(aicpu::DataType type)
+{
+    switch (type) {
+        case aicpu::DT_BOOL:
+        case aicpu::DT_INT8:
+        case aicpu::DT_UINT8:
+        case aicpu::DT_QINT8:
+        case aicpu::DT_QUINT8:
+            return 1;
+        case aicpu::DT_FLOAT16:
+        case aicpu::DT_INT16:
+        case aicpu::DT_UINT16:
+        case aicpu::DT_QINT16:
+        case aicpu::DT_QUINT16:
+            return 2;
+        case aicpu::DT_FLOAT:
+        case aicpu::DT_INT32:
+        case aicpu::DT_UINT32:
+        case aicpu::DT_QINT32:
+            return 4;
+        case aicpu::DT_INT64:
+        case aicpu::DT_UINT64:
+        case aicpu::DT_DOUBLE:
+        case aicpu::DT_COMPLEX64:
+            return 8;
+        case aicpu::DT_COMPLEX128:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+/*
+ * Element strides of the input over its buffer, outermost first. Dims of
+ * size 1 are dropped and a dim laid out right after its inner neighbour is
+ * merged into it, so a dense view, whatever its offset, has rank 0 or a
+ * single dim of stride 1.
+ */
+struct StridedView {
+    int64_t offset;
+    int64_t rank;
+    int64_t dims[kMaxViewDims];
+    int64_t strides[kMaxViewDims];
+};
+
+bool BuildStridedView(const std::vector<int64_t> &dims, const std::vector<int64_t> &strides, int64_t offset,
+                      StridedView &view)
+{
+    if (dims.size() != strides.size() || offset < 0) {
+        return false;
+    }
+    int64_t rank = 0;
+    int64_t inner_dims[kMaxViewDims];
+    int64_t inner_strides[kMaxViewDims];
+    for (size_t i = dims.size(); i-- > 0;) {
+        if (dims[i] < 0 || strides[i] < 0) {
+            return false;
+        }
+        if (dims[i] == 1) {
+            continue;
+        }
+        if (rank > 0 && strides[i] == inner_strides[rank - 1] * inner_dims[rank - 1]) {
+            inner_dims[rank - 1] *= dims[i];
+            continue;
+        }
+        if (rank == kMaxViewDims) {
+            return false;
+        }
+        inner_dims[rank] = dims[i];
+        inner_strides[rank] = strides[i];
+        ++rank;
+    }
+    view.offset = offset;
+    view.rank = rank;
+    for (int64_t i = 0; i < rank; ++i) {
+        view.dims[i] = inner_dims[rank - 1 - i];
+        view.strides[i] = inner_strides[rank - 1 - i];
+    }
+    return true;
+}
+
+bool IsDense(const StridedView &view)
+{
+    return view.rank == 0 || (view.rank == 1 && view.strides[0] == 1);
+}
+
+// one past the last element the view reads, the input buffer has to hold this many
+int64_t ViewExtent(const StridedView &view)
+{
+    int64_t last = view.offset;
+    for (int64_t i = 0; i < view.rank; ++i) {
+        last += (view.dims[i] - 1) * view.strides[i];
+    }
+    return last + 1;
+}
+
+template <int64_t kBytes>
+struct ElementOf {
+    uint8_t bytes[kBytes];
+};
+
+/*
+ * band rows of n elements each, row r of src starting row_stride elements
+ * after row r - 1 and its elements stride apart, to dense dst. A band of
+ * one is a plain strided row. When the rows are closer together than the
+ * elements, as in a transposed view, the band goes in band x band tiles:
+ * the band src lines a tile reads stay cached while it writes its dst
+ * lines one after the other, so no line is fetched twice.
+ */
+template <typename T>
+void GatherBand(uint8_t *dst, const uint8_t *src, int64_t band, int64_t row_stride, int64_t n, int64_t stride)
+{
+    T *out = reinterpret_cast<T *>(dst);
+    const T *in = reinterpret_cast<const T *>(src);
+    if (band == 1) {
+        for (int64_t i = 0; i < n; ++i) {
+            out[i] = in[i * stride];
+        }
+        return;
+    }
+    for (int64_t i0 = 0; i0 < n; i0 += band) {
+        int64_t i1 = (n - i0 < band) ? n : i0 + band;
+        for (int64_t r = 0; r < band; ++r) {
+            for (int64_t i = i0; i < i1; ++i) {
+                out[r * n + i] = in[r * row_stride + i * stride];
+            }
+        }
+    }
+}
+
+// typed copies, so the compiler moves whole elements
+void GatherBand(uint8_t *dst, const uint8_t *src, int64_t band, int64_t row_stride, int64_t n, int64_t stride,
+                int64_t element_bytes)
+{
+    switch (element_bytes) {
+        case 1:
+            GatherBand<uint8_t>(dst, src, band, row_stride, n, stride);
+            break;
+        case 2:
+            GatherBand<uint16_t>(dst, src, band, row_stride, n, stride);
+            break;
+        case 4:
+            GatherBand<uint32_t>(dst, src, band, row_stride, n, stride);
+            break;
+        case 8:
+            GatherBand<uint64_t>(dst, src, band, row_stride, n, stride);
+            break;
+        default:
+            GatherBand<ElementOf<16>>(dst, src, band, row_stride, n, stride);
+            break;
+    }
+}
+
+/*
+ * Gather the view into dense dst in one pass: rows are the innermost dim
+ * and the outer dims are walked as an odometer, so no row divides its
+ * index back into coordinates except the first of a shard. Rows with a
+ * unit element stride are memcpy, the others go a band at a time.
+ */
+uint32_t GatherView(const aicpu::CpuKernelContext &ctx, uint8_t *dst, const uint8_t *src, const StridedView &view,
+                    int64_t element_bytes)
+{
+    int64_t inner = view.dims[view.rank - 1];
+    int64_t inner_stride = view.strides[view.rank - 1];
+    int64_t outer_rank = view.rank - 1;
+    int64_t rows = 1;
+    for (int64_t i = 0; i < outer_rank; ++i) {
+        rows *= view.dims[i];
+    }
+    int64_t row_bytes = inner * element_bytes;
+    // a band reads one cache line across its rows when they are next to each other
+    bool banded = inner_stride != 1 && outer_rank > 0 && view.strides[outer_rank - 1] < inner_stride;
+    int64_t max_band = static_cast<int64_t>(aicpu::kCopyCacheLineSize) / element_bytes;
+    max_band = (max_band < 1) ? 1 : max_band;
+    auto shard = [&](int64_t start, int64_t end) {
+        int64_t index[kMaxViewDims];
+        int64_t offset = view.offset;
+        int64_t rest = start;
+        for (int64_t i = outer_rank; i-- > 0;) {
+            index[i] = rest % view.dims[i];
+            rest /= view.dims[i];
+            offset += index[i] * view.strides[i];
+        }
+        int64_t row = start;
+        while (row < end) {
+            int64_t band = 1;
+            if (inner_stride == 1) {
+                memcpy(dst + row * row_bytes, src + offset * element_bytes, row_bytes);
+            } else if (!banded) {
+                GatherBand(dst + row * row_bytes, src + offset * element_bytes, 1, 0, inner, inner_stride,
+                           element_bytes);
+            } else {
+                // a band stays within the innermost outer dim and the shard
+                band = view.dims[outer_rank - 1] - index[outer_rank - 1];
+                band = (band < max_band) ? band : max_band;
+                band = (band < end - row) ? band : end - row;
+                GatherBand(dst + row * row_bytes, src + offset * element_bytes, band, view.strides[outer_rank - 1],
+                           inner, inner_stride, element_bytes);
+            }
+            row += band;
+            for (int64_t step = 0; step < band; ++step) {
+                for (int64_t i = outer_rank; i-- > 0;) {
+                    offset += view.strides[i];
+                    if (++index[i] < view.dims[i]) {
+                        break;
+                    }
+                    offset -= index[i] * view.strides[i];
+                    index[i] = 0;
+                }
+            }
+        }
+    };
+    uint64_t total_bytes = static_cast<uint64_t>(rows * row_bytes);
+    if (total_bytes <= aicpu::ParallelCopyThreshold() || rows == 1) {
+        shard(0, rows);
+        return 0;
+    }
+    int64_t rows_per_shard = (static_cast<int64_t>(aicpu::kMinCopyShardSize) + row_bytes - 1) / row_bytes;
+    return aicpu::CpuKernelUtils::ParallelFor(ctx, rows, rows_per_shard, shard) != 0 ? -1 : 0;
+}
 }
 
 namespace aicpu {
 uint32_t ReshapeCustCpuKernel::Compute(CpuKernelContext &ctx)
 {
+    KERNEL_TRACE_SCOPE(ctx, RESHAPE_CUST);
     Tensor *input_tensor = ctx.Input(0);
     if (input_tensor == nullptr) {
         return -1;
@@ -32,10 +260,59 @@ uint32_t ReshapeCustCpuKernel::Compute(CpuKernelContext &ctx)
 	if (output_data == nullptr) {
         return -1;
     }
-	
+
+    // an upstream op that left x as a strided view describes it here instead of making it dense first
+    AttrValue *strides_attr = ctx.GetAttr("strides");
+    std::vector<int64_t> strides;
+    if (strides_attr != nullptr) {
+        strides = strides_attr->GetListInt();
+    }
+    if (!strides.empty()) {
+        int64_t offset = 0;
+        AttrValue *offset_attr = ctx.GetAttr("storage_offset");
+        if (offset_attr != nullptr) {
+            offset = offset_attr->GetInt();
+        }
+        StridedView view;
+        std::vector<int64_t> dims = input_tensor->GetTensorShape()->GetDimSizes();
+        int64_t element_bytes = ElementBytes(input_tensor->GetDataType());
+        if (element_bytes == 0 || !BuildStridedView(dims, strides, offset, view)) {
+            return -1;
+        }
+        int64_t elements = input_tensor->NumElements();
+        if (elements == 0) {
+            return 0;
+        }
+        if (static_cast<uint64_t>(ViewExtent(view) * element_bytes) > input_tensor->GetDataSize() ||
+            static_cast<uint64_t>(elements * element_bytes) > output_tensor->GetDataSize()) {
+            return -1;
+        }
+        const uint8_t *src = static_cast<const uint8_t *>(input_data);
+        // y over the buffer of x: a dense view at offset 0 is already in place, any
+        // other view would be read while it is overwritten
+        if (output_data == input_data) {
+            return (IsDense(view) && offset == 0) ? 0 : -1;
+        }
+        if (!IsDense(view)) {
+            return GatherView(ctx, static_cast<uint8_t *>(output_data), src, view, element_bytes);
+        }
+        // dense after all, only the offset is left
+        return ParallelCopy(ctx, output_data, src + offset * element_bytes,
+            static_cast<uint64_t>(elements * element_bytes));
+    }
+
 	uint64_t data_size = input_tensor->GetDataSize();
-    memcpy(output_data, input_data, data_size);
-    return 0;
+    // output is registered as a reference of input, so GE normally hands over
+    // the same buffer (or grants in-place reuse) and there is nothing to move
+    if (output_data == input_data) {
+        return 0;
+    }
+
+    // fallback when the framework did not alias the buffers
+    if (output_tensor->GetDataSize() < data_size) {
+        return -1;
+    }
+    return ParallelCopy(ctx, output_data, input_data, data_size);
 }
 
 REGISTER_CPU_KERNEL(RESHAPE_CUST, ReshapeCustCpuKernel);
@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of ScatterNdAdd
+ */
+
+#include "scatter_nd_add_kernels.h"
+#include <vector>
+#include "cpu_kernel_utils.h"
+#include "cpu_types.h"
+#include "kernel_trace.h"
+#include "parallel_copy.h"
+#include "vector_ops.h"
+
+namespace {
+const char *SCATTER_ND_ADD = "ScatterNdAdd";
+// below this many updated elements the bucketing costs more than it saves
+const int64_t kParallelMinElements = 64 * 1024;
+// buckets per core, so a few hot row ranges do not serialize the whole op
+const int64_t kBucketsPerCpu = 4;
+
+/*
+ * Updates grouped by destination row range. Bucket b owns var rows
+ * [b * rows_per_bucket, (b + 1) * rows_per_bucket) and the updates
+ * order[offsets[b], offsets[b + 1]), so buckets never write the same row.
+ */
+struct ScatterPlan {
+    int64_t slice_size = 1;
+    int64_t rows_per_bucket = 1;
+    std::vector<int64_t> rows;
+    std::vector<int64_t> offsets;
+    std::vector<int64_t> order;
+};
+
+// flatten each index tuple to a row of var, rejecting out of range indices
+template <typename TIndex>
+bool FlattenIndices(const TIndex *indices, int64_t index_num, int64_t index_depth,
+                    const std::vector<int64_t> &var_dims, std::vector<int64_t> &rows)
+{
+    std::vector<int64_t> strides(index_depth, 1);
+    for (int64_t k = index_depth - 2; k >= 0; --k) {
+        strides[k] = strides[k + 1] * var_dims[k + 1];
+    }
+    rows.resize(index_num);
+    for (int64_t i = 0; i < index_num; ++i) {
+        const TIndex *index = indices + i * index_depth;
+        int64_t row = 0;
+        for (int64_t k = 0; k < index_depth; ++k) {
+            int64_t value = static_cast<int64_t>(index[k]);
+            if (value < 0 || value >= var_dims[k]) {
+                return false;
+            }
+            row += value * strides[k];
+        }
+        rows[i] = row;
+    }
+    return true;
+}
+
+// stable counting sort of update positions by bucket
+void BucketRows(int64_t row_num, int64_t bucket_num, ScatterPlan &plan)
+{
+    plan.rows_per_bucket = (row_num + bucket_num - 1) / bucket_num;
+    plan.offsets.assign(bucket_num + 1, 0);
+    for (int64_t row : plan.rows) {
+        ++plan.offsets[row / plan.rows_per_bucket + 1];
+    }
+    for (int64_t b = 0; b < bucket_num; ++b) {
+        plan.offsets[b + 1] += plan.offsets[b];
+    }
+    std::vector<int64_t> cursor(plan.offsets.begin(), plan.offsets.end() - 1);
+    plan.order.resize(plan.rows.size());
+    for (int64_t i = 0; i < static_cast<int64_t>(plan.rows.size()); ++i) {
+        plan.order[cursor[plan.rows[i] / plan.rows_per_bucket]++] = i;
+    }
+}
+
+template <typename T>
+void ApplyUpdates(T *var, const T *updates, const ScatterPlan &plan, int64_t begin, int64_t end)
+{
+    for (int64_t i = begin; i < end; ++i) {
+        int64_t update = plan.order.empty() ? i : plan.order[i];
+        aicpu::AddInplace(var + plan.rows[update] * plan.slice_size, updates + update * plan.slice_size,
+            plan.slice_size);
+    }
+}
+
+template <typename T>
+uint32_t ScatterNdAddCompute(const aicpu::CpuKernelContext &ctx, void *var, const void *updates,
+                             ScatterPlan &plan, int64_t row_num)
+{
+    T *var_data = static_cast<T *>(var);
+    const T *updates_data = static_cast<const T *>(updates);
+    int64_t index_num = static_cast<int64_t>(plan.rows.size());
+    uint32_t cpu_num = aicpu::CpuKernelUtils::GetCPUNum(ctx);
+    if (cpu_num <= 1 || index_num * plan.slice_size < kParallelMinElements || row_num < 2) {
+        ApplyUpdates(var_data, updates_data, plan, 0, index_num);
+        return 0;
+    }
+
+    int64_t bucket_num = static_cast<int64_t>(cpu_num) * kBucketsPerCpu;
+    if (bucket_num > row_num) {
+        bucket_num = row_num;
+    }
+    BucketRows(row_num, bucket_num, plan);
+    auto shard = [var_data, updates_data, &plan](int64_t start, int64_t end) {
+        for (int64_t b = start; b < end; ++b) {
+            ApplyUpdates(var_data, updates_data, plan, plan.offsets[b], plan.offsets[b + 1]);
+        }
+    };
+    return aicpu::CpuKernelUtils::ParallelFor(ctx, bucket_num, 1, shard);
+}
+}
+
+namespace aicpu {
+uint32_t ScatterNdAddCpuKernel::Compute(CpuKernelContext &ctx)
+{
+    KERNEL_TRACE_SCOPE(ctx, SCATTER_ND_ADD);
+    Tensor *var_tensor = ctx.Input(0);
+    Tensor *indices_tensor = ctx.Input(1);
+    Tensor *updates_tensor = ctx.Input(2);
+    Tensor *output_tensor = ctx.Output(0);
+    if (var_tensor == nullptr || indices_tensor == nullptr || updates_tensor == nullptr ||
+        output_tensor == nullptr) {
+        return -1;
+    }
+    void *var_data = var_tensor->GetData();
+    void *indices_data = indices_tensor->GetData();
+    void *updates_data = updates_tensor->GetData();
+    void *output_data = output_tensor->GetData();
+    if (var_data == nullptr || output_data == nullptr) {
+        return -1;
+    }
+    DataType data_type = var_tensor->GetDataType();
+    if (updates_tensor->GetDataType() != data_type) {
+        return -1;
+    }
+
+    std::vector<int64_t> var_dims = var_tensor->GetTensorShape()->GetDimSizes();
+    std::vector<int64_t> indices_dims = indices_tensor->GetTensorShape()->GetDimSizes();
+    if (indices_dims.empty()) {
+        return -1;
+    }
+    int64_t index_depth = indices_dims.back();
+    if (index_depth < 1 || index_depth > static_cast<int64_t>(var_dims.size())) {
+        return -1;
+    }
+    int64_t index_num = indices_tensor->NumElements() / index_depth;
+
+    ScatterPlan plan;
+    int64_t row_num = 1;
+    for (int64_t k = 0; k < index_depth; ++k) {
+        row_num *= var_dims[k];
+    }
+    for (size_t k = index_depth; k < var_dims.size(); ++k) {
+        plan.slice_size *= var_dims[k];
+    }
+    if (updates_tensor->NumElements() != index_num * plan.slice_size) {
+        return -1;
+    }
+    if (index_num > 0 && (indices_data == nullptr || updates_data == nullptr)) {
+        return -1;
+    }
+
+    bool valid = false;
+    if (indices_tensor->GetDataType() == DT_INT32) {
+        valid = FlattenIndices(static_cast<const int32_t *>(indices_data), index_num, index_depth, var_dims,
+            plan.rows);
+    } else if (indices_tensor->GetDataType() == DT_INT64) {
+        valid = FlattenIndices(static_cast<const int64_t *>(indices_data), index_num, index_depth, var_dims,
+            plan.rows);
+    }
+    if (!valid) {
+        return -1;
+    }
+
+    // output var is a reference of input var, copy only when GE did not alias them
+    if (output_data != var_data) {
+        if (output_tensor->GetDataSize() < var_tensor->GetDataSize() ||
+            ParallelCopy(ctx, output_data, var_data, var_tensor->GetDataSize()) != 0) {
+            return -1;
+        }
+    }
+
+    switch (data_type) {
+        case DT_FLOAT16:
+            return ScatterNdAddCompute<Half>(ctx, output_data, updates_data, plan, row_num);
+        case DT_FLOAT:
+            return ScatterNdAddCompute<float>(ctx, output_data, updates_data, plan, row_num);
+        case DT_INT32:
+            return ScatterNdAddCompute<int32_t>(ctx, output_data, updates_data, plan, row_num);
+        case DT_INT8:
+            return ScatterNdAddCompute<int8_t>(ctx, output_data, updates_data, plan, row_num);
+        case DT_UINT8:
+            return ScatterNdAddCompute<uint8_t>(ctx, output_data, updates_data, plan, row_num);
+        default:
+            return -1;
+    }
+}
+
+REGISTER_CPU_KERNEL(SCATTER_ND_ADD, ScatterNdAddCpuKernel);
+} // namespace aicpu
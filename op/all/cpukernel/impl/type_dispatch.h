@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of data type dispatch for typed AI CPU kernels
+ *
+ * A kernel lists the C++ types it is instantiated for in a TypeList, in the
+ * same order as the TensorType list of its op_proto, and DispatchType picks
+ * the instantiation matching a tensor's DataType once per launch, through a
+ * table built at compile time. A type without a DataTypeOf does not compile.
+ */
+
+#ifndef _AICPU_TYPE_DISPATCH_H_
+#define _AICPU_TYPE_DISPATCH_H_
+
+#include <stdint.h>
+#include "cpu_types.h"
+#include "fp16_utils.h"
+
+namespace aicpu {
+// DataType of the tensors holding T, only defined for types a kernel can run on
+template <typename T>
+struct DataTypeOf;
+
+#define AICPU_DEFINE_DATA_TYPE_OF(type, data_type)            \
+    template <>                                               \
+    struct DataTypeOf<type> {                                 \
+        static const DataType kValue = data_type;             \
+    }
+
+AICPU_DEFINE_DATA_TYPE_OF(float, DT_FLOAT);
+AICPU_DEFINE_DATA_TYPE_OF(Half, DT_FLOAT16);
+AICPU_DEFINE_DATA_TYPE_OF(double, DT_DOUBLE);
+AICPU_DEFINE_DATA_TYPE_OF(int8_t, DT_INT8);
+AICPU_DEFINE_DATA_TYPE_OF(uint8_t, DT_UINT8);
+AICPU_DEFINE_DATA_TYPE_OF(int16_t, DT_INT16);
+AICPU_DEFINE_DATA_TYPE_OF(uint16_t, DT_UINT16);
+AICPU_DEFINE_DATA_TYPE_OF(int32_t, DT_INT32);
+AICPU_DEFINE_DATA_TYPE_OF(uint32_t, DT_UINT32);
+AICPU_DEFINE_DATA_TYPE_OF(int64_t, DT_INT64);
+AICPU_DEFINE_DATA_TYPE_OF(uint64_t, DT_UINT64);
+AICPU_DEFINE_DATA_TYPE_OF(bool, DT_BOOL);
+#undef AICPU_DEFINE_DATA_TYPE_OF
+
+template <typename... Ts>
+struct TypeList {};
+
+template <int... Is>
+struct IndexSequence {};
+
+template <int N, int... Is>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, Is...> {};
+
+template <int... Is>
+struct MakeIndexSequence<0, Is...> {
+    typedef IndexSequence<Is...> Type;
+};
+
+// largest DataType of the list, -1 for an empty one
+template <typename... Ts>
+struct MaxDataType {
+    static const int kValue = -1;
+};
+
+template <typename T, typename... Rest>
+struct MaxDataType<T, Rest...> {
+    static const int kFirst = DataTypeOf<T>::kValue;
+    static const int kRest = MaxDataType<Rest...>::kValue;
+    static const int kValue = kFirst > kRest ? kFirst : kRest;
+};
+
+// true when no two types of the list share a DataType
+template <typename... Ts>
+struct DistinctDataTypes {
+    static const bool kValue = true;
+};
+
+template <typename T, typename... Rest>
+struct DistinctDataTypes<T, Rest...> {
+    template <typename... Us>
+    struct Absent {
+        static const bool kValue = true;
+    };
+    template <typename U, typename... Us>
+    struct Absent<U, Us...> {
+        static const bool kValue = DataTypeOf<T>::kValue != DataTypeOf<U>::kValue && Absent<Us...>::kValue;
+    };
+    static const bool kValue = Absent<Rest...>::kValue && DistinctDataTypes<Rest...>::kValue;
+};
+
+template <typename Func, typename T>
+uint32_t InvokeRun(Func &func)
+{
+    return func.template Run<T>();
+}
+
+// handler of the T whose DataType is I, nullptr when the list has none
+template <typename Func, int I, typename... Ts>
+struct DispatchEntry {
+    static constexpr uint32_t (*Get())(Func &) { return nullptr; }
+};
+
+template <typename Func, int I, typename T, typename... Rest>
+struct DispatchEntry<Func, I, T, Rest...> {
+    static constexpr uint32_t (*Get())(Func &)
+    {
+        return DataTypeOf<T>::kValue == I ? &InvokeRun<Func, T> : DispatchEntry<Func, I, Rest...>::Get();
+    }
+};
+
+/*
+ * Handlers indexed by DataType, filled at compile time, so a launch costs a
+ * bounds check and one indirect call however long the type list is.
+ */
+template <typename Func, typename Types, typename Indices>
+struct DispatchTable;
+
+template <typename Func, typename... Ts, int... Is>
+struct DispatchTable<Func, TypeList<Ts...>, IndexSequence<Is...>> {
+    typedef uint32_t (*Handler)(Func &);
+    static const int kSize = sizeof...(Is);
+    static constexpr Handler kHandlers[sizeof...(Is)] = {DispatchEntry<Func, Is, Ts...>::Get()...};
+};
+
+template <typename Func, typename... Ts, int... Is>
+constexpr typename DispatchTable<Func, TypeList<Ts...>, IndexSequence<Is...>>::Handler
+    DispatchTable<Func, TypeList<Ts...>, IndexSequence<Is...>>::kHandlers[sizeof...(Is)];
+
+/*
+ * Calls func.template Run<T>() for the T of types whose DataType is type and
+ * returns its result, or -1 when type is not in the list. Every type must
+ * have a DataTypeOf and appear once, which is checked at compile time.
+ */
+template <typename... Ts, typename Func>
+inline uint32_t DispatchType(TypeList<Ts...>, DataType type, Func &func)
+{
+    static_assert(sizeof...(Ts) > 0, "dispatch needs at least one type");
+    static_assert(DistinctDataTypes<Ts...>::kValue, "two types of the list map to the same DataType");
+    typedef DispatchTable<Func, TypeList<Ts...>, typename MakeIndexSequence<MaxDataType<Ts...>::kValue + 1>::Type>
+        Table;
+    int index = static_cast<int>(type);
+    if (index < 0 || index >= Table::kSize || Table::kHandlers[index] == nullptr) {
+        return -1;
+    }
+    return Table::kHandlers[index](func);
+}
+} // namespace aicpu
+#endif
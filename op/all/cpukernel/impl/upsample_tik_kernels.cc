@@ -0,0 +1,190 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of UpsampleTik
+ */
+
+#include "upsample_tik_kernels.h"
+#include <string.h>
+#include <atomic>
+#include <vector>
+#include "cpu_kernel_utils.h"
+#include "cpu_types.h"
+#include "fp16_utils.h"
+#include "kernel_trace.h"
+#include "vector_ops.h"
+#include "workspace_arena.h"
+
+namespace {
+const char *UPSAMPLE_TIK = "UpsampleTik";
+const int64_t kMinShardElements = 16 * 1024;
+
+/*
+ * [n, c, h, w] (or [n, c1, h, w, c0]) viewed as rows of w blocks, each block
+ * holding inner elements. Every input row yields stride_h identical output rows.
+ */
+struct UpsampleShape {
+    int64_t rows;
+    int64_t width;
+    int64_t inner;
+    int64_t stride_h;
+    int64_t stride_w;
+    float scale;
+};
+
+inline void ScaleRow(float *dst, const float *src, int64_t n, float scale)
+{
+    aicpu::MulScalar(dst, src, scale, n);
+}
+
+// float16 is scaled in float, a block at a time
+inline void ScaleRow(aicpu::Half *dst, const aicpu::Half *src, int64_t n, float scale)
+{
+    aicpu::HalfUnary(dst, src, n, [scale](float *out, const float *in, int64_t len) {
+        aicpu::MulScalar(out, in, scale, len);
+    });
+}
+
+// compute one output row from one input row, replicating every block stride_w times
+template <typename T>
+void UpsampleRow(T *y, const T *x, const UpsampleShape &shape)
+{
+    if (shape.inner == 1) {
+        // NCHW: blocks are single elements, a memcpy per element costs more than the store
+        for (int64_t w = 0; w < shape.width; ++w) {
+            T value = x[w];
+            T *dst = y + w * shape.stride_w;
+            for (int64_t s = 0; s < shape.stride_w; ++s) {
+                dst[s] = value;
+            }
+        }
+        return;
+    }
+    for (int64_t w = 0; w < shape.width; ++w) {
+        T *dst = y + w * shape.stride_w * shape.inner;
+        memcpy(dst, x + w * shape.inner, shape.inner * sizeof(T));
+        for (int64_t s = 1; s < shape.stride_w; ++s) {
+            memcpy(dst + s * shape.inner, dst, shape.inner * sizeof(T));
+        }
+    }
+}
+
+// y_size is the byte size of the y buffer, which has to hold the whole output
+template <typename T>
+uint32_t UpsampleCompute(const aicpu::CpuKernelContext &ctx, T *y, uint64_t y_size, const T *x,
+                         const UpsampleShape &shape)
+{
+    bool need_scale = shape.scale != 1.0f;
+    int64_t in_row = shape.width * shape.inner;
+    int64_t out_row = in_row * shape.stride_w;
+    if (y_size < static_cast<uint64_t>(shape.rows * shape.stride_h * out_row) * sizeof(T)) {
+        return -1;
+    }
+    std::atomic<bool> failed(false);
+    auto shard = [&](int64_t start, int64_t end) {
+        // scaling happens once per input row, before the replication
+        aicpu::ScopedWorkspace workspace(need_scale ? aicpu::WorkspaceBytes<T>(in_row) : 0);
+        T *scaled = need_scale ? workspace.Arena().Allocate<T>(in_row) : nullptr;
+        if (need_scale && scaled == nullptr) {
+            failed = true;
+            return;
+        }
+        for (int64_t row = start; row < end; ++row) {
+            T *dst = y + row * shape.stride_h * out_row;
+            const T *src = x + row * in_row;
+            if (need_scale) {
+                ScaleRow(scaled, src, in_row, shape.scale);
+                src = scaled;
+            }
+            UpsampleRow(dst, src, shape);
+            // the other stride_h - 1 rows are bulk copies of the first one
+            for (int64_t s = 1; s < shape.stride_h; ++s) {
+                memcpy(dst + s * out_row, dst, out_row * sizeof(T));
+            }
+        }
+    };
+    int64_t elements_per_row = out_row * shape.stride_h;
+    if (aicpu::CpuKernelUtils::GetCPUNum(ctx) <= 1 || shape.rows * elements_per_row <= kMinShardElements) {
+        shard(0, shape.rows);
+    } else {
+        int64_t rows_per_shard = (kMinShardElements + elements_per_row - 1) / elements_per_row;
+        if (aicpu::CpuKernelUtils::ParallelFor(ctx, shape.rows, rows_per_shard, shard) != 0) {
+            return -1;
+        }
+    }
+    return failed ? -1 : 0;
+}
+}
+
+namespace aicpu {
+uint32_t UpsampleTikCpuKernel::Compute(CpuKernelContext &ctx)
+{
+    KERNEL_TRACE_SCOPE(ctx, UPSAMPLE_TIK);
+    Tensor *x_tensor = ctx.Input(0);
+    Tensor *y_tensor = ctx.Output(0);
+    if (x_tensor == nullptr || y_tensor == nullptr) {
+        return -1;
+    }
+
+    UpsampleShape shape;
+    shape.scale = 1.0f;
+    shape.stride_h = 2;
+    shape.stride_w = 2;
+    AttrValue *scale = ctx.GetAttr("scale");
+    if (scale != nullptr) {
+        shape.scale = scale->GetFloat();
+    }
+    AttrValue *stride_h = ctx.GetAttr("stride_h");
+    if (stride_h != nullptr) {
+        shape.stride_h = stride_h->GetInt();
+    }
+    AttrValue *stride_w = ctx.GetAttr("stride_w");
+    if (stride_w != nullptr) {
+        shape.stride_w = stride_w->GetInt();
+    }
+    if (shape.stride_h <= 0 || shape.stride_w <= 0) {
+        return -1;
+    }
+
+    // h and w are axes 2 and 3, as in UpsampleTikInferShape
+    std::vector<int64_t> x_dims = x_tensor->GetTensorShape()->GetDimSizes();
+    std::vector<int64_t> y_dims = y_tensor->GetTensorShape()->GetDimSizes();
+    if (x_dims.size() < 4 || y_dims.size() != x_dims.size() || y_tensor->GetDataType() != x_tensor->GetDataType()) {
+        return -1;
+    }
+    for (size_t i = 0; i < x_dims.size(); ++i) {
+        if (i != 2 && i != 3 && y_dims[i] != x_dims[i]) {
+            return -1;
+        }
+    }
+    shape.rows = x_dims[0] * x_dims[1] * x_dims[2];
+    shape.width = x_dims[3];
+    shape.inner = 1;
+    for (size_t i = 4; i < x_dims.size(); ++i) {
+        shape.inner *= x_dims[i];
+    }
+    if (y_dims[2] != x_dims[2] * shape.stride_h || y_dims[3] != x_dims[3] * shape.stride_w) {
+        return -1;
+    }
+    if (shape.rows * shape.width * shape.inner == 0) {
+        return 0;
+    }
+    void *x_data = x_tensor->GetData();
+    void *y_data = y_tensor->GetData();
+    if (x_data == nullptr || y_data == nullptr) {
+        return -1;
+    }
+
+    uint64_t y_size = y_tensor->GetDataSize();
+    switch (x_tensor->GetDataType()) {
+        case DT_FLOAT16:
+            return UpsampleCompute(ctx, static_cast<Half *>(y_data), y_size, static_cast<const Half *>(x_data), shape);
+        case DT_FLOAT:
+            return UpsampleCompute(ctx, static_cast<float *>(y_data), y_size, static_cast<const float *>(x_data),
+                shape);
+        default:
+            return -1;
+    }
+}
+
+REGISTER_CPU_KERNEL(UPSAMPLE_TIK, UpsampleTikCpuKernel);
+} // namespace aicpu
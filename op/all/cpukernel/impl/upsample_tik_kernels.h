@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of UpsampleTik
+ */
+
+#ifndef _AICPU_UPSAMPLE_TIK_KERNELS_H_
+#define _AICPU_UPSAMPLE_TIK_KERNELS_H_
+
+#include "cpu_kernel.h"
+
+namespace aicpu {
+class UpsampleTikCpuKernel : public CpuKernel {
+public:
+    ~UpsampleTikCpuKernel() = default;
+    uint32_t Compute(CpuKernelContext &ctx) override;
+};
+} // namespace aicpu
+#endif
@@ -0,0 +1,245 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of 128 bit vector helpers shared by AI CPU kernels
+ *
+ * Built on GCC vector extensions, which lower to NEON with the aarch64
+ * toolchain and to SSE/AVX on host builds, so one source serves both.
+ */
+
+#ifndef _AICPU_VECTOR_OPS_H_
+#define _AICPU_VECTOR_OPS_H_
+
+#include <stdint.h>
+#include <string.h>
+#include "fp16_utils.h"
+
+namespace aicpu {
+const int64_t kVectorBytes = 16;
+
+// Vec is the 128 bit vector of T, only defined for types with native lanes
+template <typename T>
+struct VecTraits {
+    static const bool kNative = false;
+};
+
+#define AICPU_DEFINE_VEC_TRAITS(type)                                                  \
+    template <>                                                                        \
+    struct VecTraits<type> {                                                           \
+        static const bool kNative = true;                                              \
+        typedef type Vec __attribute__((vector_size(kVectorBytes)));                   \
+        static const int64_t kLanes = kVectorBytes / static_cast<int64_t>(sizeof(type)); \
+    }
+
+AICPU_DEFINE_VEC_TRAITS(float);
+AICPU_DEFINE_VEC_TRAITS(double);
+AICPU_DEFINE_VEC_TRAITS(int8_t);
+AICPU_DEFINE_VEC_TRAITS(uint8_t);
+AICPU_DEFINE_VEC_TRAITS(int16_t);
+AICPU_DEFINE_VEC_TRAITS(uint16_t);
+AICPU_DEFINE_VEC_TRAITS(int32_t);
+AICPU_DEFINE_VEC_TRAITS(uint32_t);
+AICPU_DEFINE_VEC_TRAITS(int64_t);
+AICPU_DEFINE_VEC_TRAITS(uint64_t);
+#undef AICPU_DEFINE_VEC_TRAITS
+
+// unaligned load and store, memcpy compiles to a single vector move
+template <typename V, typename T>
+inline V VecLoad(const T *src)
+{
+    V value;
+    memcpy(&value, src, sizeof(V));
+    return value;
+}
+
+template <typename V, typename T>
+inline void VecStore(T *dst, const V &value)
+{
+    memcpy(dst, &value, sizeof(V));
+}
+
+typedef VecTraits<float>::Vec VecFloat;
+typedef VecTraits<int32_t>::Vec VecInt32;
+
+/*
+ * Lane-wise exp of float, within 1 ulp of expf for every float of
+ * [ln(FLT_MIN), 88] and 1.03 ulp of the exact exp, with or without FMA
+ * contraction. x is clamped to that range, so large negative inputs give
+ * FLT_MIN instead of denormals and large positive ones stay finite.
+ */
+inline VecFloat VecExp(VecFloat x)
+{
+    const float kLog2e = 1.44269504088896341f;
+    const float kLn2Hi = 0.693359375f;
+    const float kLn2Lo = -2.12194440e-4f;
+    // adding 1.5 * 2^23 rounds to an integer held in the low mantissa bits
+    const float kRoundMagic = 12582912.0f;
+    VecFloat lo = VecFloat{} - 87.3365448f;
+    VecFloat hi = VecFloat{} + 88.0f;
+    x = x < lo ? lo : x;
+    x = x > hi ? hi : x;
+    VecFloat magic = VecFloat{} + kRoundMagic;
+    VecFloat fx = x * kLog2e + magic;
+    // a cast between vectors of the same size keeps the bits
+    VecInt32 n = (VecInt32)fx - (VecInt32)magic;
+    fx = fx - magic;
+    VecFloat r = x - fx * kLn2Hi - fx * kLn2Lo;
+    VecFloat p = VecFloat{} + 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * r * r + r + 1.0f;
+    VecInt32 scale_bits = (n + 127) << 23;
+    return p * (VecFloat)scale_bits;
+}
+
+// dst[i] = a[i] + b[i] for i in [0, n), dst may alias a or b
+template <typename T>
+inline void Add(T *dst, const T *a, const T *b, int64_t n)
+{
+    typedef typename VecTraits<T>::Vec Vec;
+    const int64_t lanes = VecTraits<T>::kLanes;
+    int64_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        Vec r0 = VecLoad<Vec>(a + i) + VecLoad<Vec>(b + i);
+        Vec r1 = VecLoad<Vec>(a + i + lanes) + VecLoad<Vec>(b + i + lanes);
+        VecStore(dst + i, r0);
+        VecStore(dst + i + lanes, r1);
+    }
+    for (; i < n; ++i) {
+        dst[i] = static_cast<T>(a[i] + b[i]);
+    }
+}
+
+// dst[i] = a[i] * scalar for i in [0, n), dst may alias a
+template <typename T>
+inline void MulScalar(T *dst, const T *a, T scalar, int64_t n)
+{
+    typedef typename VecTraits<T>::Vec Vec;
+    const int64_t lanes = VecTraits<T>::kLanes;
+    Vec s = Vec{} + scalar;
+    int64_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        VecStore(dst + i, VecLoad<Vec>(a + i) * s);
+        VecStore(dst + i + lanes, VecLoad<Vec>(a + i + lanes) * s);
+    }
+    for (; i < n; ++i) {
+        dst[i] = static_cast<T>(a[i] * scalar);
+    }
+}
+
+// dst[i] = a[i] * scale + shift for i in [0, n), dst may alias a
+template <typename T>
+inline void MulAddScalar(T *dst, const T *a, T scale, T shift, int64_t n)
+{
+    typedef typename VecTraits<T>::Vec Vec;
+    const int64_t lanes = VecTraits<T>::kLanes;
+    Vec s = Vec{} + scale;
+    Vec b = Vec{} + shift;
+    int64_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        VecStore(dst + i, VecLoad<Vec>(a + i) * s + b);
+        VecStore(dst + i + lanes, VecLoad<Vec>(a + i + lanes) * s + b);
+    }
+    for (; i < n; ++i) {
+        dst[i] = static_cast<T>(a[i] * scale + shift);
+    }
+}
+
+// dst[i] = a[i] * scale[i] + shift[i] for i in [0, n), dst may alias a
+template <typename T>
+inline void MulAdd(T *dst, const T *a, const T *scale, const T *shift, int64_t n)
+{
+    typedef typename VecTraits<T>::Vec Vec;
+    const int64_t lanes = VecTraits<T>::kLanes;
+    int64_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        Vec r0 = VecLoad<Vec>(a + i) * VecLoad<Vec>(scale + i) + VecLoad<Vec>(shift + i);
+        Vec r1 = VecLoad<Vec>(a + i + lanes) * VecLoad<Vec>(scale + i + lanes) + VecLoad<Vec>(shift + i + lanes);
+        VecStore(dst + i, r0);
+        VecStore(dst + i + lanes, r1);
+    }
+    for (; i < n; ++i) {
+        dst[i] = static_cast<T>(a[i] * scale[i] + shift[i]);
+    }
+}
+
+// float16 helpers work on blocks of kHalfBlock elements widened on the stack
+const int64_t kHalfBlock = 256;
+
+/*
+ * dst[i] = half(op(float(a[i]))) for i in [0, n). op(float *dst, const
+ * float *a, int64_t len) is called in place on every block, so float16
+ * math costs one bulk conversion each way instead of one per operation.
+ */
+template <typename Op>
+inline void HalfUnary(Half *dst, const Half *a, int64_t n, Op op)
+{
+    float fa[kHalfBlock];
+    for (int64_t i = 0; i < n; i += kHalfBlock) {
+        int64_t len = (n - i < kHalfBlock) ? (n - i) : kHalfBlock;
+        HalfToFloat(a + i, fa, len);
+        op(fa, fa, len);
+        FloatToHalf(fa, dst + i, len);
+    }
+}
+
+// float16 is added in float and rounded once per element
+template <>
+inline void Add<Half>(Half *dst, const Half *a, const Half *b, int64_t n)
+{
+    float fa[kHalfBlock];
+    float fb[kHalfBlock];
+    for (int64_t i = 0; i < n; i += kHalfBlock) {
+        int64_t len = (n - i < kHalfBlock) ? (n - i) : kHalfBlock;
+        HalfToFloat(a + i, fa, len);
+        HalfToFloat(b + i, fb, len);
+        Add(fa, fa, fb, len);
+        FloatToHalf(fa, dst + i, len);
+    }
+}
+
+// two accumulators hide the latency of the vector add
+inline float Sum(const float *src, int64_t n)
+{
+    const int64_t lanes = VecTraits<float>::kLanes;
+    VecFloat acc0 = VecFloat{};
+    VecFloat acc1 = VecFloat{};
+    int64_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        acc0 += VecLoad<VecFloat>(src + i);
+        acc1 += VecLoad<VecFloat>(src + i + lanes);
+    }
+    acc0 += acc1;
+    float total = 0.0f;
+    for (int64_t j = 0; j < lanes; ++j) {
+        total += acc0[j];
+    }
+    for (; i < n; ++i) {
+        total += src[i];
+    }
+    return total;
+}
+
+// sum of float16 accumulated in float, one partial sum per block
+inline float HalfSum(const Half *src, int64_t n)
+{
+    float block[kHalfBlock];
+    float total = 0.0f;
+    for (int64_t i = 0; i < n; i += kHalfBlock) {
+        int64_t len = (n - i < kHalfBlock) ? (n - i) : kHalfBlock;
+        HalfToFloat(src + i, block, len);
+        total += Sum(block, len);
+    }
+    return total;
+}
+
+// dst[i] += src[i] for i in [0, n)
+template <typename T>
+inline void AddInplace(T *dst, const T *src, int64_t n)
+{
+    Add(dst, dst, src, n);
+}
+} // namespace aicpu
+#endif
@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: implement of aligned scratch memory for AI CPU kernels
+ */
+
+#include "workspace_arena.h"
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace {
+// smallest block a thread allocates, so small scratch never costs a malloc per scope
+const uint64_t kMinWorkspaceBlock = 64 * 1024;
+
+struct WorkspaceBlock {
+    std::unique_ptr<uint8_t[]> storage;
+    uint8_t *base; // storage rounded up to kWorkspaceAlign
+    uint64_t size;
+};
+
+/*
+ * Blocks of one thread, carved front to back by the open scopes. A scope
+ * that does not fit the rest of the current block moves on to a later one,
+ * so an open scope never sees its memory move. When the outermost scope
+ * closes, several blocks are merged into one on the next demand.
+ */
+struct ThreadWorkspace {
+    std::vector<WorkspaceBlock> blocks;
+    uint64_t block = 0;
+    uint64_t offset = 0;
+    int depth = 0;
+    uint64_t next_block_size = kMinWorkspaceBlock;
+};
+
+thread_local ThreadWorkspace g_thread_workspace;
+
+bool AppendBlock(ThreadWorkspace &workspace, uint64_t size)
+{
+    WorkspaceBlock block;
+    block.storage.reset(new (std::nothrow) uint8_t[size + aicpu::kWorkspaceAlign]);
+    if (block.storage == nullptr) {
+        return false;
+    }
+    uintptr_t address = reinterpret_cast<uintptr_t>(block.storage.get());
+    block.base = reinterpret_cast<uint8_t *>(aicpu::AlignWorkspace(address));
+    block.size = size;
+    workspace.blocks.push_back(std::move(block));
+    return true;
+}
+}
+
+namespace aicpu {
+ScopedWorkspace::ScopedWorkspace(uint64_t bytes) : valid_(false)
+{
+    ThreadWorkspace &workspace = g_thread_workspace;
+    saved_block_ = workspace.block;
+    saved_offset_ = workspace.offset;
+    ++workspace.depth;
+    bytes = AlignWorkspace(bytes);
+    if (bytes == 0) {
+        valid_ = true;
+        return;
+    }
+
+    uint64_t index = workspace.block;
+    uint64_t offset = workspace.offset;
+    while (index < workspace.blocks.size() && workspace.blocks[index].size - offset < bytes) {
+        ++index;
+        offset = 0;
+    }
+    if (index == workspace.blocks.size() &&
+        !AppendBlock(workspace, std::max(bytes, workspace.next_block_size))) {
+        return;
+    }
+    arena_ = WorkspaceArena(workspace.blocks[index].base + offset, bytes);
+    workspace.block = index;
+    workspace.offset = offset + bytes;
+    valid_ = true;
+}
+
+ScopedWorkspace::~ScopedWorkspace()
+{
+    ThreadWorkspace &workspace = g_thread_workspace;
+    workspace.block = saved_block_;
+    workspace.offset = saved_offset_;
+    if (--workspace.depth > 0) {
+        return;
+    }
+    uint64_t total = 0;
+    for (const WorkspaceBlock &block : workspace.blocks) {
+        total += block.size;
+    }
+    if (workspace.blocks.size() > 1 || total > kMaxRetainedWorkspace) {
+        // the next launch gets one block as large as all of these, up to the retention limit
+        workspace.blocks.clear();
+        workspace.next_block_size = std::max(kMinWorkspaceBlock, std::min(total, kMaxRetainedWorkspace));
+    }
+}
+} // namespace aicpu
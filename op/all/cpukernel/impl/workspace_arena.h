@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: api of aligned scratch memory for AI CPU kernels
+ *
+ * A kernel adds up the scratch it needs for a shape with WorkspaceBytes,
+ * opens a ScopedWorkspace of that size once per launch or per shard and
+ * carves its buffers out of the arena. The memory comes from blocks kept
+ * per thread across launches, so once the AI CPU worker threads have seen
+ * the largest shape a kernel is launched with, Compute never reaches malloc.
+ */
+
+#ifndef _AICPU_WORKSPACE_ARENA_H_
+#define _AICPU_WORKSPACE_ARENA_H_
+
+#include <stdint.h>
+
+namespace aicpu {
+// every allocation starts on a cache line
+const uint64_t kWorkspaceAlign = 64;
+// a thread keeps at most this much scratch between launches
+const uint64_t kMaxRetainedWorkspace = 64 * 1024 * 1024;
+
+inline uint64_t AlignWorkspace(uint64_t bytes)
+{
+    return (bytes + kWorkspaceAlign - 1) / kWorkspaceAlign * kWorkspaceAlign;
+}
+
+// bytes an Allocate<T>(count) takes from an arena, sum these to size a ScopedWorkspace
+template <typename T>
+inline uint64_t WorkspaceBytes(int64_t count)
+{
+    return AlignWorkspace(static_cast<uint64_t>(count) * sizeof(T));
+}
+
+// bump allocator over one buffer, memory is handed out uninitialized and never freed
+class WorkspaceArena {
+public:
+    WorkspaceArena() : base_(nullptr), size_(0), used_(0) {}
+    // base must be kWorkspaceAlign aligned
+    WorkspaceArena(void *base, uint64_t size) : base_(static_cast<uint8_t *>(base)), size_(size), used_(0) {}
+
+    // nullptr when fewer than bytes are left
+    void *AllocateBytes(uint64_t bytes)
+    {
+        uint64_t aligned = AlignWorkspace(bytes);
+        if (base_ == nullptr || aligned > size_ - used_) {
+            return nullptr;
+        }
+        void *ptr = base_ + used_;
+        used_ += aligned;
+        return ptr;
+    }
+
+    template <typename T>
+    T *Allocate(int64_t count)
+    {
+        return count < 0 ? nullptr : static_cast<T *>(AllocateBytes(static_cast<uint64_t>(count) * sizeof(T)));
+    }
+
+    uint64_t Used() const { return used_; }
+    uint64_t Capacity() const { return size_; }
+
+private:
+    uint8_t *base_;
+    uint64_t size_;
+    uint64_t used_;
+};
+
+/*
+ * bytes of scratch on the calling thread until the scope closes. Scopes
+ * nest, so a shard run on the launching thread can open its own. When the
+ * memory cannot be had Valid is false and the arena is empty.
+ */
+class ScopedWorkspace {
+public:
+    explicit ScopedWorkspace(uint64_t bytes);
+    ~ScopedWorkspace();
+
+    bool Valid() const { return valid_; }
+    WorkspaceArena &Arena() { return arena_; }
+
+private:
+    ScopedWorkspace(const ScopedWorkspace &) = delete;
+    ScopedWorkspace &operator=(const ScopedWorkspace &) = delete;
+
+    WorkspaceArena arena_;
+    bool valid_;
+    uint64_t saved_block_;
+    uint64_t saved_offset_;
+};
+} // namespace aicpu
+#endif
@@ -11,6 +11,7 @@ namespace domi {
 
 const std::string NUM_OUTPUT = "num_output";
 const std::string GROUP = "group";
+const std::string GROUPS = "groups";
 const std::string KERNEL_SIZE = "kernel_size";
 const std::string KERNEL_H = "kernel_h";
 const std::string KERNEL_W = "kernel_w";
@@ -143,18 +144,20 @@ static bool SetDilations(const ge::Operator& op_src, ge::Operator& op_dest)
 // Check input parameters that are illegal or not applicable to 2D convolution
 static bool ProcSpecParams(const ge::Operator& op_src, ge::Operator& op_dest)
 {
-    int num_output;
+    // 0 until the layer gives one, so a missing num_output is not checked against group
+    int num_output = 0;
     if (ge::GRAPH_SUCCESS == op_src.GetAttr(NUM_OUTPUT, num_output)){
         if (num_output < 1) {
             return false;
         }
     }
+    // caffe's group is the groups attr of Conv2DTik, a depthwise layer has group == num_output
     int group;
     if (ge::GRAPH_SUCCESS == op_src.GetAttr(GROUP, group)){
         if (group < 1 || num_output % group != 0) {
             return false;
         }
-        op_dest.SetAttr(GROUP, (int64_t)group);
+        op_dest.SetAttr(GROUPS, (int64_t)group);
     }
 
 
@@ -79,5 +79,5 @@ namespace domi {
     .FrameworkType(TENSORFLOW)
     .OriginOpType("DecodeBboxV2FusionOp")
     .FusionParseParamsFn(DecodeBboxV2ParseParams)
-    .ImplyType(ImplyType::TVM);
+    .ImplyType(ImplyType::AI_CPU);
 }  // namespace domi
@@ -0,0 +1,443 @@
+/* Copyright (C) 2020. Huawei Technologies Co., Ltd. All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Apache License Version 2.0.
+ * You may not use this file except in compliance with the License.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Apache License for more details at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ */
+
+#include "fused_elementwise_scope_fusion_pass.h"
+#include <cstdlib>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <utility>
+
+#define OP_LOGE(OP_NAME, fmt, ...) printf("[ERROR]%s,%s:%u:" #fmt "\n", __FUNCTION__, __FILE__, __LINE__, ##__VA_ARGS__)
+#define OP_LOGW(OP_NAME, fmt, ...) printf("[WARN]%s,%s:%u:" #fmt "\n", __FUNCTION__, __FILE__, __LINE__, ##__VA_ARGS__)
+#define OP_LOGI(OP_NAME, fmt, ...) printf("[INFO]%s,%s:%u:" #fmt "\n", __FUNCTION__, __FILE__, __LINE__, ##__VA_ARGS__)
+
+namespace ge {
+    namespace {
+        const char *const kScopeTypeFusedElementwise = "FusedElementwise";
+        const char *const kOpType = "FusedElementwise";
+        const char *const kInnerNodeName = "inner_fused_elementwise";
+        const char *const kConstType = "Const";
+        // TF shapes of the outputs of a node, one list of dims per output
+        const char *const kOutputShapesAttr = "_output_shapes";
+        // the kernel keeps one block per input, constant and result
+        const size_t kMaxFusedValues = 64;
+
+        // TF op types of a chain and their opcodes, numbered as in op_proto/fused_elementwise.h
+        const std::map<std::string, int64_t> kFusedOpcodes = {
+            {"Abs", 0}, {"Neg", 1}, {"Relu", 2}, {"Exp", 3}, {"Add", 4}, {"AddV2", 4},
+            {"Sub", 5}, {"Mul", 6}, {"RealDiv", 7}, {"Maximum", 8}, {"Minimum", 9}
+        };
+        const int64_t kFirstBinaryOpcode = 4;
+
+        // operand of an instruction before the values are numbered
+        struct ChainOperand {
+            enum Kind { INPUT, CONSTANT, RESULT } kind;
+            int64_t index;
+        };
+
+        using NodesMap = std::unordered_map<std::string, ge::OperatorPtr>;
+
+        struct FusedChain {
+            std::vector<std::pair<int64_t, std::vector<ChainOperand>>> instrs;
+            std::vector<float> constants;
+            // TF dims of every constant, all of one element
+            std::vector<std::vector<int64_t>> constant_dims;
+            // node and input index of every edge entering the scope, in fused input order
+            std::vector<std::pair<std::string, int32_t>> inputs;
+            std::string output;
+
+            std::vector<int64_t> Program() const {
+                int64_t first_constant = static_cast<int64_t>(inputs.size());
+                int64_t first_result = first_constant + static_cast<int64_t>(constants.size());
+                std::vector<int64_t> program;
+                for (const auto &instr : instrs) {
+                    program.push_back(instr.first);
+                    for (const ChainOperand &operand : instr.second) {
+                        int64_t base = (operand.kind == ChainOperand::INPUT) ? 0 :
+                            ((operand.kind == ChainOperand::CONSTANT) ? first_constant : first_result);
+                        program.push_back(base + operand.index);
+                    }
+                    if (instr.second.size() == 1) {
+                        program.push_back(-1);
+                    }
+                }
+                return program;
+            }
+        };
+
+        // "scope/node:1" and "^scope/node" both name the producer "scope/node"
+        std::string ProducerName(const std::string &input_name) {
+            std::string name = (!input_name.empty() && input_name[0] == '^') ? input_name.substr(1) : input_name;
+            size_t colon = name.rfind(':');
+            return (colon == std::string::npos) ? name : name.substr(0, colon);
+        }
+
+        // output index of the producer in "scope/node:1", 0 without one
+        int32_t ProducerPort(const std::string &input_name) {
+            size_t colon = input_name.rfind(':');
+            return (colon == std::string::npos) ? 0 : std::atoi(input_name.c_str() + colon + 1);
+        }
+
+        bool IsSingleElement(const std::vector<int64_t> &dims) {
+            for (int64_t dim : dims) {
+                if (dim != 1) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /*
+         * A const folds into the program only when it holds a single float. A
+         * uniform const of more elements also sets the shape of the result,
+         * which a scalar in the program would lose.
+         */
+        Status ParseScalarConst(const ge::OperatorPtr &node, float &value, std::vector<int64_t> &dims) {
+            ge::Tensor tensor;
+            if (node->GetAttr("value", tensor) != ge::GRAPH_SUCCESS ||
+                tensor.GetTensorDesc().GetDataType() != ge::DT_FLOAT || tensor.GetSize() != sizeof(float)) {
+                return FAILED;
+            }
+            dims = tensor.GetTensorDesc().GetShape().GetDims();
+            if (!IsSingleElement(dims)) {
+                return FAILED;
+            }
+            value = *reinterpret_cast<const float *>(tensor.GetData());
+            return SUCCESS;
+        }
+
+        // TF dims of the edge input_name, false when the graph does not record them or they are not static
+        bool ReadEdgeDims(const NodesMap &graph_nodes, const std::string &input_name, std::vector<int64_t> &dims) {
+            auto producer = graph_nodes.find(ProducerName(input_name));
+            if (producer == graph_nodes.end() || producer->second == nullptr) {
+                return false;
+            }
+            std::vector<std::vector<int64_t>> output_shapes;
+            int32_t port = ProducerPort(input_name);
+            if (producer->second->GetAttr(kOutputShapesAttr, output_shapes) != ge::GRAPH_SUCCESS || port < 0 ||
+                static_cast<size_t>(port) >= output_shapes.size()) {
+                return false;
+            }
+            dims = output_shapes[port];
+            for (int64_t dim : dims) {
+                if (dim < 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /*
+         * FusedElementwise takes inputs of the shape of y or of a single
+         * element, y taking the dims of the first input of more than one, so
+         * a chain only fuses when TF gives it exactly that. General broadcasts
+         * such as Add(x[N, C], bias[C]) stay unfused, and so do single elements
+         * of a higher rank than y, which would grow the TF result.
+         */
+        Status CheckChainShapes(const FusedChain &chain, const std::vector<ge::OperatorPtr> &nodes,
+                                const NodesMap &graph_nodes) {
+            std::map<std::string, ge::OperatorPtr> inner;
+            for (const auto &node : nodes) {
+                inner[node->GetName()] = node;
+            }
+            std::vector<std::vector<int64_t>> input_dims;
+            for (const auto &edge : chain.inputs) {
+                std::string input_name = inner[edge.first]->GetInputDesc(edge.second).GetName();
+                std::vector<int64_t> dims;
+                if (!ReadEdgeDims(graph_nodes, input_name, dims)) {
+                    OP_LOGI(kOpType, "Shape of %s is not known.", input_name.c_str());
+                    return FAILED;
+                }
+                input_dims.push_back(dims);
+            }
+            if (input_dims.empty()) {
+                return FAILED;
+            }
+            std::vector<int64_t> y_dims = input_dims[0];
+            for (const auto &dims : input_dims) {
+                if (IsSingleElement(dims)) {
+                    continue;
+                }
+                if (IsSingleElement(y_dims)) {
+                    y_dims = dims;
+                } else if (dims != y_dims) {
+                    OP_LOGI(kOpType, "Inputs of %s broadcast.", chain.output.c_str());
+                    return FAILED;
+                }
+            }
+            std::vector<std::vector<int64_t>> single_dims = chain.constant_dims;
+            single_dims.insert(single_dims.end(), input_dims.begin(), input_dims.end());
+            for (const auto &dims : single_dims) {
+                if (dims.size() > y_dims.size()) {
+                    OP_LOGI(kOpType, "A single element of rank %zu widens %s.", dims.size(), chain.output.c_str());
+                    return FAILED;
+                }
+            }
+            return SUCCESS;
+        }
+
+        // the scope is replaced as a whole, so only its output may feed nodes outside it
+        Status CheckOnlyOutputLeaves(const std::vector<ge::OperatorPtr> &nodes, const std::string &output,
+                                     const NodesMap &graph_nodes) {
+            std::set<std::string> inner;
+            for (const auto &node : nodes) {
+                inner.insert(node->GetName());
+            }
+            for (const auto &entry : graph_nodes) {
+                if (entry.second == nullptr || inner.count(entry.first) != 0) {
+                    continue;
+                }
+                for (size_t i = 0; i < entry.second->GetInputsSize(); ++i) {
+                    std::string producer = ProducerName(entry.second->GetInputDesc(i).GetName());
+                    if (producer != output && inner.count(producer) != 0) {
+                        OP_LOGI(kOpType, "%s is also consumed by %s.", producer.c_str(), entry.first.c_str());
+                        return FAILED;
+                    }
+                }
+            }
+            return SUCCESS;
+        }
+
+        class ChainBuilder {
+        public:
+            explicit ChainBuilder(FusedChain &chain) : chain_(chain) {}
+
+            Status Build(const std::vector<ge::OperatorPtr> &nodes) {
+                std::set<std::string> consumed;
+                for (const auto &node : nodes) {
+                    if (node == nullptr) {
+                        OP_LOGE(kOpType, "Inner operator is nullptr.");
+                        return FAILED;
+                    }
+                    nodes_[node->GetName()] = node;
+                    if (node->GetOpType() == kConstType) {
+                        continue;
+                    }
+                    if (kFusedOpcodes.count(node->GetOpType()) == 0) {
+                        OP_LOGI(kOpType, "%s of type %s is not elementwise.", node->GetName().c_str(),
+                                node->GetOpType().c_str());
+                        return FAILED;
+                    }
+                    ge::DataType dtype = ge::DT_FLOAT;
+                    if (node->GetAttr("T", dtype) == ge::GRAPH_SUCCESS && dtype != ge::DT_FLOAT &&
+                        dtype != ge::DT_FLOAT16 && dtype != ge::DT_DOUBLE) {
+                        OP_LOGI(kOpType, "%s is not of a float type.", node->GetName().c_str());
+                        return FAILED;
+                    }
+                    ++op_nodes_;
+                    for (size_t i = 0; i < node->GetInputsSize(); ++i) {
+                        consumed.insert(ProducerName(node->GetInputDesc(i).GetName()));
+                    }
+                }
+
+                // the chain has a single result, every other op feeds it
+                for (const auto &node : nodes) {
+                    if (node->GetOpType() != kConstType && consumed.count(node->GetName()) == 0) {
+                        if (!chain_.output.empty()) {
+                            OP_LOGI(kOpType, "Both %s and %s leave the scope.", chain_.output.c_str(),
+                                    node->GetName().c_str());
+                            return FAILED;
+                        }
+                        chain_.output = node->GetName();
+                    }
+                }
+                if (chain_.output.empty()) {
+                    return FAILED;
+                }
+                ChainOperand result;
+                if (Visit(chain_.output, result) != SUCCESS || static_cast<int64_t>(results_.size()) != op_nodes_) {
+                    return FAILED;
+                }
+                size_t values = chain_.inputs.size() + chain_.constants.size() + chain_.instrs.size();
+                return (values <= kMaxFusedValues) ? SUCCESS : FAILED;
+            }
+
+        private:
+            // post-order walk from the output, so every operand is numbered before its user
+            Status Visit(const std::string &name, ChainOperand &operand) {
+                auto done = results_.find(name);
+                if (done != results_.end()) {
+                    operand = done->second;
+                    return SUCCESS;
+                }
+                const ge::OperatorPtr &node = nodes_[name];
+                int64_t opcode = kFusedOpcodes.at(node->GetOpType());
+                size_t arity = (opcode < kFirstBinaryOpcode) ? 1 : 2;
+                if (node->GetInputsSize() != arity) {
+                    return FAILED;
+                }
+                std::vector<ChainOperand> operands;
+                for (size_t i = 0; i < arity; ++i) {
+                    std::string producer = ProducerName(node->GetInputDesc(i).GetName());
+                    auto inner = nodes_.find(producer);
+                    ChainOperand input;
+                    if (inner == nodes_.end()) {
+                        input.kind = ChainOperand::INPUT;
+                        input.index = static_cast<int64_t>(chain_.inputs.size());
+                        chain_.inputs.emplace_back(name, static_cast<int32_t>(i));
+                    } else if (inner->second->GetOpType() == kConstType) {
+                        float value = 0.0f;
+                        std::vector<int64_t> dims;
+                        if (ParseScalarConst(inner->second, value, dims) != SUCCESS) {
+                            OP_LOGI(kOpType, "Const %s is not a scalar.", producer.c_str());
+                            return FAILED;
+                        }
+                        input.kind = ChainOperand::CONSTANT;
+                        input.index = static_cast<int64_t>(chain_.constants.size());
+                        chain_.constants.push_back(value);
+                        chain_.constant_dims.push_back(dims);
+                    } else if (Visit(producer, input) != SUCCESS) {
+                        return FAILED;
+                    }
+                    operands.push_back(input);
+                }
+                operand.kind = ChainOperand::RESULT;
+                operand.index = static_cast<int64_t>(chain_.instrs.size());
+                chain_.instrs.emplace_back(opcode, operands);
+                results_[name] = operand;
+                return SUCCESS;
+            }
+
+            FusedChain &chain_;
+            std::map<std::string, ge::OperatorPtr> nodes_;
+            std::map<std::string, ChainOperand> results_;
+            int64_t op_nodes_ = 0;
+        };
+
+        std::vector<ge::OperatorPtr> ScopeNodes(const Scope *scope) {
+            std::vector<ge::OperatorPtr> nodes;
+            for (const auto &node_info : scope->AllNodesMap()) {
+                nodes.emplace_back(node_info.second);
+            }
+            return nodes;
+        }
+    }  // namespace
+
+    std::vector<ScopeFusionPatterns> FusedElementwiseScopeFusionPass::DefinePatterns() {
+        std::vector<ScopeFusionPatterns> patterns_list;
+        ScopeFusionPatterns pattern;
+        GenScopePatterns(pattern);
+        patterns_list.push_back(pattern);
+        return patterns_list;
+    }
+
+    void FusedElementwiseScopeFusionPass::GenScopePatterns(ScopeFusionPatterns &patterns) {
+        std::vector<ScopePattern *> batch;
+        ScopePattern *chain_pattern = new(std::nothrow) ScopePattern();
+        if (chain_pattern == nullptr) {
+            OP_LOGE(kOpType, "Alloc an object failed.");
+            return;
+        }
+        // candidates hold at least one Add, LastMatchScopesAndOPs checks the rest is a chain
+        chain_pattern->SetSubType(kScopeTypeFusedElementwise);
+        chain_pattern->AddNodeOpTypeFeature(NodeOpTypeFeature("Add", 0, 1));  // Add num is n
+
+        OP_LOGI(kOpType, "Add GenScopePatterns FusedElementwise.");
+        batch.push_back(chain_pattern);
+        patterns.push_back(batch);
+    }
+
+    std::string FusedElementwiseScopeFusionPass::PassName() {
+        return std::string("FusedElementwiseScopeFusionPass");
+    }
+
+    Status FusedElementwiseScopeFusionPass::LastMatchScopesAndOPs(shared_ptr<ScopeGraph> &scope_graph,
+                                                                  std::vector<ScopesResult> &results) {
+        OP_LOGI(kOpType, "LastMatchScopesAndOPs start.");
+        if (scope_graph == nullptr) {
+            OP_LOGE(kOpType, "Input params is nullptr.");
+            return FAILED;
+        }
+        const ScopeTree *scope_tree = scope_graph->GetScopeTree();
+        if (scope_tree == nullptr) {
+            OP_LOGE(kOpType, "Scope tree is nullptr.");
+            return FAILED;
+        }
+        const std::vector<Scope *> &scopes = scope_tree->GetAllScopes();
+        const NodesMap &graph_nodes = scope_graph->GetNodesMap();
+
+        for (auto &scope : scopes) {
+            // Class ScopeTree guarantees scope is not empty.
+            if (scope->SubType() != kScopeTypeFusedElementwise) {
+                continue;
+            }
+            std::vector<ge::OperatorPtr> nodes = ScopeNodes(scope);
+            FusedChain chain;
+            if (ChainBuilder(chain).Build(nodes) != SUCCESS ||
+                CheckOnlyOutputLeaves(nodes, chain.output, graph_nodes) != SUCCESS ||
+                CheckChainShapes(chain, nodes, graph_nodes) != SUCCESS) {
+                OP_LOGI(kOpType, "Scope %s is not an elementwise chain.", scope->Name().c_str());
+                continue;
+            }
+            OP_LOGI(kOpType, "FusedElementwise LastMatchScopesAndOPs match scope %s.", scope->Name().c_str());
+            ScopesResult result;
+            std::vector<Scope *> result_scopes;
+            result_scopes.push_back(scope);
+            result.SetScopes(result_scopes);
+            result.SetNodes(nodes);
+            results.push_back(result);
+        }
+        return (!(results.empty())) ? SUCCESS : FAILED;
+    }
+
+    void FusedElementwiseScopeFusionPass::GenerateFusionResult(const std::vector<Scope *> &scopes,
+                                                               FusionScopesResult *fusion_rlt) {
+        if (fusion_rlt == nullptr) {
+            return;
+        }
+        FusedChain chain;
+        if (scopes.size() != 1 || ChainBuilder(chain).Build(fusion_rlt->Nodes()) != SUCCESS) {
+            fusion_rlt->SetType(kScopeInvalidType);
+            return;
+        }
+
+        // scope edges of one node go in one call, unmapped indices stay internal
+        std::map<std::string, std::vector<int32_t>> input_map;
+        for (size_t k = 0; k < chain.inputs.size(); ++k) {
+            std::vector<int32_t> &indices = input_map[chain.inputs[k].first];
+            size_t index = static_cast<size_t>(chain.inputs[k].second);
+            if (indices.size() <= index) {
+                indices.resize(index + 1, kFusionDisableIndex);
+            }
+            indices[index] = static_cast<int32_t>(k);
+        }
+        for (const auto &node_inputs : input_map) {
+            fusion_rlt->InsertInputs(node_inputs.first, node_inputs.second);
+        }
+        fusion_rlt->InsertOutputs(chain.output, {0});
+
+        fusion_rlt->SetType(kScopeToMultiNodes);
+        std::string scope_name = scopes[0]->Name();
+        fusion_rlt->SetName(scope_name.substr(0, scope_name.length() - 1));
+        fusion_rlt->SetDescription("");
+
+        auto fused = fusion_rlt->AddInnerNode(kInnerNodeName, kOpType);
+        CHECK_INNER_NODE_CONDITION(fused != nullptr, fusion_rlt);
+        for (size_t k = 0; k < chain.inputs.size(); ++k) {
+            fused->InsertInput(kInputFromFusionScope, static_cast<int32_t>(k));
+        }
+        Status ret = fused->InsertOutput(kOutputToFusionScope, 0).BuildInnerNode();
+        CHECK_INNER_NODE_CONDITION(ret == ge::GRAPH_SUCCESS, fusion_rlt);
+        fused->MutableOperator()->SetAttr("program", chain.Program());
+        fused->MutableOperator()->SetAttr("constants", chain.constants);
+
+        ret = fusion_rlt->CheckInnerNodesInfo();
+        CHECK_INNER_NODE_CONDITION(ret == ge::GRAPH_SUCCESS, fusion_rlt);
+
+        OP_LOGI(kOpType, "Set fusion result successfully, %zu instructions.", chain.instrs.size());
+        return;
+    }
+
+    REGISTER_SCOPE_FUSION_PASS("FusedElementwiseScopeFusionPass", FusedElementwiseScopeFusionPass, false);
+}  // namespace ge
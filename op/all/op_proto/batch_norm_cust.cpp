@@ -0,0 +1,64 @@
+/**
+ * Copyright (C)  2020. Huawei Technologies Co., Ltd. All rights reserved.
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Apache License Version 2.0.You may not use this file except in compliance with the License.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Apache License for more details at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * @file batch_norm_cust.cpp
+ *
+ * @brief
+ *
+ * @version 1.0
+ *
+ */
+#include "./batch_norm_cust.h"
+#include <string>
+#include <vector>
+#include "./broadcast_infer.h"
+
+namespace ge {
+IMPLEMT_VERIFIER(BatchNormCust, BatchNormCustVerify)
+{
+  std::string data_format = "NCHW";
+  (void)op.GetAttr("data_format", data_format);
+  if (data_format != "NCHW" && data_format != "NHWC") {
+    return GRAPH_FAILED;
+  }
+  TensorDesc x_desc = op.GetInputDesc("x");
+  TensorDesc gamma_desc = op.GetInputDesc("gamma");
+  TensorDesc beta_desc = op.GetInputDesc("beta");
+  DataType dtype = x_desc.GetDataType();
+  if (gamma_desc.GetDataType() != dtype || beta_desc.GetDataType() != dtype) {
+    return GRAPH_FAILED;
+  }
+
+  // gamma and beta hold one value per channel of x
+  std::vector<int64_t> x_dims = x_desc.GetShape().GetDims();
+  if (x_dims.size() < 2) {
+    return GRAPH_FAILED;
+  }
+  int64_t channels = (data_format == "NHWC") ? x_dims.back() : x_dims[1];
+  if (gamma_desc.GetShape().GetShapeSize() != channels || beta_desc.GetShape().GetShapeSize() != channels) {
+    return GRAPH_FAILED;
+  }
+  return GRAPH_SUCCESS;
+}
+
+IMPLEMT_COMMON_INFERFUNC(BatchNormCustInferShape)
+{
+  (void)InferElementwiseShapeAndType(op, "x", "y");
+  return GRAPH_SUCCESS;
+}
+
+//Registered inferfunction
+COMMON_INFER_FUNC_REG(BatchNormCust, BatchNormCustInferShape);
+
+//Registered verify function
+VERIFY_FUNC_REG(BatchNormCust, BatchNormCustVerify);
+}
@@ -0,0 +1,50 @@
+/**
+ * Copyright (C)  2020. Huawei Technologies Co., Ltd. All rights reserved.
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Apache License Version 2.0.You may not use this file except in compliance with the License.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Apache License for more details at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * @file batch_norm_cust.h
+ *
+ * @brief
+ *
+ * @version 1.0
+ *
+ */
+#ifndef GE_OP_BATCH_NORM_CUST_H
+#define GE_OP_BATCH_NORM_CUST_H
+#include "graph/operator_reg.h"
+
+namespace ge {
+/**
+ * *@brief Normalizes x per channel as y = (x - gamma) / beta, the function of
+ * the single-op BatchNorm tiling modes, for any NCHW or NHWC shape.
+ *
+ * *@par Inputs:
+ * *x:A Tensor of at least 2 dims, channels on axis 1 for NCHW and on the last axis for NHWC.
+ * *gamma:A 1D Tensor of the type of x, the mean of each channel.
+ * *beta:A 1D Tensor of the type of x, the variance of each channel.
+ *
+ * *@par Attributes:
+ * *data_format:"NCHW" or "NHWC".
+ *
+ * *@par Outputs:
+ * *y:A Tensor of the shape and type of x.
+ */
+REG_OP(BatchNormCust)
+    .INPUT(x, TensorType({DT_FLOAT16, DT_FLOAT}))
+    .INPUT(gamma, TensorType({DT_FLOAT16, DT_FLOAT}))
+    .INPUT(beta, TensorType({DT_FLOAT16, DT_FLOAT}))
+    .OUTPUT(y, TensorType({DT_FLOAT16, DT_FLOAT}))
+    .ATTR(data_format, String, "NCHW")
+    .OP_END_FACTORY_REG(BatchNormCust)
+
+}  // namespace ge
+
+#endif  // GE_OP_BATCH_NORM_CUST_H
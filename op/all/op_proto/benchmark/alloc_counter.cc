@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: heap allocation counter of the op proto benchmarks
+ */
+
+#include "alloc_counter.h"
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+
+namespace {
+std::atomic<int64_t> g_alloc_count(0);
+}
+
+int64_t HeapAllocCount()
+{
+    return g_alloc_count.load(std::memory_order_relaxed);
+}
+
+// new[] and the nothrow forms all end up here
+void *operator new(size_t size)
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
@@ -0,0 +1,13 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: heap allocation counter of the op proto benchmarks
+ */
+
+#ifndef _GE_HOST_ALLOC_COUNTER_H_
+#define _GE_HOST_ALLOC_COUNTER_H_
+
+#include <stdint.h>
+
+// operator new calls so far, alloc_counter.cc replaces the global one for the whole benchmark
+int64_t HeapAllocCount();
+#endif
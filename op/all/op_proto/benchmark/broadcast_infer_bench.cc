@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: benchmark of InferBroadcastShapeAndType against the vector based Add infer
+ *
+ * Infers Add over shape pairs two ways, through the host stand-in of the
+ * graph engine operator:
+ *   vector: the infer Add had before broadcast_infer.h, copying both dim
+ *           vectors, padding the shorter one with insert(begin) and
+ *           growing the output with push_back
+ *   fixed:  InferBroadcastShapeAndType, reading dims into SmallVector and
+ *           walking them aligned at the last dim
+ * and the broadcast alone, without the operator around it. Every heap
+ * allocation is counted, those the stand-in makes for the descs included.
+ * Usage: broadcast_infer_bench
+ */
+
+#include <stdio.h>
+#include <chrono>
+#include <vector>
+#include "add.h"
+#include "alloc_counter.h"
+#include "broadcast_infer.h"
+
+namespace {
+const int kRepeatTimes = 20;
+const int64_t kInnerCalls = 20000;
+
+struct BenchCase {
+    const char *name;
+    std::vector<int64_t> x1;
+    std::vector<int64_t> x2;
+};
+
+const BenchCase kBenchCases[] = {
+    {"same_4d", {1, 256, 52, 52}, {1, 256, 52, 52}},
+    {"bias_4d", {1, 256, 52, 52}, {256, 1, 1}},
+    {"scalar_2d", {8, 1024}, {1}},
+    {"outer_5d", {1, 1, 1, 64, 64}, {16, 3, 8, 1, 64}},
+};
+
+std::vector<int64_t> VectorBroadcast(const std::vector<int64_t> &x1, const std::vector<int64_t> &x2, bool &ok)
+{
+    std::vector<int64_t> dimsX = x1;
+    std::vector<int64_t> dimsY = x2;
+    if (dimsX.size() < dimsY.size()) {
+        std::vector<int64_t> dimsTmp = dimsX;
+        dimsX = dimsY;
+        dimsY = dimsTmp;
+    }
+    if (dimsX.size() != dimsY.size()) {
+        int dec = dimsX.size() - dimsY.size();
+        for (int i = 0; i < dec; i++) {
+            dimsY.insert(dimsY.begin(), (int64_t)1);
+        }
+    }
+    std::vector<int64_t> dimVec;
+    ok = true;
+    for (size_t i = 0; i < dimsX.size(); i++) {
+        if ((dimsX[i] != dimsY[i]) && (dimsX[i] != 1) && (dimsY[i] != 1)) {
+            ok = false;
+            break;
+        }
+        dimVec.push_back(dimsX[i] > dimsY[i] ? dimsX[i] : dimsY[i]);
+    }
+    return dimVec;
+}
+
+// the vector based infer, as Add had it for static shapes
+__attribute__((noinline)) bool VectorInferShapeAndType(ge::Operator &op)
+{
+    ge::TensorDesc vOutputDesc = op.GetOutputDesc("y");
+    ge::DataType input_dtype = op.GetInputDesc("x1").GetDataType();
+    ge::Format input_format = op.GetInputDesc("x1").GetFormat();
+    ge::Shape shapeX = op.GetInputDesc("x1").GetShape();
+    ge::Shape shapeY = op.GetInputDesc("x2").GetShape();
+    bool ok = false;
+    std::vector<int64_t> dimVec = VectorBroadcast(shapeX.GetDims(), shapeY.GetDims(), ok);
+    if (!ok) {
+        return false;
+    }
+    vOutputDesc.SetShape(ge::Shape(dimVec));
+    vOutputDesc.SetDataType(input_dtype);
+    vOutputDesc.SetFormat(input_format);
+    op.UpdateOutputDesc("y", vOutputDesc);
+    return true;
+}
+
+__attribute__((noinline)) bool FixedInferShapeAndType(ge::Operator &op)
+{
+    return ge::InferBroadcastShapeAndType(op, "x1", "x2", "y");
+}
+
+struct Measure {
+    double ns;
+    double allocs;
+};
+
+// best of kRepeatTimes, per call
+template <typename Func>
+Measure MeasureCall(const Func &run)
+{
+    Measure best = {0.0, 0.0};
+    for (int i = 0; i < kRepeatTimes; ++i) {
+        int64_t allocs = HeapAllocCount();
+        auto begin = std::chrono::steady_clock::now();
+        for (int64_t j = 0; j < kInnerCalls; ++j) {
+            run();
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / kInnerCalls;
+        if (i == 0 || ns < best.ns) {
+            best.ns = ns;
+        }
+        best.allocs = static_cast<double>(HeapAllocCount() - allocs) / kInnerCalls;
+    }
+    return best;
+}
+
+void PrintRow(const char *name, const char *level, const Measure &vec, const Measure &fixed)
+{
+    printf("%-10s %-6s %12.1f %10.1f %12.1f %10.1f %8.2fx\n", name, level, vec.ns, vec.allocs, fixed.ns,
+        fixed.allocs, vec.ns / fixed.ns);
+}
+}
+
+int main()
+{
+    printf("%-10s %-6s %12s %10s %12s %10s %9s\n", "case", "level", "vector ns", "allocs", "fixed ns", "allocs",
+        "speedup");
+    for (const BenchCase &bench : kBenchCases) {
+        ge::op::Add op;
+        op.UpdateInputDesc("x1", ge::TensorDesc(ge::Shape(bench.x1), ge::FORMAT_ND, ge::DT_FLOAT16));
+        op.UpdateInputDesc("x2", ge::TensorDesc(ge::Shape(bench.x2), ge::FORMAT_ND, ge::DT_FLOAT16));
+        if (!VectorInferShapeAndType(op)) {
+            printf("%-10s shapes do not broadcast\n", bench.name);
+            return -1;
+        }
+        std::vector<int64_t> expected = op.GetOutputDesc("y").GetShape().GetDims();
+        if (!FixedInferShapeAndType(op) || op.GetOutputDesc("y").GetShape().GetDims() != expected) {
+            printf("%-10s InferBroadcastShapeAndType disagrees\n", bench.name);
+            return -1;
+        }
+        Measure vec_infer = MeasureCall([&]() { VectorInferShapeAndType(op); });
+        Measure fixed_infer = MeasureCall([&]() { FixedInferShapeAndType(op); });
+        PrintRow(bench.name, "infer", vec_infer, fixed_infer);
+
+        ge::ShapeDims dims1;
+        ge::ShapeDims dims2;
+        ge::ShapeDims dims;
+        ge::GetShapeDims(ge::Shape(bench.x1), dims1);
+        ge::GetShapeDims(ge::Shape(bench.x2), dims2);
+        volatile bool sink = false;
+        Measure vec_core = MeasureCall([&]() {
+            bool ok = false;
+            sink = !VectorBroadcast(bench.x1, bench.x2, ok).empty() && ok;
+        });
+        Measure fixed_core = MeasureCall([&]() { sink = ge::BroadcastDims(dims1, dims2, dims); });
+        PrintRow(bench.name, "core", vec_core, fixed_core);
+    }
+    return 0;
+}
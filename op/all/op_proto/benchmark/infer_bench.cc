@@ -0,0 +1,343 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host micro-benchmark of the op proto infer and verify functions
+ *
+ * Every op gets kCasesPerOp prepared operators drawn from the shapes the
+ * sample networks run at, batch 1 most often, and its registered infer
+ * and verify functions are timed over all of them in turn. Reports ns and
+ * heap allocations per call; the descs the Operator stand-in copies count
+ * as they would in the graph engine.
+ * Usage: infer_bench [--op=<op type>] [--repeat=<n>]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "add.h"
+#include "alloc_counter.h"
+#include "batch_norm_cust.h"
+#include "conv2d_tik.h"
+#include "fused_elementwise.h"
+#include "leaky_relu_demo.h"
+#include "matmul_tik.h"
+#include "permute_tik.h"
+#include "reshape_cust.h"
+#include "scatter_nd_add.h"
+#include "upsample_tik.h"
+
+namespace {
+const size_t kCasesPerOp = 64;
+// calls timed per repeat, whole passes over the cases
+const int64_t kCallsPerRepeat = 16 * 1024;
+
+const int64_t kBatches[] = {1, 1, 1, 1, 2, 4, 8, 16, 32};
+const int64_t kChannels[] = {32, 64, 128, 256, 512, 1024};
+const int64_t kFeatureMaps[] = {13, 19, 26, 38, 52, 76, 104};
+const int64_t kMatmulSizes[] = {64, 128, 256, 512, 768, 1024, 2048, 4096};
+const int64_t kKernelSizes[] = {1, 1, 3, 3, 3, 5};
+// x1 and x2 dtypes of the matmul_tik.ini entries, float16 most often
+const ge::DataType kMatmulTypes[][2] = {
+    {ge::DT_FLOAT16, ge::DT_FLOAT16}, {ge::DT_FLOAT16, ge::DT_FLOAT16}, {ge::DT_INT8, ge::DT_INT8},
+    {ge::DT_UINT8, ge::DT_INT8}
+};
+
+struct BenchOptions {
+    std::string op_type;
+    int repeat = 20;
+};
+
+typedef std::vector<std::unique_ptr<ge::Operator>> OpCases;
+typedef std::unique_ptr<ge::Operator> (*CaseMaker)(std::mt19937 &rng);
+// checks what the infer function set beyond its status, nullptr when there is nothing to check
+typedef bool (*InferCheck)(const ge::Operator &op);
+
+struct InferBench {
+    const char *op_type;
+    CaseMaker make_case;
+    InferCheck check;
+};
+
+template <typename T, size_t N>
+T Pick(std::mt19937 &rng, const T (&values)[N])
+{
+    return values[std::uniform_int_distribution<size_t>(0, N - 1)(rng)];
+}
+
+ge::TensorDesc Desc(const std::vector<int64_t> &dims, ge::DataType dtype = ge::DT_FLOAT16,
+                    ge::Format format = ge::FORMAT_NCHW)
+{
+    return ge::TensorDesc(ge::Shape(dims), format, dtype);
+}
+
+// a yolo or ssd feature map, [n, c, h, w]
+std::vector<int64_t> FeatureMap(std::mt19937 &rng)
+{
+    int64_t size = Pick(rng, kFeatureMaps);
+    return {Pick(rng, kBatches), Pick(rng, kChannels), size, size};
+}
+
+std::unique_ptr<ge::Operator> MakeAdd(std::mt19937 &rng)
+{
+    std::unique_ptr<ge::op::Add> op(new ge::op::Add());
+    std::vector<int64_t> x1 = FeatureMap(rng);
+    // residual adds, per-channel biases and scalars
+    std::vector<std::vector<int64_t>> x2s = {x1, {x1[1], 1, 1}, {1}};
+    op->update_input_desc_x1(Desc(x1));
+    op->update_input_desc_x2(Desc(x2s[std::uniform_int_distribution<size_t>(0, x2s.size() - 1)(rng)]));
+    return op;
+}
+
+std::unique_ptr<ge::Operator> MakeBatchNormCust(std::mt19937 &rng)
+{
+    std::unique_ptr<ge::op::BatchNormCust> op(new ge::op::BatchNormCust());
+    std::vector<int64_t> x = FeatureMap(rng);
+    op->update_input_desc_x(Desc(x));
+    op->update_input_desc_gamma(Desc({x[1]}));
+    op->update_input_desc_beta(Desc({x[1]}));
+    return op;
+}
+
+std::unique_ptr<ge::Operator> MakeConv2DTik(std::mt19937 &rng)
+{
+    std::unique_ptr<ge::op::Conv2DTik> op(new ge::op::Conv2DTik());
+    std::vector<int64_t> x = FeatureMap(rng);
+    int64_t kernel = Pick(rng, kKernelSizes);
+    int64_t stride = std::uniform_int_distribution<int64_t>(1, 2)(rng);
+    // a quarter of the layers are mobilenet style depthwise ones
+    bool depthwise = std::uniform_int_distribution<int>(0, 3)(rng) == 0;
+    op->update_input_desc_x(Desc(x));
+    if (depthwise) {
+        op->update_input_desc_filter(Desc({x[1], 1, kernel, kernel}));
+        op->set_attr_groups(x[1]);
+    } else {
+        op->update_input_desc_filter(Desc({Pick(rng, kChannels), x[1], kernel, kernel}));
+    }
+    op->set_attr_strides({1, 1, stride, stride});
+    op->set_attr_pads({kernel / 2, kernel / 2, kernel / 2, kernel / 2});
+    // the parser sets the output format before infer runs
+    op->update_output_desc_y(Desc({}, ge::DT_FLOAT16, ge::FORMAT_NCHW));
+    return op;
+}
+
+std::unique_ptr<ge::Operator> MakeFusedElementwise(std::mt19937 &rng)
+{
+    std::unique_ptr<ge::op::FusedElementwise> op(new ge::op::FusedElementwise());
+    std::vector<int64_t> x = FeatureMap(rng);
+    op->create_dynamic_input_x(2);
+    op->UpdateDynamicInputDesc("x", 0, Desc(x));
+    op->UpdateDynamicInputDesc("x", 1, Desc(x));
+    // relu(x0 + x1)
+    op->set_attr_program({4, 0, 1, 2, 2, -1});
+    return op;
+}
+
+std::unique_ptr<ge::Operator> MakeLeakyReluDemo(std::mt19937 &rng)
+{
+    std::unique_ptr<ge::op::LeakyReluDemo> op(new ge::op::LeakyReluDemo());
+    op->update_input_desc_x(Desc(FeatureMap(rng)));
+    return op;
+}
+
+std::unique_ptr<ge::Operator> MakeMatmulTik(std::mt19937 &rng)
+{
+    std::unique_ptr<ge::op::MatmulTik> op(new ge::op::MatmulTik());
+    int64_t m = Pick(rng, kMatmulSizes);
+    int64_t k = Pick(rng, kMatmulSizes);
+    int64_t n = Pick(rng, kMatmulSizes);
+    // a batch of attention heads times shared weights, given transposed half the time
+    int64_t batch = Pick(rng, kBatches);
+    bool transpose = std::bernoulli_distribution(0.5)(rng);
+    std::vector<int64_t> x1 = {m, k};
+    if (batch > 1) {
+        x1.insert(x1.begin(), batch);
+    }
+    const ge::DataType *types = kMatmulTypes[std::uniform_int_distribution<size_t>(0, 3)(rng)];
+    op->update_input_desc_x1(Desc(x1, types[0], ge::FORMAT_ND));
+    op->update_input_desc_x2(Desc(transpose ? std::vector<int64_t>{n, k} : std::vector<int64_t>{k, n},
+                                  types[1], ge::FORMAT_ND));
+    op->set_attr_transpose_x2(transpose);
+    return op;
+}
+
+// y takes output0.dtype of matmul_tik.ini: int32 for int8 and uint8, float for float16
+bool CheckMatmulTik(const ge::Operator &op)
+{
+    ge::DataType x1 = op.GetInputDesc("x1").GetDataType();
+    ge::DataType want = (x1 == ge::DT_FLOAT16) ? ge::DT_FLOAT : ge::DT_INT32;
+    return op.GetOutputDesc("y").GetDataType() == want;
+}
+
+std::unique_ptr<ge::Operator> MakePermuteTik(std::mt19937 &rng)
+{
+    std::unique_ptr<ge::op::PermuteTik> op(new ge::op::PermuteTik());
+    op->update_input_desc_x(Desc(FeatureMap(rng)));
+    // the ssd heads turn NCHW into NHWC
+    op->set_attr_order({0, 2, 3, 1});
+    return op;
+}
+
+std::unique_ptr<ge::Operator> MakeReshapeCust(std::mt19937 &rng)
+{
+    std::unique_ptr<ge::op::ReshapeCust> op(new ge::op::ReshapeCust());
+    std::vector<int64_t> x = FeatureMap(rng);
+    // flatten all but the batch, as ahead of the ssd concat
+    std::vector<int64_t> shape = {x[0], x[1] * x[2] * x[3]};
+    op->update_input_desc_tensor(Desc(x));
+    op->update_input_desc_shape(Desc({2}, ge::DT_INT64, ge::FORMAT_ND));
+    op->SetInputConstData("shape", ge::Tensor(Desc({2}, ge::DT_INT64, ge::FORMAT_ND),
+                                              reinterpret_cast<const uint8_t *>(shape.data()),
+                                              shape.size() * sizeof(int64_t)));
+    return op;
+}
+
+std::unique_ptr<ge::Operator> MakeScatterNdAdd(std::mt19937 &rng)
+{
+    std::unique_ptr<ge::op::ScatterNdAdd> op(new ge::op::ScatterNdAdd());
+    // embedding rows updated by a batch of indices
+    int64_t rows = Pick(rng, kMatmulSizes) * 64;
+    int64_t depth = Pick(rng, kChannels);
+    int64_t updates = Pick(rng, kMatmulSizes);
+    op->update_input_desc_var(Desc({rows, depth}, ge::DT_FLOAT, ge::FORMAT_ND));
+    op->update_input_desc_indices(Desc({updates, 1}, ge::DT_INT32, ge::FORMAT_ND));
+    op->update_input_desc_updates(Desc({updates, depth}, ge::DT_FLOAT, ge::FORMAT_ND));
+    return op;
+}
+
+std::unique_ptr<ge::Operator> MakeUpsampleTik(std::mt19937 &rng)
+{
+    std::unique_ptr<ge::op::UpsampleTik> op(new ge::op::UpsampleTik());
+    op->update_input_desc_x(Desc(FeatureMap(rng)));
+    return op;
+}
+
+const InferBench kInferBenches[] = {
+    {"Add", MakeAdd, nullptr},
+    {"BatchNormCust", MakeBatchNormCust, nullptr},
+    {"Conv2DTik", MakeConv2DTik, nullptr},
+    {"FusedElementwise", MakeFusedElementwise, nullptr},
+    {"LeakyReluDemo", MakeLeakyReluDemo, nullptr},
+    {"MatmulTik", MakeMatmulTik, CheckMatmulTik},
+    {"PermuteTik", MakePermuteTik, nullptr},
+    {"ReshapeCust", MakeReshapeCust, nullptr},
+    {"ScatterNdAdd", MakeScatterNdAdd, nullptr},
+    {"UpsampleTik", MakeUpsampleTik, nullptr},
+};
+
+bool ParseOptions(int argc, char *argv[], BenchOptions &options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        if (strncmp(arg, "--op=", 5) == 0) {
+            options.op_type = arg + 5;
+        } else if (strncmp(arg, "--repeat=", 9) == 0) {
+            options.repeat = std::max(1, atoi(arg + 9));
+        } else {
+            printf("Usage: %s [--op=<op type>] [--repeat=<n>]\n", argv[0]);
+            return false;
+        }
+    }
+    return true;
+}
+
+struct Measure {
+    double ns;
+    double allocs;
+};
+
+// best of repeat passes of kCallsPerRepeat calls, cycling through the cases
+Measure MeasureFunc(const ge::OpFunc &func, OpCases &cases, int repeat)
+{
+    Measure best = {0.0, 0.0};
+    for (int i = 0; i < repeat; ++i) {
+        int64_t allocs = HeapAllocCount();
+        auto begin = std::chrono::steady_clock::now();
+        for (int64_t call = 0; call < kCallsPerRepeat; ++call) {
+            (void)func(*cases[call % cases.size()]);
+        }
+        auto end = std::chrono::steady_clock::now();
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count() / kCallsPerRepeat;
+        if (i == 0 || ns < best.ns) {
+            best.ns = ns;
+        }
+        best.allocs = static_cast<double>(HeapAllocCount() - allocs) / kCallsPerRepeat;
+    }
+    return best;
+}
+
+// a failing case would time the error path instead of the infer
+bool CheckCases(const char *kind, const ge::OpFunc &func, OpCases &cases, const char *op_type,
+                InferCheck check = nullptr)
+{
+    for (size_t i = 0; i < cases.size(); ++i) {
+        if (func(*cases[i]) != ge::GRAPH_SUCCESS) {
+            printf("%-18s %s fails on case %zu\n", op_type, kind, i);
+            return false;
+        }
+        if (check != nullptr && !check(*cases[i])) {
+            printf("%-18s %s gives a wrong output desc on case %zu\n", op_type, kind, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+int RunBench(const InferBench &bench, const BenchOptions &options)
+{
+    auto infer = ge::InferFuncTable().find(bench.op_type);
+    if (infer == ge::InferFuncTable().end()) {
+        printf("%-18s no infer function registered\n", bench.op_type);
+        return 1;
+    }
+    std::mt19937 rng(20200101);
+    OpCases cases;
+    for (size_t i = 0; i < kCasesPerOp; ++i) {
+        cases.push_back(bench.make_case(rng));
+    }
+    auto verify = ge::VerifyFuncTable().find(bench.op_type);
+    bool has_verify = verify != ge::VerifyFuncTable().end();
+    if ((has_verify && !CheckCases("verify", verify->second, cases, bench.op_type)) ||
+        !CheckCases("infer", infer->second, cases, bench.op_type, bench.check)) {
+        return 1;
+    }
+
+    Measure infer_cost = MeasureFunc(infer->second, cases, options.repeat);
+    if (!has_verify) {
+        printf("%-18s %6zu %12.1f %10.1f %12s %10s\n", bench.op_type, cases.size(), infer_cost.ns, infer_cost.allocs,
+            "-", "-");
+        return 0;
+    }
+    Measure verify_cost = MeasureFunc(verify->second, cases, options.repeat);
+    printf("%-18s %6zu %12.1f %10.1f %12.1f %10.1f\n", bench.op_type, cases.size(), infer_cost.ns, infer_cost.allocs,
+        verify_cost.ns, verify_cost.allocs);
+    return 0;
+}
+}
+
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 1;
+    }
+    printf("%-18s %6s %12s %10s %12s %10s\n", "op", "cases", "infer ns", "allocs", "verify ns", "allocs");
+    int failed = 0;
+    bool found = false;
+    for (const InferBench &bench : kInferBenches) {
+        if (!options.op_type.empty() && options.op_type != bench.op_type) {
+            continue;
+        }
+        found = true;
+        failed += RunBench(bench, options);
+    }
+    if (!found) {
+        printf("no benchmark for op %s\n", options.op_type.c_str());
+        return 1;
+    }
+    return failed == 0 ? 0 : 1;
+}
@@ -0,0 +1,207 @@
+/**
+ * Copyright (C)  2020. Huawei Technologies Co., Ltd. All rights reserved.
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Apache License Version 2.0.You may not use this file except in compliance with the License.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Apache License for more details at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * @file broadcast_infer.cpp
+ *
+ * @brief
+ *
+ * @version 1.0
+ *
+ */
+#include "./broadcast_infer.h"
+#include <algorithm>
+
+namespace ge {
+namespace {
+// GE marks a dim it does not know with -1 and a shape of unknown rank with the single dim -2
+const int64_t kUnknownDim = -1;
+const int64_t kUnknownRank = -2;
+
+bool RangeHolds(const std::pair<int64_t, int64_t>& range, int64_t dim) {
+  return range.first <= dim && (range.second == kUnknownDim || dim <= range.second);
+}
+
+// widen range to cover other, valid tells whether range holds anything yet
+void UniteRange(std::pair<int64_t, int64_t>& range, bool& valid, const std::pair<int64_t, int64_t>& other) {
+  if (!valid) {
+    range = other;
+    valid = true;
+    return;
+  }
+  range.first = std::min(range.first, other.first);
+  range.second = (range.second == kUnknownDim || other.second == kUnknownDim) ? kUnknownDim :
+      std::max(range.second, other.second);
+}
+
+bool BroadcastRange(const std::pair<int64_t, int64_t>& x, const std::pair<int64_t, int64_t>& y,
+                    std::pair<int64_t, int64_t>& out) {
+  bool valid = false;
+  if (RangeHolds(x, 1)) {
+    UniteRange(out, valid, y);
+  }
+  if (RangeHolds(y, 1)) {
+    UniteRange(out, valid, x);
+  }
+  std::pair<int64_t, int64_t> both(std::max(x.first, y.first), x.second);
+  if (both.second == kUnknownDim || (y.second != kUnknownDim && y.second < both.second)) {
+    both.second = y.second;
+  }
+  if (both.second == kUnknownDim || both.first <= both.second) {
+    UniteRange(out, valid, both);
+  }
+  return valid;
+}
+}
+
+void GetShapeDims(const Shape& shape, ShapeDims& dims) {
+  size_t rank = shape.GetDimNum();
+  dims.resize(rank);
+  for (size_t i = 0; i < rank; i++) {
+    dims[i] = shape.GetDim(i);
+  }
+}
+
+bool IsUnknownRank(const ShapeDims& dims) {
+  return dims.size() == 1 && dims[0] == kUnknownRank;
+}
+
+bool IsUnknownShape(const ShapeDims& dims) {
+  for (size_t i = 0; i < dims.size(); i++) {
+    if (dims[i] < 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void GetShapeRanges(const TensorDesc& desc, const ShapeDims& dims, ShapeRanges& ranges) {
+  // static shapes never pay for reading the desc range
+  std::vector<std::pair<int64_t, int64_t>> desc_range;
+  if (IsUnknownShape(dims) && desc.GetShapeRange(desc_range) != GRAPH_SUCCESS) {
+    desc_range.clear();
+  }
+  ranges.resize(dims.size());
+  for (size_t i = 0; i < dims.size(); i++) {
+    if (dims[i] >= 0) {
+      ranges[i] = std::make_pair(dims[i], dims[i]);
+    } else if (desc_range.size() == dims.size()) {
+      ranges[i] = desc_range[i];
+    } else {
+      ranges[i] = std::make_pair(static_cast<int64_t>(1), kUnknownDim);
+    }
+  }
+}
+
+bool BroadcastDims(const ShapeDims& dims1, const ShapeDims& dims2, ShapeDims& dims) {
+  const ShapeDims& longer = (dims1.size() < dims2.size()) ? dims2 : dims1;
+  const ShapeDims& shorter = (dims1.size() < dims2.size()) ? dims1 : dims2;
+  size_t lead = longer.size() - shorter.size();
+  dims.resize(longer.size());
+  for (size_t i = 0; i < lead; i++) {
+    dims[i] = longer[i];
+  }
+  for (size_t i = lead; i < longer.size(); i++) {
+    int64_t dim1 = longer[i];
+    int64_t dim2 = shorter[i - lead];
+    if (dim1 != dim2 && dim1 != 1 && dim2 != 1 && dim1 >= 0 && dim2 >= 0) {
+      return false;
+    }
+    if (dim1 == 1 || (dim1 < 0 && dim2 != 1)) {
+      dims[i] = dim2;
+    } else {
+      dims[i] = dim1;
+    }
+  }
+  return true;
+}
+
+bool BroadcastRanges(const ShapeRanges& ranges1, const ShapeRanges& ranges2, ShapeRanges& ranges) {
+  const ShapeRanges& longer = (ranges1.size() < ranges2.size()) ? ranges2 : ranges1;
+  const ShapeRanges& shorter = (ranges1.size() < ranges2.size()) ? ranges1 : ranges2;
+  size_t lead = longer.size() - shorter.size();
+  ranges.resize(longer.size());
+  // against the implicit 1 of a missing dim the longer range stands as is
+  for (size_t i = 0; i < lead; i++) {
+    ranges[i] = longer[i];
+  }
+  for (size_t i = lead; i < longer.size(); i++) {
+    if (!BroadcastRange(longer[i], shorter[i - lead], ranges[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool InferBroadcastShapeAndType(Operator& op, const string& input_name1, const string& input_name2,
+                                const string& output_name) {
+  TensorDesc desc1 = op.GetInputDesc(input_name1);
+  TensorDesc desc2 = op.GetInputDesc(input_name2);
+  ShapeDims dims1;
+  ShapeDims dims2;
+  GetShapeDims(desc1.GetShape(), dims1);
+  GetShapeDims(desc2.GetShape(), dims2);
+  TensorDesc output_desc = op.GetOutputDesc(output_name);
+  output_desc.SetDataType(desc1.GetDataType());
+  output_desc.SetFormat(desc1.GetFormat());
+
+  if (IsUnknownRank(dims1) || IsUnknownRank(dims2)) {
+    // nothing is known of the output until both ranks are
+    output_desc.SetShape(Shape(std::vector<int64_t>(1, kUnknownRank)));
+  } else if (!IsUnknownShape(dims1) && !IsUnknownShape(dims2)) {
+    ShapeDims dims;
+    if (!BroadcastDims(dims1, dims2, dims)) {
+      return false;
+    }
+    output_desc.SetShape(Shape(dims.ToVector()));
+  } else {
+    ShapeRanges ranges1;
+    ShapeRanges ranges2;
+    ShapeRanges ranges;
+    GetShapeRanges(desc1, dims1, ranges1);
+    GetShapeRanges(desc2, dims2, ranges2);
+    if (!BroadcastRanges(ranges1, ranges2, ranges)) {
+      return false;
+    }
+    // a dim is known once its range is a single size, as for -1 against a known dim other than 1
+    ShapeDims dims;
+    dims.resize(ranges.size());
+    for (size_t i = 0; i < ranges.size(); i++) {
+      dims[i] = (ranges[i].first == ranges[i].second) ? ranges[i].first : kUnknownDim;
+    }
+    output_desc.SetShape(Shape(dims.ToVector()));
+    // a dynamic output lets a single build serve all its sizes
+    if (IsUnknownShape(dims)) {
+      output_desc.SetShapeRange(ranges.ToVector());
+    }
+  }
+  op.UpdateOutputDesc(output_name, output_desc);
+  return true;
+}
+
+bool InferElementwiseShapeAndType(Operator& op, const string& input_name, const string& output_name) {
+  TensorDesc input_desc = op.GetInputDesc(input_name);
+  TensorDesc output_desc = op.GetOutputDesc(output_name);
+  Shape shape = input_desc.GetShape();
+  output_desc.SetShape(shape);
+  output_desc.SetDataType(input_desc.GetDataType());
+  output_desc.SetFormat(input_desc.GetFormat());
+  ShapeDims dims;
+  GetShapeDims(shape, dims);
+  if (!IsUnknownRank(dims) && IsUnknownShape(dims)) {
+    ShapeRanges ranges;
+    GetShapeRanges(input_desc, dims, ranges);
+    output_desc.SetShapeRange(ranges.ToVector());
+  }
+  op.UpdateOutputDesc(output_name, output_desc);
+  return true;
+}
+}
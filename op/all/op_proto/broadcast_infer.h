@@ -0,0 +1,125 @@
+/**
+ * Copyright (C)  2020. Huawei Technologies Co., Ltd. All rights reserved.
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Apache License Version 2.0.You may not use this file except in compliance with the License.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Apache License for more details at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * @file broadcast_infer.h
+ *
+ * @brief shape inference shared by the elementwise ops
+ *
+ * @version 1.0
+ *
+ */
+
+#ifndef GE_OPS_OP_PROTO_BROADCAST_INFER_H_
+#define GE_OPS_OP_PROTO_BROADCAST_INFER_H_
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include "graph/operator_reg.h"
+
+namespace ge {
+// rank the helpers below keep inline, higher ones move to the heap
+const size_t kMaxShapeDims = 8;
+
+/*
+ * Vector holding up to N elements inline, so the dims and ranges of a
+ * shape are worked on without touching the heap. Past N they move to a
+ * std::vector, and back once resized to N or less.
+ */
+template <typename T, size_t N>
+class SmallVector {
+ public:
+  SmallVector() : size_(0) {}
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  T& operator[](size_t i) { return data()[i]; }
+  const T& operator[](size_t i) const { return data()[i]; }
+  const T* begin() const { return data(); }
+  const T* end() const { return data() + size_; }
+
+  void clear() { resize(0); }
+  void push_back(const T& value) {
+    resize(size_ + 1);
+    data()[size_ - 1] = value;
+  }
+  void resize(size_t size) {
+    if (size > N) {
+      if (heap_.empty()) {
+        heap_.assign(data_, data_ + size_);
+      }
+      heap_.resize(size);
+    } else if (!heap_.empty()) {
+      std::copy(heap_.begin(), heap_.begin() + std::min(size, size_), data_);
+      heap_.clear();
+    }
+    size_ = size;
+  }
+  std::vector<T> ToVector() const { return std::vector<T>(begin(), end()); }
+
+ private:
+  // heap_ holds the elements whenever there are more than N
+  T* data() { return heap_.empty() ? data_ : heap_.data(); }
+  const T* data() const { return heap_.empty() ? data_ : heap_.data(); }
+
+  T data_[N];
+  std::vector<T> heap_;
+  size_t size_;
+};
+
+typedef SmallVector<int64_t, kMaxShapeDims> ShapeDims;
+// [lower, upper] of every dim, upper -1 meaning unbounded
+typedef SmallVector<std::pair<int64_t, int64_t>, kMaxShapeDims> ShapeRanges;
+
+void GetShapeDims(const Shape& shape, ShapeDims& dims);
+
+bool IsUnknownRank(const ShapeDims& dims);
+
+bool IsUnknownShape(const ShapeDims& dims);
+
+/*
+ * Range of every dim of desc, dims being its shape: known dims are their
+ * own range, unknown ones take the range set on desc, or any size when it
+ * has none.
+ */
+void GetShapeRanges(const TensorDesc& desc, const ShapeDims& dims, ShapeRanges& ranges);
+
+/*
+ * Broadcast of two shapes, aligned at their last dims: a dim of 1 takes
+ * the other side's size and the dims a shorter shape lacks come from the
+ * longer one. False when two known dims differ and neither is 1. An
+ * unknown dim against a size other than 1 takes that size, else it stays
+ * unknown; BroadcastRanges gives its range.
+ */
+bool BroadcastDims(const ShapeDims& dims1, const ShapeDims& dims2, ShapeDims& dims);
+
+/*
+ * Broadcast of the dim ranges of two shapes, aligned as in BroadcastDims.
+ * A dim covers the second shape's range where the first can be 1, the
+ * first's where the second can be 1, and the sizes both allow. False when
+ * a dim can take no size.
+ */
+bool BroadcastRanges(const ShapeRanges& ranges1, const ShapeRanges& ranges2, ShapeRanges& ranges);
+
+/*
+ * Output desc of an elementwise op over two broadcast inputs: the shape
+ * of the broadcast, with ranges when a dim is unknown, an unknown rank
+ * when either input has one, and the dtype and format of the first input.
+ */
+bool InferBroadcastShapeAndType(Operator& op, const string& input_name1, const string& input_name2,
+                                const string& output_name);
+
+// output desc of an elementwise op over one input, which it copies along with its ranges
+bool InferElementwiseShapeAndType(Operator& op, const string& input_name, const string& output_name);
+}
+
+#endif //GE_OPS_OP_PROTO_BROADCAST_INFER_H_
@@ -106,9 +106,27 @@ static bool GetAttrsConv2D(ge::Operator& op, Format refer,
     return true;
 }
 
+/*
+ * Layout of x from the data_format attr, NCHW when it is not set. The
+ * strides and dilations lists follow it too, whatever format the graph
+ * gave the tensor descs.
+ */
+static bool GetDataFormatConv2D(ge::Operator& op, Format& format) {
+    std::string dataFormat = "NCHW";
+    (void)op.GetAttr("data_format", dataFormat);
+    if (dataFormat == "NCHW") {
+        format = FORMAT_NCHW;
+    } else if (dataFormat == "NHWC") {
+        format = FORMAT_NHWC;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 /*
 * Infer output shape and dtype, dtype is same to first input tensor
-* Output format is set by ge parser process already
+* Output format is set by ge parser process already, data_format otherwise
 */
 IMPLEMT_INFERFUNC(Conv2DTik, Conv2DInfer) {
 
@@ -117,10 +135,19 @@ IMPLEMT_INFERFUNC(Conv2DTik, Conv2DInfer) {
 
     auto xShape = xTensor.GetShape().GetDims();
     auto wShape = wTensor.GetShape().GetDims();
-    auto xFormat = xTensor.GetFormat();
+    if (xShape.size() != 4 || wShape.size() != 4) {
+        return GRAPH_FAILED;
+    }
+    Format xFormat = FORMAT_NCHW;
+    if (false == GetDataFormatConv2D(op, xFormat)) {
+        return GRAPH_FAILED;
+    }
     auto wFormat  = wTensor.GetFormat();
-    CHECK_FORMAT(xFormat);
     CHECK_FORMAT(wFormat);
+    // a filter without a layout of its own is OIHW next to NCHW and HWIO next to NHWC
+    if (wFormat != FORMAT_NCHW && wFormat != FORMAT_NHWC && wFormat != FORMAT_HWCN) {
+        wFormat = (xFormat == FORMAT_NCHW) ? FORMAT_NCHW : FORMAT_HWCN;
+    }
 
     int32_t in = 0;
     int32_t ic = 0;
@@ -135,13 +162,11 @@ IMPLEMT_INFERFUNC(Conv2DTik, Conv2DInfer) {
         ic = xShape[1];
         ih = xShape[2];
         iw = xShape[3];
-    } else if (xFormat == FORMAT_NHWC) {
+    } else {
         in = xShape[0];
         ic = xShape[3];
         ih = xShape[1];
         iw = xShape[2];
-    } else {
-        return GRAPH_FAILED;
     }
 
     if (wFormat == FORMAT_NCHW) {
@@ -154,18 +179,18 @@ IMPLEMT_INFERFUNC(Conv2DTik, Conv2DInfer) {
         kc = wShape[3];
         kh = wShape[1];
         kw = wShape[2];
-    } else if (wFormat == FORMAT_HWCN) {
+    } else {
         kn = wShape[3];
         kc = wShape[2];
         kh = wShape[0];
         kw = wShape[1];
-    } else {
-        return GRAPH_FAILED;
     }
 
+    // each of the groups sees ic / groups channels of x and makes kn / groups of y,
+    // depthwise is groups == ic with kc == 1
     int64_t groups = 1;
-
-    if (ic != kc*groups) {
+    (void)op.GetAttr("groups", groups);
+    if (groups < 1 || ic != kc*groups || kn % groups != 0) {
         return GRAPH_FAILED;
     }
 
@@ -191,19 +216,19 @@ IMPLEMT_INFERFUNC(Conv2DTik, Conv2DInfer) {
     vector<int64_t> yShape;
     auto yTensor = op.get_output_desc_y();
     auto yFormat = yTensor.GetFormat();
-    CHECK_FORMAT(yFormat)
+    if (yFormat != FORMAT_NCHW && yFormat != FORMAT_NHWC) {
+        yFormat = xFormat;
+    }
     if (yFormat == FORMAT_NCHW) {
         yShape.push_back(in);
         yShape.push_back(kn);
         yShape.push_back(oh);
         yShape.push_back(ow);
-    } else if (yFormat == FORMAT_NHWC) {
+    } else {
         yShape.push_back(in);
         yShape.push_back(oh);
         yShape.push_back(ow);
         yShape.push_back(kn);
-    } else {
-        return GRAPH_FAILED;
     }
     yTensor.SetShape(Shape(yShape));
     auto xDtype = xTensor.GetDataType();
@@ -222,7 +247,7 @@ IMPLEMT_INFERFUNC(Conv2DTik, Conv2DInfer) {
 
 /*
  * Verify the required 2 input tensor, optional bias ignored
- * Verify strides and dilations attrs, pads ignored
+ * Verify strides, dilations, groups and data_format attrs, pads ignored
 */
 IMPLEMT_VERIFIER(Conv2DTik, Conv2DVerify) {
 
@@ -254,6 +279,15 @@ IMPLEMT_VERIFIER(Conv2DTik, Conv2DVerify) {
     if (GRAPH_SUCCESS != op.GetAttr("dilations", dilationList)) {
         return GRAPH_FAILED;
     }
+    int64_t groups = 1;
+    (void)op.GetAttr("groups", groups);
+    if (groups < 1) {
+        return GRAPH_FAILED;
+    }
+    Format dataFormat = FORMAT_NCHW;
+    if (false == GetDataFormatConv2D(op, dataFormat)) {
+        return GRAPH_FAILED;
+    }
 
     return GRAPH_SUCCESS;
 }
@@ -6,6 +6,25 @@
 
 namespace ge {
 
+/**
+ * *@brief Computes a 2D convolution of x and filter, in groups that each
+ *  see their own share of the input and output channels.
+ *
+ * *@par Inputs:
+ * *x:A 4D Tensor laid out as data_format says.
+ * *filter:A 4D Tensor of [out channels, in channels / groups, h, w], in its own format.
+ * *bias, offset_w:Optional, bias of the output channels and the int8 filter offset.
+ *
+ * *@par Attributes:
+ * *strides, dilations:4D lists in data_format, only their H and W are used.
+ * *pads:[top, bottom, left, right].
+ * *groups:Divides the input and output channels; groups equal to the input channels
+ *    with one filter channel is a depthwise convolution. Defaults to 1.
+ * *data_format:"NCHW" or "NHWC", the layout of x. Defaults to "NCHW".
+ *
+ * *@par Outputs:
+ * *y:A 4D Tensor in the format the parser set, data_format when it set none. int8 gives int32.
+ */
 REG_OP(Conv2DTik)
     .INPUT(x, TensorType({DT_FLOAT16, DT_FLOAT, DT_DOUBLE, DT_INT8}))
     .INPUT(filter, TensorType({DT_FLOAT16, DT_FLOAT, DT_DOUBLE, DT_INT8}))
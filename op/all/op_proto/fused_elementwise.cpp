@@ -0,0 +1,108 @@
+/**
+ * Copyright (C)  2020. Huawei Technologies Co., Ltd. All rights reserved.
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Apache License Version 2.0.You may not use this file except in compliance with the License.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Apache License for more details at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * @file fused_elementwise.cpp
+ *
+ * @brief
+ *
+ * @version 1.0
+ *
+ */
+#include "./fused_elementwise.h"
+#include <string>
+#include <vector>
+
+namespace ge {
+namespace {
+const int64_t kFusedOpcodeNum = 10;
+const int64_t kFusedFirstBinaryOpcode = 4;
+const size_t kFusedInstrFields = 3;
+
+// a rank 0 shape reports a size of 0 but holds one element
+bool IsSingleElement(const ge::Shape &shape)
+{
+  return shape.GetDims().empty() || shape.GetShapeSize() == 1;
+}
+}
+
+IMPLEMT_VERIFIER(FusedElementwise, FusedElementwiseVerify)
+{
+  size_t num_inputs = op.GetInputsSize();
+  if (num_inputs == 0) {
+    return GRAPH_FAILED;
+  }
+  DataType dtype = op.GetDynamicInputDesc("x", 0).GetDataType();
+  for (size_t i = 1; i < num_inputs; i++) {
+    if (op.GetDynamicInputDesc("x", i).GetDataType() != dtype) {
+      return GRAPH_FAILED;
+    }
+  }
+
+  std::vector<int64_t> program;
+  std::vector<float> constants;
+  if (op.GetAttr("program", program) != GRAPH_SUCCESS) {
+    return GRAPH_FAILED;
+  }
+  (void)op.GetAttr("constants", constants);
+  if (program.empty() || program.size() % kFusedInstrFields != 0) {
+    return GRAPH_FAILED;
+  }
+  // every operand refers to an input, a constant or an earlier result
+  int64_t defined = static_cast<int64_t>(num_inputs + constants.size());
+  for (size_t i = 0; i < program.size(); i += kFusedInstrFields, defined++) {
+    int64_t opcode = program[i];
+    int64_t a = program[i + 1];
+    int64_t b = program[i + 2];
+    bool unary = opcode < kFusedFirstBinaryOpcode;
+    if (opcode < 0 || opcode >= kFusedOpcodeNum || a < 0 || a >= defined ||
+        (unary && b != -1) || (!unary && (b < 0 || b >= defined))) {
+      return GRAPH_FAILED;
+    }
+  }
+  return GRAPH_SUCCESS;
+}
+
+// y takes the shape every input of more than one element shares
+IMPLEMT_COMMON_INFERFUNC(FusedElementwiseInferShape)
+{
+  size_t num_inputs = op.GetInputsSize();
+  if (num_inputs == 0) {
+    return GRAPH_FAILED;
+  }
+  TensorDesc x_desc = op.GetDynamicInputDesc("x", 0);
+  ge::Shape y_shape = x_desc.GetShape();
+  for (size_t i = 1; i < num_inputs; i++) {
+    ge::Shape shape = op.GetDynamicInputDesc("x", i).GetShape();
+    if (IsSingleElement(shape)) {
+      continue;
+    }
+    if (IsSingleElement(y_shape)) {
+      y_shape = shape;
+    } else if (shape.GetDims() != y_shape.GetDims()) {
+      return GRAPH_FAILED;
+    }
+  }
+
+  TensorDesc y_desc = op.GetOutputDesc("y");
+  y_desc.SetShape(y_shape);
+  y_desc.SetDataType(x_desc.GetDataType());
+  y_desc.SetFormat(x_desc.GetFormat());
+  (void)op.UpdateOutputDesc("y", y_desc);
+  return GRAPH_SUCCESS;
+}
+
+//Registered inferfunction
+COMMON_INFER_FUNC_REG(FusedElementwise, FusedElementwiseInferShape);
+
+//Registered verify function
+VERIFY_FUNC_REG(FusedElementwise, FusedElementwiseVerify);
+}
@@ -0,0 +1,50 @@
+/**
+ * Copyright (C)  2020. Huawei Technologies Co., Ltd. All rights reserved.
+
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the Apache License Version 2.0.You may not use this file except in compliance with the License.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * Apache License for more details at
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * @file fused_elementwise.h
+ *
+ * @brief
+ *
+ * @version 1.0
+ *
+ */
+#ifndef GE_OP_FUSED_ELEMENTWISE_H
+#define GE_OP_FUSED_ELEMENTWISE_H
+#include "graph/operator_reg.h"
+
+namespace ge {
+/**
+ * *@brief Evaluates a chain of elementwise ops in one pass over memory.
+ *
+ * *@par Inputs:
+ * *x:Dynamic inputs of one type. Each has the shape of y or a single element broadcast over y.
+ *
+ * *@par Attributes:
+ * *program:Instructions of three ints (opcode, a, b), b is -1 for unary opcodes.
+ *    Opcodes: 0 Abs, 1 Neg, 2 Relu, 3 Exp, 4 Add, 5 Sub, 6 Mul, 7 RealDiv, 8 Maximum, 9 Minimum.
+ *    a and b index values numbered x first, then constants, then one result per
+ *    instruction; an operand refers to an earlier value and the last result is y.
+ * *constants:Scalars the program refers to.
+ *
+ * *@par Outputs:
+ * *y:A Tensor of the type of x.
+ */
+REG_OP(FusedElementwise)
+    .DYNAMIC_INPUT(x, TensorType({DT_FLOAT, DT_FLOAT16, DT_DOUBLE}))
+    .OUTPUT(y, TensorType({DT_FLOAT, DT_FLOAT16, DT_DOUBLE}))
+    .REQUIRED_ATTR(program, ListInt)
+    .ATTR(constants, ListFloat, {})
+    .OP_END_FACTORY_REG(FusedElementwise)
+
+}  // namespace ge
+
+#endif  // GE_OP_FUSED_ELEMENTWISE_H
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the graph engine operator
+ */
+
+#ifndef _GE_HOST_GRAPH_OPERATOR_H_
+#define _GE_HOST_GRAPH_OPERATOR_H_
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include "graph/tensor.h"
+
+namespace ge {
+using std::string;
+using std::vector;
+
+class AttrValue {
+public:
+    int64_t i = 0;
+    float f = 0.0f;
+    bool b = false;
+    std::string s;
+    std::vector<int64_t> list_i;
+    std::vector<float> list_f;
+};
+
+/*
+ * Inputs and outputs keep their registration order, so index and name
+ * lookups agree with the graph engine. Only the descs live here: an input
+ * is never connected, its const data is whatever SetInputConstData gave.
+ */
+class Operator {
+public:
+    explicit Operator(const string &type) : type_(type) {}
+    Operator(const string &name, const string &type) : name_(name), type_(type) {}
+    virtual ~Operator() = default;
+
+    const string &GetName() const { return name_; }
+    const string &GetOpType() const { return type_; }
+
+    size_t GetInputsSize() const { return inputs_.size(); }
+    size_t GetOutputsSize() const { return outputs_.size(); }
+    TensorDesc GetInputDesc(const string &name) const;
+    TensorDesc GetInputDesc(uint32_t index) const;
+    graphStatus UpdateInputDesc(const string &name, const TensorDesc &desc);
+    TensorDesc GetOutputDesc(const string &name) const;
+    TensorDesc GetOutputDesc(uint32_t index) const;
+    graphStatus UpdateOutputDesc(const string &name, const TensorDesc &desc);
+    // dynamic input name has its index-th input named name + index
+    TensorDesc GetDynamicInputDesc(const string &name, uint32_t index) const;
+    graphStatus UpdateDynamicInputDesc(const string &name, uint32_t index, const TensorDesc &desc);
+
+    graphStatus GetInputConstData(const string &name, Tensor &data) const;
+    // host only, the value a Const op feeding input name would hold
+    void SetInputConstData(const string &name, const Tensor &data) { const_data_[name] = data; }
+
+    graphStatus GetAttr(const string &name, int64_t &value) const;
+    graphStatus GetAttr(const string &name, int32_t &value) const;
+    graphStatus GetAttr(const string &name, uint32_t &value) const;
+    graphStatus GetAttr(const string &name, float &value) const;
+    graphStatus GetAttr(const string &name, bool &value) const;
+    graphStatus GetAttr(const string &name, string &value) const;
+    graphStatus GetAttr(const string &name, std::vector<int64_t> &value) const;
+    graphStatus GetAttr(const string &name, std::vector<int32_t> &value) const;
+    graphStatus GetAttr(const string &name, std::vector<float> &value) const;
+    Operator &SetAttr(const string &name, int64_t value);
+    Operator &SetAttr(const string &name, int32_t value);
+    Operator &SetAttr(const string &name, float value);
+    Operator &SetAttr(const string &name, bool value);
+    Operator &SetAttr(const string &name, const string &value);
+    Operator &SetAttr(const string &name, const char *value);
+    Operator &SetAttr(const string &name, const std::vector<int64_t> &value);
+    Operator &SetAttr(const string &name, const std::vector<int32_t> &value);
+    Operator &SetAttr(const string &name, const std::vector<float> &value);
+
+protected:
+    // called by the classes REG_OP declares, in the order the op lists them
+    void InputRegister(const string &name);
+    void OptionalInputRegister(const string &name);
+    void DynamicInputRegister(const string &name, uint32_t num);
+    void OutputRegister(const string &name);
+    template <typename T>
+    void AttrRegister(const string &name, const T &value)
+    {
+        SetAttr(name, value);
+    }
+    void RequiredAttrRegister(const string &) {}
+
+private:
+    const AttrValue *FindAttr(const string &name) const;
+
+    string name_;
+    string type_;
+    std::vector<std::pair<string, TensorDesc>> inputs_;
+    std::vector<std::pair<string, TensorDesc>> outputs_;
+    std::map<string, AttrValue> attrs_;
+    std::map<string, Tensor> const_data_;
+};
+} // namespace ge
+#endif
@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the graph engine op registration macros
+ *
+ * REG_OP declares the same op::<type> class as the graph engine, with the
+ * get_input_desc_<name> style accessors the infer functions use, and the
+ * *_FUNC_REG macros fill tables a host harness looks the functions up in.
+ */
+
+#ifndef _GE_HOST_GRAPH_OPERATOR_REG_H_
+#define _GE_HOST_GRAPH_OPERATOR_REG_H_
+
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <vector>
+#include "graph/operator.h"
+
+namespace ge {
+class TensorType {
+public:
+    explicit TensorType(DataType dt) : types_(1, dt) {}
+    TensorType(const std::initializer_list<DataType> &types) : types_(types) {}
+
+    static TensorType ALL()
+    {
+        return TensorType({DT_BOOL, DT_COMPLEX128, DT_COMPLEX64, DT_DOUBLE, DT_FLOAT, DT_FLOAT16, DT_INT16, DT_INT32,
+                           DT_INT64, DT_INT8, DT_QINT16, DT_QINT32, DT_QINT8, DT_QUINT16, DT_QUINT8, DT_STRING,
+                           DT_UINT16, DT_UINT32, DT_UINT64, DT_UINT8});
+    }
+    static TensorType IndexNumberType() { return TensorType({DT_INT32, DT_INT64}); }
+
+private:
+    std::vector<DataType> types_;
+};
+
+// the link of the REG_OP chain, every INPUT, OUTPUT or ATTR closes one registration function
+class OpReg {
+public:
+    OpReg &N() { return *this; }
+};
+
+typedef std::function<graphStatus(Operator &)> OpFunc;
+
+// host only, infer and verify functions by op type
+std::map<string, OpFunc> &InferFuncTable();
+std::map<string, OpFunc> &VerifyFuncTable();
+
+class InferShapeFuncRegister {
+public:
+    InferShapeFuncRegister(const string &type, const OpFunc &func) { InferFuncTable()[type] = func; }
+};
+
+class VerifyFuncRegister {
+public:
+    VerifyFuncRegister(const string &type, const OpFunc &func) { VerifyFuncTable()[type] = func; }
+};
+
+namespace op {
+// attr types named by ATTR and REQUIRED_ATTR
+typedef int64_t Int;
+typedef float Float;
+typedef bool Bool;
+typedef std::string String;
+typedef std::vector<int64_t> ListInt;
+typedef std::vector<float> ListFloat;
+} // namespace op
+} // namespace ge
+
+#define REG_OP(x)                                       \
+    namespace op {                                      \
+    class x : public Operator {                         \
+        typedef x _THIS_TYPE;                           \
+                                                        \
+    public:                                             \
+        explicit x(const string &name) : Operator(name, #x) \
+        {                                               \
+            __##x();                                    \
+        }                                               \
+        x() : Operator(#x)                              \
+        {                                               \
+            __##x();                                    \
+        }                                               \
+                                                        \
+    private:                                            \
+        void __##x()                                    \
+        {                                               \
+            OpReg()
+
+#define INPUT(x, t)                                                                               \
+    N();                                                                                          \
+    __input_##x();                                                                                \
+    }                                                                                             \
+                                                                                                  \
+public:                                                                                           \
+    TensorDesc get_input_desc_##x() const { return GetInputDesc(#x); }                            \
+    graphStatus update_input_desc_##x(const TensorDesc &desc) { return UpdateInputDesc(#x, desc); } \
+                                                                                                  \
+private:                                                                                          \
+    void __input_##x()                                                                            \
+    {                                                                                             \
+        Operator::InputRegister(#x);                                                              \
+        (void)OpReg()
+
+#define OPTIONAL_INPUT(x, t)                                                                      \
+    N();                                                                                          \
+    __optional_input_##x();                                                                       \
+    }                                                                                             \
+                                                                                                  \
+public:                                                                                           \
+    TensorDesc get_input_desc_##x() const { return GetInputDesc(#x); }                            \
+    graphStatus update_input_desc_##x(const TensorDesc &desc) { return UpdateInputDesc(#x, desc); } \
+                                                                                                  \
+private:                                                                                          \
+    void __optional_input_##x()                                                                   \
+    {                                                                                             \
+        Operator::OptionalInputRegister(#x);                                                      \
+        (void)OpReg()
+
+#define DYNAMIC_INPUT(x, t)                                                                       \
+    N();                                                                                          \
+    __dynamic_input_##x();                                                                        \
+    }                                                                                             \
+                                                                                                  \
+public:                                                                                           \
+    _THIS_TYPE &create_dynamic_input_##x(uint32_t num)                                            \
+    {                                                                                             \
+        Operator::DynamicInputRegister(#x, num);                                                  \
+        return *this;                                                                             \
+    }                                                                                             \
+    TensorDesc get_dynamic_input_desc_##x(uint32_t index) const { return GetDynamicInputDesc(#x, index); } \
+                                                                                                  \
+private:                                                                                          \
+    void __dynamic_input_##x()                                                                    \
+    {                                                                                             \
+        (void)OpReg()
+
+#define OUTPUT(x, t)                                                                                \
+    N();                                                                                            \
+    __out_##x();                                                                                    \
+    }                                                                                               \
+                                                                                                    \
+public:                                                                                             \
+    TensorDesc get_output_desc_##x() const { return GetOutputDesc(#x); }                            \
+    graphStatus update_output_desc_##x(const TensorDesc &desc) { return UpdateOutputDesc(#x, desc); } \
+                                                                                                    \
+private:                                                                                            \
+    void __out_##x()                                                                                \
+    {                                                                                               \
+        Operator::OutputRegister(#x);                                                               \
+        (void)OpReg()
+
+#define ATTR(x, Type, ...)                                    \
+    N();                                                      \
+    __attr_##x();                                             \
+    }                                                         \
+                                                              \
+public:                                                       \
+    _THIS_TYPE &set_attr_##x(const op::Type &value)           \
+    {                                                         \
+        Operator::SetAttr(#x, value);                         \
+        return *this;                                         \
+    }                                                         \
+                                                              \
+private:                                                      \
+    void __attr_##x()                                         \
+    {                                                         \
+        Operator::AttrRegister(#x, op::Type(__VA_ARGS__));    \
+        (void)OpReg()
+
+#define REQUIRED_ATTR(x, Type)                                \
+    N();                                                      \
+    __required_attr_##x();                                    \
+    }                                                         \
+                                                              \
+public:                                                       \
+    _THIS_TYPE &set_attr_##x(const op::Type &value)           \
+    {                                                         \
+        Operator::SetAttr(#x, value);                         \
+        return *this;                                         \
+    }                                                         \
+                                                              \
+private:                                                      \
+    void __required_attr_##x()                                \
+    {                                                         \
+        Operator::RequiredAttrRegister(#x);                   \
+        (void)OpReg()
+
+#define OP_END_FACTORY_REG(x) \
+    N();                      \
+    }                         \
+    }                         \
+    ;                         \
+    }
+
+// infer and verify functions, the typed ones see the op::<type> class of their op
+#define IMPLEMT_INFERFUNC(op_name, func_name) static graphStatus func_name(op::op_name &op)
+#define IMPLEMT_COMMON_INFERFUNC(func_name) static graphStatus func_name(Operator &op)
+// some verifiers only check what they are registered for and never read op
+#define IMPLEMT_VERIFIER(op_name, func_name) static graphStatus func_name(op::op_name op __attribute__((unused)))
+
+#define GE_HOST_FUNC_REG_NAME_(kind, op_name) g_##kind##_register_##op_name
+#define INFER_FUNC_REG(op_name, x)                                                                            \
+    static const InferShapeFuncRegister GE_HOST_FUNC_REG_NAME_(infer, op_name)(#op_name, [](Operator &op) { \
+        return x(static_cast<op::op_name &>(op));                                                             \
+    })
+#define COMMON_INFER_FUNC_REG(op_name, x) \
+    static const InferShapeFuncRegister GE_HOST_FUNC_REG_NAME_(infer, op_name)(#op_name, x)
+#define VERIFY_FUNC_REG(op_name, x)                                                                          \
+    static const VerifyFuncRegister GE_HOST_FUNC_REG_NAME_(verify, op_name)(#op_name, [](Operator &op) { \
+        return x(static_cast<op::op_name &>(op));                                                            \
+    })
+#endif
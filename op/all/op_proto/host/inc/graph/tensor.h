@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the graph engine shape, tensor desc and tensor
+ */
+
+#ifndef _GE_HOST_GRAPH_TENSOR_H_
+#define _GE_HOST_GRAPH_TENSOR_H_
+
+#include <utility>
+#include <vector>
+#include "graph/types.h"
+
+namespace ge {
+class Shape {
+public:
+    Shape() = default;
+    explicit Shape(const std::vector<int64_t> &dims) : dims_(dims) {}
+    ~Shape() = default;
+
+    size_t GetDimNum() const { return dims_.size(); }
+    int64_t GetDim(size_t idx) const { return idx < dims_.size() ? dims_[idx] : 0; }
+    graphStatus SetDim(size_t idx, int64_t value)
+    {
+        if (idx >= dims_.size()) {
+            return GRAPH_FAILED;
+        }
+        dims_[idx] = value;
+        return GRAPH_SUCCESS;
+    }
+    std::vector<int64_t> GetDims() const { return dims_; }
+    // 0 for a shape without dims and -1 while a dim is unknown, as in the graph engine
+    int64_t GetShapeSize() const
+    {
+        if (dims_.empty()) {
+            return 0;
+        }
+        int64_t size = 1;
+        for (size_t i = 0; i < dims_.size(); ++i) {
+            if (dims_[i] < 0) {
+                return -1;
+            }
+            size *= dims_[i];
+        }
+        return size;
+    }
+
+private:
+    std::vector<int64_t> dims_;
+};
+
+class TensorDesc {
+public:
+    TensorDesc() = default;
+    explicit TensorDesc(const Shape &shape, Format format = FORMAT_ND, DataType dt = DT_FLOAT)
+        : shape_(shape), origin_shape_(shape), format_(format), origin_format_(format), data_type_(dt)
+    {
+    }
+    ~TensorDesc() = default;
+
+    Shape GetShape() const { return shape_; }
+    void SetShape(const Shape &shape) { shape_ = shape; }
+    Shape GetOriginShape() const { return origin_shape_; }
+    void SetOriginShape(const Shape &shape) { origin_shape_ = shape; }
+    Format GetFormat() const { return format_; }
+    void SetFormat(Format format) { format_ = format; }
+    Format GetOriginFormat() const { return origin_format_; }
+    void SetOriginFormat(Format format) { origin_format_ = format; }
+    DataType GetDataType() const { return data_type_; }
+    void SetDataType(DataType dt) { data_type_ = dt; }
+    graphStatus GetShapeRange(std::vector<std::pair<int64_t, int64_t>> &range) const
+    {
+        range = range_;
+        return GRAPH_SUCCESS;
+    }
+    graphStatus SetShapeRange(const std::vector<std::pair<int64_t, int64_t>> &range)
+    {
+        range_ = range;
+        return GRAPH_SUCCESS;
+    }
+
+private:
+    Shape shape_;
+    Shape origin_shape_;
+    Format format_ = FORMAT_ND;
+    Format origin_format_ = FORMAT_ND;
+    DataType data_type_ = DT_FLOAT;
+    std::vector<std::pair<int64_t, int64_t>> range_;
+};
+
+class Tensor {
+public:
+    Tensor() = default;
+    Tensor(const TensorDesc &desc, const uint8_t *data, size_t size) : desc_(desc), data_(data, data + size) {}
+    ~Tensor() = default;
+
+    TensorDesc GetTensorDesc() const { return desc_; }
+    void SetTensorDesc(const TensorDesc &desc) { desc_ = desc; }
+    const uint8_t *GetData() const { return data_.data(); }
+    uint8_t *GetData() { return data_.data(); }
+    size_t GetSize() const { return data_.size(); }
+    void SetData(const uint8_t *data, size_t size) { data_.assign(data, data + size); }
+
+private:
+    TensorDesc desc_;
+    std::vector<uint8_t> data_;
+};
+} // namespace ge
+#endif
@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the graph engine types used by op_proto
+ */
+
+#ifndef _GE_HOST_GRAPH_TYPES_H_
+#define _GE_HOST_GRAPH_TYPES_H_
+
+#include <stdint.h>
+
+namespace ge {
+typedef uint32_t graphStatus;
+const graphStatus GRAPH_SUCCESS = 0;
+const graphStatus GRAPH_FAILED = 0xFFFFFFFF;
+
+enum DataType {
+    DT_FLOAT = 0,
+    DT_FLOAT16 = 1,
+    DT_INT8 = 2,
+    DT_INT32 = 3,
+    DT_UINT8 = 4,
+    DT_INT16 = 6,
+    DT_UINT16 = 7,
+    DT_UINT32 = 8,
+    DT_INT64 = 9,
+    DT_UINT64 = 10,
+    DT_DOUBLE = 11,
+    DT_BOOL = 12,
+    DT_STRING = 13,
+    DT_COMPLEX64 = 16,
+    DT_COMPLEX128 = 17,
+    DT_QINT8 = 18,
+    DT_QINT16 = 19,
+    DT_QINT32 = 20,
+    DT_QUINT8 = 21,
+    DT_QUINT16 = 22,
+    DT_UNDEFINED = 27
+};
+
+enum Format {
+    FORMAT_NCHW = 0,
+    FORMAT_NHWC = 1,
+    FORMAT_ND = 2,
+    FORMAT_NC1HWC0 = 3,
+    FORMAT_FRACTAL_Z = 4,
+    FORMAT_HWCN = 16,
+    FORMAT_RESERVED = 40
+};
+} // namespace ge
+#endif
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) Huawei Technologies Co., Ltd. 2020. All rights reserved.
+ * Description: host stand-in of the graph engine operator
+ */
+
+#include <string>
+#include "graph/operator_reg.h"
+
+namespace ge {
+namespace {
+TensorDesc FindDesc(const std::vector<std::pair<string, TensorDesc>> &descs, const string &name)
+{
+    for (auto &item : descs) {
+        if (item.first == name) {
+            return item.second;
+        }
+    }
+    return TensorDesc();
+}
+
+graphStatus UpdateDesc(std::vector<std::pair<string, TensorDesc>> &descs, const string &name, const TensorDesc &desc)
+{
+    for (auto &item : descs) {
+        if (item.first == name) {
+            item.second = desc;
+            return GRAPH_SUCCESS;
+        }
+    }
+    return GRAPH_FAILED;
+}
+}
+
+std::map<string, OpFunc> &InferFuncTable()
+{
+    static std::map<string, OpFunc> table;
+    return table;
+}
+
+std::map<string, OpFunc> &VerifyFuncTable()
+{
+    static std::map<string, OpFunc> table;
+    return table;
+}
+
+TensorDesc Operator::GetInputDesc(const string &name) const
+{
+    return FindDesc(inputs_, name);
+}
+
+TensorDesc Operator::GetInputDesc(uint32_t index) const
+{
+    return index < inputs_.size() ? inputs_[index].second : TensorDesc();
+}
+
+graphStatus Operator::UpdateInputDesc(const string &name, const TensorDesc &desc)
+{
+    return UpdateDesc(inputs_, name, desc);
+}
+
+TensorDesc Operator::GetOutputDesc(const string &name) const
+{
+    return FindDesc(outputs_, name);
+}
+
+TensorDesc Operator::GetOutputDesc(uint32_t index) const
+{
+    return index < outputs_.size() ? outputs_[index].second : TensorDesc();
+}
+
+graphStatus Operator::UpdateOutputDesc(const string &name, const TensorDesc &desc)
+{
+    return UpdateDesc(outputs_, name, desc);
+}
+
+TensorDesc Operator::GetDynamicInputDesc(const string &name, uint32_t index) const
+{
+    return FindDesc(inputs_, name + std::to_string(index));
+}
+
+graphStatus Operator::UpdateDynamicInputDesc(const string &name, uint32_t index, const TensorDesc &desc)
+{
+    return UpdateDesc(inputs_, name + std::to_string(index), desc);
+}
+
+graphStatus Operator::GetInputConstData(const string &name, Tensor &data) const
+{
+    auto iter = const_data_.find(name);
+    if (iter == const_data_.end()) {
+        return GRAPH_FAILED;
+    }
+    data = iter->second;
+    return GRAPH_SUCCESS;
+}
+
+const AttrValue *Operator::FindAttr(const string &name) const
+{
+    auto iter = attrs_.find(name);
+    return iter == attrs_.end() ? nullptr : &iter->second;
+}
+
+graphStatus Operator::GetAttr(const string &name, int64_t &value) const
+{
+    const AttrValue *attr = FindAttr(name);
+    if (attr == nullptr) {
+        return GRAPH_FAILED;
+    }
+    value = attr->i;
+    return GRAPH_SUCCESS;
+}
+
+graphStatus Operator::GetAttr(const string &name, int32_t &value) const
+{
+    int64_t wide = 0;
+    if (GetAttr(name, wide) != GRAPH_SUCCESS) {
+        return GRAPH_FAILED;
+    }
+    value = static_cast<int32_t>(wide);
+    return GRAPH_SUCCESS;
+}
+
+graphStatus Operator::GetAttr(const string &name, uint32_t &value) const
+{
+    int64_t wide = 0;
+    if (GetAttr(name, wide) != GRAPH_SUCCESS) {
+        return GRAPH_FAILED;
+    }
+    value = static_cast<uint32_t>(wide);
+    return GRAPH_SUCCESS;
+}
+
+graphStatus Operator::GetAttr(const string &name, float &value) const
+{
+    const AttrValue *attr = FindAttr(name);
+    if (attr == nullptr) {
+        return GRAPH_FAILED;
+    }
+    value = attr->f;
+    return GRAPH_SUCCESS;
+}
+
+graphStatus Operator::GetAttr(const string &name, bool &value) const
+{
+    const AttrValue *attr = FindAttr(name);
+    if (attr == nullptr) {
+        return GRAPH_FAILED;
+    }
+    value = attr->b;
+    return GRAPH_SUCCESS;
+}
+
+graphStatus Operator::GetAttr(const string &name, string &value) const
+{
+    const AttrValue *attr = FindAttr(name);
+    if (attr == nullptr) {
+        return GRAPH_FAILED;
+    }
+    value = attr->s;
+    return GRAPH_SUCCESS;
+}
+
+graphStatus Operator::GetAttr(const string &name, std::vector<int64_t> &value) const
+{
+    const AttrValue *attr = FindAttr(name);
+    if (attr == nullptr) {
+        return GRAPH_FAILED;
+    }
+    value = attr->list_i;
+    return GRAPH_SUCCESS;
+}
+
+graphStatus Operator::GetAttr(const string &name, std::vector<int32_t> &value) const
+{
+    const AttrValue *attr = FindAttr(name);
+    if (attr == nullptr) {
+        return GRAPH_FAILED;
+    }
+    value.assign(attr->list_i.begin(), attr->list_i.end());
+    return GRAPH_SUCCESS;
+}
+
+graphStatus Operator::GetAttr(const string &name, std::vector<float> &value) const
+{
+    const AttrValue *attr = FindAttr(name);
+    if (attr == nullptr) {
+        return GRAPH_FAILED;
+    }
+    value = attr->list_f;
+    return GRAPH_SUCCESS;
+}
+
+Operator &Operator::SetAttr(const string &name, int64_t value)
+{
+    attrs_[name].i = value;
+    return *this;
+}
+
+Operator &Operator::SetAttr(const string &name, int32_t value)
+{
+    return SetAttr(name, static_cast<int64_t>(value));
+}
+
+Operator &Operator::SetAttr(const string &name, float value)
+{
+    attrs_[name].f = value;
+    return *this;
+}
+
+Operator &Operator::SetAttr(const string &name, bool value)
+{
+    attrs_[name].b = value;
+    return *this;
+}
+
+Operator &Operator::SetAttr(const string &name, const string &value)
+{
+    attrs_[name].s = value;
+    return *this;
+}
+
+Operator &Operator::SetAttr(const string &name, const char *value)
+{
+    return SetAttr(name, string(value));
+}
+
+Operator &Operator::SetAttr(const string &name, const std::vector<int64_t> &value)
+{
+    attrs_[name].list_i = value;
+    return *this;
+}
+
+Operator &Operator::SetAttr(const string &name, const std::vector<int32_t> &value)
+{
+    return SetAttr(name, std::vector<int64_t>(value.begin(), value.end()));
+}
+
+Operator &Operator::SetAttr(const string &name, const std::vector<float> &value)
+{
+    attrs_[name].list_f = value;
+    return *this;
+}
+
+void Operator::InputRegister(const string &name)
+{
+    inputs_.push_back(std::make_pair(name, TensorDesc()));
+}
+
+void Operator::OptionalInputRegister(const string &name)
+{
+    InputRegister(name);
+}
+
+void Operator::DynamicInputRegister(const string &name, uint32_t num)
+{
+    for (uint32_t i = 0; i < num; ++i) {
+        InputRegister(name + std::to_string(i));
+    }
+}
+
+void Operator::OutputRegister(const string &name)
+{
+    outputs_.push_back(std::make_pair(name, TensorDesc()));
+}
+} // namespace ge
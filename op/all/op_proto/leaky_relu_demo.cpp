@@ -20,6 +20,7 @@
 #include "./leaky_relu_demo.h"
 #include <string>
 #include <vector>
+#include "./broadcast_infer.h"
 
 namespace ge {
 
@@ -28,12 +29,7 @@ IMPLEMT_VERIFIER(LeakyReluDemo, LeakyReluDemoVerify) {
   return GRAPH_SUCCESS;
 }
 IMPLEMT_INFERFUNC(LeakyReluDemo, LeakyReluDemoInferShape) {
-  auto x_shape = op.GetInputDesc("x").GetShape().GetDims();
-  DataType x_dtype = op.GetInputDesc("x").GetDataType();
-  TensorDesc y_desc = op.GetOutputDesc("y");
-  y_desc.SetShape(ge::Shape(x_shape));
-  y_desc.SetDataType(x_dtype);
-  (void)op.UpdateOutputDesc("y", y_desc);
+  (void)InferElementwiseShapeAndType(op, "x", "y");
   return GRAPH_SUCCESS;
 }
 INFER_FUNC_REG(LeakyReluDemo, LeakyReluDemoInferShape);
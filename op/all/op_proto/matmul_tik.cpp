@@ -1,8 +1,157 @@
 #include "matmul_tik.h"
+#include <algorithm>
 #include <string>
 #include <vector>
+#include "./broadcast_infer.h"
 
 namespace ge {
+namespace {
+const int64_t kUnknownRank = -2;
+// buffers of the AI Core matmul_tik.py builds for, tik.Dprofile('v100', 'mini')
+const int64_t kL1Bytes = 1024 * 1024;
+const int64_t kL0cBytes = 256 * 1024;
+// a fractal block is 16 rows of m or n by 32 bytes of k
+const int64_t kBlockRows = 16;
+const int64_t kBlockBytes = 32;
+// L0C accumulates in float32 or int32
+const int64_t kAccumBytes = 4;
+// the kernel splits the n tiles over two cores
+const int64_t kCoreNum = 2;
+const int64_t kMaxMatmulMN = 4096;
+const int64_t kMaxMatmulK = 16384;
+const int64_t kMaxBurstStride = 65535;
+
+struct MatmulTiling {
+    int64_t m_tiling_size;
+    int64_t n_tiling_size;
+    int64_t k_tiling_size;
+    int64_t m_thread_num;
+    int64_t n_thread_num;
+    int64_t k_thread_num;
+};
+
+// multiples of unit up to limit that divide value, ascending
+std::vector<int64_t> TileSizes(int64_t value, int64_t unit, int64_t limit)
+{
+    std::vector<int64_t> sizes;
+    if (value <= 0 || value % unit != 0) {
+        return sizes;
+    }
+    // divisor pairs of value / unit, so a k of 16384 takes 32 steps rather than 1024
+    int64_t blocks = value / unit;
+    for (int64_t low = 1; low * low <= blocks; ++low) {
+        if (blocks % low != 0) {
+            continue;
+        }
+        int64_t high = blocks / low;
+        if (low * unit <= limit) {
+            sizes.push_back(low * unit);
+        }
+        if (high != low && high * unit <= limit) {
+            sizes.push_back(high * unit);
+        }
+    }
+    std::sort(sizes.begin(), sizes.end());
+    return sizes;
+}
+
+/*
+ * Tiling of the fractal kernel for y[m, n] = x1[m, k] * x2[k, n] with
+ * inputs of dtype_bytes each, false when the shapes do not fit it. A is
+ * read from GM once per n tile and B once per m tile, so the tiling with
+ * the least GM traffic wins, then the one that double buffers its k loads,
+ * then the one with the fewest steps. A tile of m or k is double buffered
+ * whenever there are two of them, within the L1 and L0C sizes.
+ */
+bool ChooseTiling(int64_t m, int64_t k, int64_t n, int64_t dtype_bytes, MatmulTiling &tiling)
+{
+    std::vector<int64_t> m_sizes = TileSizes(m, kBlockRows, kMaxMatmulMN);
+    std::vector<int64_t> n_sizes;
+    if (n % kCoreNum == 0) {
+        n_sizes = TileSizes(n / kCoreNum, kBlockRows, kMaxMatmulMN);
+    }
+    std::vector<int64_t> k_sizes = TileSizes(k, kBlockBytes / dtype_bytes, kMaxMatmulK);
+    bool found = false;
+    int64_t best_traffic = 0;
+    int64_t best_steps = 0;
+    for (int64_t mt : m_sizes) {
+        // the row stride of the A loads and the y writes, in 32 byte blocks
+        if ((m - mt) * kBlockRows * kAccumBytes / kBlockBytes > kMaxBurstStride) {
+            continue;
+        }
+        int64_t m_threads = (m / mt >= 2) ? 2 : 1;
+        for (int64_t nt : n_sizes) {
+            if (mt * nt * kAccumBytes * m_threads > kL0cBytes) {
+                continue;
+            }
+            int64_t kt = 0;
+            int64_t k_threads = 1;
+            for (auto it = k_sizes.rbegin(); it != k_sizes.rend(); ++it) {
+                int64_t threads = (k / *it >= 2) ? 2 : 1;
+                if (*it * (mt + nt) * dtype_bytes * threads * m_threads > kL1Bytes) {
+                    continue;
+                }
+                if (kt == 0 || threads > k_threads) {
+                    kt = *it;
+                    k_threads = threads;
+                }
+                if (threads == 2) {
+                    break;
+                }
+            }
+            if (kt == 0) {
+                continue;
+            }
+            int64_t traffic = m * k * (n / nt) + k * n * (m / mt);
+            int64_t steps = (m / mt) * (n / nt) * (k / kt);
+            if (found && (traffic > best_traffic || (traffic == best_traffic &&
+                (k_threads < tiling.k_thread_num || (k_threads == tiling.k_thread_num && steps >= best_steps))))) {
+                continue;
+            }
+            found = true;
+            best_traffic = traffic;
+            best_steps = steps;
+            tiling.m_tiling_size = mt;
+            tiling.n_tiling_size = nt;
+            tiling.k_tiling_size = kt;
+            tiling.m_thread_num = m_threads;
+            tiling.n_thread_num = 1;
+            tiling.k_thread_num = k_threads;
+        }
+    }
+    return found;
+}
+
+/*
+ * The kernels walk the batch of y as one axis, so an input either holds
+ * all of its batch dims or a single matrix shared by the whole batch.
+ * Unknown dims match either way.
+ */
+bool HoldsWholeBatch(const ShapeDims &batch, const ShapeDims &y_batch)
+{
+    size_t lead = y_batch.size() - batch.size();
+    bool shared = true;
+    bool whole = true;
+    for (size_t i = 0; i < y_batch.size(); ++i) {
+        // dims an input lacks count as 1
+        int64_t dim = (i < lead) ? 1 : batch[i - lead];
+        shared = shared && (dim == 1 || dim < 0);
+        whole = whole && (dim == y_batch[i] || dim < 0 || y_batch[i] < 0);
+    }
+    return shared || whole;
+}
+
+// all 0 when there is no tiling, so none is left over from an earlier shape
+void SetTilingAttrs(Operator& op, const MatmulTiling &tiling)
+{
+    op.SetAttr("m_tiling_size", tiling.m_tiling_size);
+    op.SetAttr("n_tiling_size", tiling.n_tiling_size);
+    op.SetAttr("k_tiling_size", tiling.k_tiling_size);
+    op.SetAttr("m_thread_num", tiling.m_thread_num);
+    op.SetAttr("n_thread_num", tiling.n_thread_num);
+    op.SetAttr("k_thread_num", tiling.k_thread_num);
+}
+}
 
 IMPLEMT_VERIFIER(MatmulTik, MatmulTikVerify)
 {
@@ -23,26 +172,62 @@ IMPLEMT_COMMON_INFERFUNC(MatmulTikInferShape)
     ge::TensorDesc inputTensorDescX = op.GetInputDesc("x1");
     ge::TensorDesc inputTensorDescY = op.GetInputDesc("x2");
 
-    ge::Shape shapeX = inputTensorDescX.GetShape();
-    ge::Shape shapeY = inputTensorDescY.GetShape();
+    ShapeDims dimsX;
+    ShapeDims dimsY;
+    GetShapeDims(inputTensorDescX.GetShape(), dimsX);
+    GetShapeDims(inputTensorDescY.GetShape(), dimsY);
 
     DataType dtype = inputTensorDescX.GetDataType();
+    // int8 and uint8 accumulate into int32 and float16 into float, as in the ini and the tik kernel
+    bool quantized = dtype == DT_INT8 || dtype == DT_UINT8;
+    tensordesc_output.SetDataType(quantized ? DT_INT32 : ((dtype == DT_FLOAT16) ? DT_FLOAT : dtype));
 
-    bool transposeA = false;
-
+    MatmulTiling tiling = {0, 0, 0, 0, 0, 0};
+    if (IsUnknownRank(dimsX) || IsUnknownRank(dimsY)) {
+        SetTilingAttrs(op, tiling);
+        tensordesc_output.SetShape(ge::Shape(std::vector<int64_t>(1, kUnknownRank)));
+        (void)op.UpdateOutputDesc("y", tensordesc_output);
+        return GRAPH_SUCCESS;
+    }
+    if (dimsX.size() < 2 || dimsY.size() < 2) {
+        return GRAPH_FAILED;
+    }
 
+    bool transposeA = false;
     bool transposeB = false;
+    (void)op.GetAttr("transpose_x1", transposeA);
+    (void)op.GetAttr("transpose_x2", transposeB);
+    size_t rankX = dimsX.size();
+    size_t rankY = dimsY.size();
+    int64_t m = transposeA ? dimsX[rankX - 1] : dimsX[rankX - 2];
+    int64_t kX = transposeA ? dimsX[rankX - 2] : dimsX[rankX - 1];
+    int64_t kY = transposeB ? dimsY[rankY - 1] : dimsY[rankY - 2];
+    int64_t n = transposeB ? dimsY[rankY - 2] : dimsY[rankY - 1];
+    if (kX >= 0 && kY >= 0 && kX != kY) {
+        return GRAPH_FAILED;
+    }
 
-    
-    std::vector<int64_t> dimVector;
-    dimVector.push_back(shapeX.GetDim(0));
-    dimVector.push_back(shapeY.GetDim(1));
-
-
-    ge::Shape outputShape(dimVector);
+    // y is the broadcast of the batch dims followed by [m, n]
+    ShapeDims batchX = dimsX;
+    ShapeDims batchY = dimsY;
+    batchX.resize(rankX - 2);
+    batchY.resize(rankY - 2);
+    ShapeDims dimVector;
+    if (!BroadcastDims(batchX, batchY, dimVector) || !HoldsWholeBatch(batchX, dimVector) ||
+        !HoldsWholeBatch(batchY, dimVector)) {
+        return GRAPH_FAILED;
+    }
+    dimVector.push_back(m);
+    dimVector.push_back(n);
+    tensordesc_output.SetShape(ge::Shape(dimVector.ToVector()));
 
-    tensordesc_output.SetShape(outputShape);
-    tensordesc_output.SetDataType(op.GetInputDesc("x1").GetDataType());
+    // the AI Core kernel takes float16, int8 and uint8 of known m, k and n
+    int64_t k = (kX >= 0) ? kX : kY;
+    if ((dtype == DT_FLOAT16 || quantized) && m > 0 && k > 0 && n > 0 &&
+        !ChooseTiling(m, k, n, (dtype == DT_FLOAT16) ? 2 : 1, tiling)) {
+        tiling = MatmulTiling{0, 0, 0, 0, 0, 0};
+    }
+    SetTilingAttrs(op, tiling);
     (void)op.UpdateOutputDesc("y", tensordesc_output);
     return GRAPH_SUCCESS;
 }
@@ -52,4 +237,4 @@ COMMON_INFER_FUNC_REG(MatmulTik, MatmulTikInferShape);
 
 //Registered verify function
 VERIFY_FUNC_REG(MatmulTik, MatmulTikVerify);
-}
\ No newline at end of file
+}
\ No newline at end of file
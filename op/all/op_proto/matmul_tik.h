@@ -4,11 +4,40 @@
 #include "graph/operator_reg.h"
 
 namespace ge {
+/**
+ * *@brief Multiplies matrix x1 by matrix x2, over the batch dims both
+ *  have in front of their last two, broadcast as in Add. An input either
+ *  has all the batch dims of y or only dims of 1.
+ *
+ * *@par Inputs:
+ * *Two inputs:
+ * *x1:A Tensor of rank 2 or more. Must be one of the following types: float, float16, int32, int8, uint8.
+ * *x2:A Tensor of rank 2 or more. Must be one of the following types: float, float16, int32, int8.
+ *
+ * *@par Attributes:
+ * *transpose_x1:If true, the last two dims of x1 are [k, m] instead of [m, k].
+ * *transpose_x2:If true, the last two dims of x2 are [n, k] instead of [k, n].
+ * *m_tiling_size, n_tiling_size, k_tiling_size, m_thread_num, n_thread_num, k_thread_num:Tiling of
+ *    the AI Core kernel. Set by the infer function from the final shapes, 0 when the shapes do not
+ *    fit the fractal kernel; not meant to be set by hand.
+ *
+ * *@par Outputs:
+ * *y:A Tensor of the broadcast batch dims followed by [m, n]. int8 and uint8 accumulate into int32,
+ *    float16 into float.
+ */
 REG_OP(MatmulTik)
-    .INPUT(x1, TensorType({DT_FLOAT, DT_FLOAT16, DT_INT32}))
-    .INPUT(x2, TensorType({DT_FLOAT, DT_FLOAT16, DT_INT32}))
-    .OUTPUT(y, TensorType({DT_FLOAT, DT_FLOAT16, DT_INT32}))            
+    .INPUT(x1, TensorType({DT_FLOAT, DT_FLOAT16, DT_INT32, DT_INT8, DT_UINT8}))
+    .INPUT(x2, TensorType({DT_FLOAT, DT_FLOAT16, DT_INT32, DT_INT8}))
+    .OUTPUT(y, TensorType({DT_FLOAT, DT_FLOAT16, DT_INT32}))
+    .ATTR(transpose_x1, Bool, false)
+    .ATTR(transpose_x2, Bool, false)
+    .ATTR(m_tiling_size, Int, 0)
+    .ATTR(n_tiling_size, Int, 0)
+    .ATTR(k_tiling_size, Int, 0)
+    .ATTR(m_thread_num, Int, 0)
+    .ATTR(n_thread_num, Int, 0)
+    .ATTR(k_thread_num, Int, 0)
     .OP_END_FACTORY_REG(MatmulTik)
 }
 
-#endif
\ No newline at end of file
+#endif
\ No newline at end of file
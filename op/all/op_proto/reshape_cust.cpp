@@ -40,7 +40,7 @@ namespace ge {
 IMPLEMT_COMMON_INFERFUNC(ReshapeCustInferShape) {
   TensorDesc tensordesc_tensor = op.GetInputDesc("tensor");
   TensorDesc tensordesc_shape = op.GetInputDesc("shape");
-  TensorDesc tensordesc_output = op.GetOutputDesc("output");
+  TensorDesc tensordesc_output = op.GetOutputDesc("tensor");
   Tensor shape_tensor;
   if (op.GetInputConstData("shape", shape_tensor) == GRAPH_SUCCESS) {
     DataType shape_type = tensordesc_shape.GetDataType();
@@ -72,7 +72,7 @@ IMPLEMT_COMMON_INFERFUNC(ReshapeCustInferShape) {
   }
   tensordesc_output.SetShapeRange(range);
 
-  (void)op.UpdateOutputDesc("output", tensordesc_output);
+  (void)op.UpdateOutputDesc("tensor", tensordesc_output);
   return GRAPH_SUCCESS;
 }
 
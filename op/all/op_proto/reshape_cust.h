@@ -23,27 +23,34 @@
 
 namespace ge {
 /**
- * *@brief Cast a tensor form src data type to dst data type.
+ * *@brief Reshapes a tensor. The bytes are never changed, so the output is
+ *  registered as a reference of the input and shares its memory.
  *
  * *@par Inputs:
- * *One input:
- * *x:A Tensor. Must be one of the following types: bool, float16, float, int8, int32, uint32, uint8,
+ * *Two inputs:
+ * *tensor:A Tensor. Must be one of the following types: bool, float16, float, int8, int32, uint32, uint8,
  *    int64, uint64, int16, uint16, double, complex64, complex128, qint8, quint8, qint16, quint16, qint32.
+ * *shape:A Tensor of type int32 or int64, specifying the output shape.
  *
- *    *@par Attributes:
- *    *dst_type: An required attribute of type int32, specifying the dst data type.
+ * *@par Attributes:
+ * *strides:Element strides of tensor over its buffer, one per dim. Set when an upstream op leaves
+ *    tensor as a strided view; the output is then gathered dense in one pass instead of after a
+ *    contiguous copy, and does not share the input memory unless the view turns out to be dense.
+ * *storage_offset:Elements of the buffer before the first element of the view, used with strides.
  *
  *    *@par Outputs:
- *    *y:A Tensor. Has the same type as x.
+ *    *tensor:A Tensor. Has the same type and memory as input tensor.
  *    */
 REG_OP(ReshapeCust)
     .INPUT(tensor, TensorType({DT_BOOL, DT_FLOAT16, DT_FLOAT, DT_INT8, DT_INT32, DT_UINT32, DT_UINT8,
                           DT_INT64, DT_UINT64, DT_INT16, DT_UINT16, DT_DOUBLE, DT_COMPLEX64,
                           DT_COMPLEX128, DT_QINT8, DT_QUINT8, DT_QINT16, DT_QUINT16, DT_QINT32}))
     .INPUT(shape, TensorType({DT_INT32, DT_INT64}))
-    .OUTPUT(output, TensorType({DT_BOOL, DT_FLOAT16, DT_FLOAT, DT_INT8, DT_INT32, DT_UINT32, DT_UINT8,
+    .OUTPUT(tensor, TensorType({DT_BOOL, DT_FLOAT16, DT_FLOAT, DT_INT8, DT_INT32, DT_UINT32, DT_UINT8,
                            DT_INT64, DT_UINT64, DT_INT16, DT_UINT16, DT_DOUBLE, DT_COMPLEX64,
                            DT_COMPLEX128, DT_QINT8, DT_QUINT8, DT_QINT16, DT_QUINT16, DT_QINT32}))
+    .ATTR(strides, ListInt, {})
+    .ATTR(storage_offset, Int, 0)
     .OP_END_FACTORY_REG(ReshapeCust)
 
 }
@@ -9,7 +9,7 @@ def conv2d_tik_compute(params):
     te_set_l2_mode(1)
     tik_instance = tik.Tik(tik.Dprofile(params["arch"], params["version"]),
                            err_msg_level=1)
-    n, c1, h, w, c0 = params["fm_shape"]
+    n, _, h, w, c0 = params["fm_shape"]
     c1, kh, kw, cout, c0 = params["weight_shape"]
     stride_h, stride_w = params["stride_list"]
     dilation_h, dilation_w = params["dilation_list"]
@@ -20,7 +20,7 @@ def conv2d_tik_compute(params):
     wo = int(np.ceil((w + pad_right + pad_left - kw_dilation + 1) / stride_w))
     round_howo = ceil_div(ho * wo, 16) * 16 
 
-    fm_gm = tik_instance.Tensor(params['fm_dtype'], (n, c1, h, w, c0),
+    fm_gm = tik_instance.Tensor(params['fm_dtype'], params["fm_shape"],
                                 name='fm_gm', scope=tik.scope_gm)
     weight_gm = tik_instance.Tensor(params['weight_type'],
                                     (c1, kh, kw, cout, c0), name='weight_gm',
@@ -35,50 +35,54 @@ def conv2d_tik_compute(params):
                                      [n, cout // 16, ho, wo, 16],
                                      name='dst_gm', scope=tik.scope_gm)
 
-    core_num = 2
-    pre_core_cout = cout // core_num
-    cout_iter_num = pre_core_cout // params["cout_split_factor"]
+    # each group convolves its own c1 blocks of fm with its own cout_group
+    # filters, so weight_L1 never holds another group's weights
+    groups = params.get("groups", 1)
+    cout_group = cout // groups
+    split = params["cout_split_factor"]
+    group_iter_num = cout_group // split
+    tile_num = groups * group_iter_num
+    core_num = 2 if tile_num % 2 == 0 else 1
+    pre_core_tile = tile_num // core_num
     Cin_blocks = c1
 
-    with tik_instance.for_range(0, core_num, block_num=core_num) as cout_o:
-        with tik_instance.for_range(0, cout_iter_num, thread_num=1) as cout_i:
+    with tik_instance.for_range(0, core_num, block_num=core_num) as core_idx:
+        with tik_instance.for_range(0, pre_core_tile, thread_num=1) as tile_i:
+            tile = core_idx * pre_core_tile + tile_i
+            group = tile // group_iter_num
+            cout_start = group * cout_group + (tile % group_iter_num) * split
             weight_L1 = tik_instance.Tensor(
-                params['weight_type'], (Cin_blocks, kh, kw,
-                                        params["cout_split_factor"], c0),
+                params['weight_type'], (Cin_blocks, kh, kw, split, c0),
                 name='weight_l1', scope=tik.scope_cbuf)
             tik_instance.data_move(
                 weight_L1,
-                weight_gm.flatten()[cout_o * pre_core_cout * c0 +
-                                    params["cout_split_factor"] * cout_i * c0],
-                0, Cin_blocks * kh * kw, params["cout_split_factor"], (cout - params["cout_split_factor"]), 0)
+                weight_gm.flatten()[cout_start * c0],
+                0, Cin_blocks * kh * kw, split, (cout - split), 0)
 
             with tik_instance.for_range(0, n, thread_num=2) as n_index:
                 feature_map_l1 = tik_instance.Tensor(params['fm_dtype'],
-                                                     (c1, h, w, c0),
+                                                     (Cin_blocks, h, w, c0),
                                                      name='feature_map_l1',
                                                      scope=tik.scope_cbuf)
                 tik_instance.data_move(feature_map_l1,
-                                        fm_gm[n_index, :, :, :, :],
-                                        0, 1, c1 * h * w, 0, 0)
+                                        fm_gm[n_index, group * Cin_blocks, 0, 0, 0],
+                                        0, 1, Cin_blocks * h * w, 0, 0)
                 dst_l0c = tik_instance.Tensor(
-                    params['dst_l0c_type'], [params["cout_split_factor"]//16,
-                                             round_howo, 16],
+                    params['dst_l0c_type'], [split//16, round_howo, 16],
                     name='dst_l0c', scope=tik.scope_cbuf_out)
 
                 tik_instance.conv2d(dst_l0c, feature_map_l1,
-                                    weight_L1, (c1, h, w, c0),
-                                    (Cin_blocks, kh, kw,
-                                     params["cout_split_factor"], c0),
+                                    weight_L1, (Cin_blocks, h, w, c0),
+                                    (Cin_blocks, kh, kw, split, c0),
                                     params['stride_list'],
                                     params['pad_list'],
                                     params['dilation_list'],
                                     params['pad_value'])
 
                 tik_instance.fixpipe(
-                    dst_gm[n_index, (cout_o*pre_core_cout +
-                                     params["cout_split_factor"]*cout_i) //
+                    dst_gm[n_index, cout_start //
                            (32//DTYPE_SIZE[params['dst_gm_type']]), 0, 0, 0],
-                    dst_l0c, params["cout_split_factor"]//16,
+                    dst_l0c, split//16,
                     ho * wo * 16 * DTYPE_SIZE[params['dst_l0c_type']] // 32, 0, 0,
                     extend_params={"bias": None,
                                    "quantize_params": params["quantize_params"]})
@@ -89,7 +93,133 @@ def conv2d_tik_compute(params):
     return tik_instance
 
 
-def conv2d_tik(inputs, weights, outputs, strides, pads, dilations, kernel_name="conv2d_tik"):
+# Unified Buffer of the v100 mini profile, less what tik reserves
+UB_SIZE = 248 * 1024
+MAX_REPEAT = 255
+
+
+def _repeat_op(op, dst, src, elements, lanes, dst_rep, src_rep):
+    """op over a flat run of elements, lanes per repeat, the tail under a partial mask"""
+    full = elements // lanes
+    for start in range(0, full, MAX_REPEAT):
+        op(lanes, dst[start * lanes], src[start * lanes],
+           min(MAX_REPEAT, full - start), dst_rep, src_rep)
+    if elements % lanes:
+        op(elements % lanes, dst[full * lanes], src[full * lanes], 1,
+           dst_rep, src_rep)
+
+
+def depthwise_conv2d_tik_compute(params):
+    """
+    Depthwise conv on the vector unit, one c0 block of channels at a time.
+    A channel only meets its own filter, so each block loads the kh * kw
+    taps of its c0 channels, nothing of the other channels, where the cube
+    would need them as a cin x cout block diagonal. Rows are widened to
+    float32 and every tap is one vmla over an output row, the accumulation
+    matching the float32 L0C of the cube path.
+
+    The filter comes as FRACTAL_Z of [c, 1, kh, kw], (kh * kw, c1, c0, c0)
+    with the one input channel of filter co at lane 0 of row co, so a
+    block reads its c0 x c0 fractal of every tap and keeps lane 0 of each
+    row.
+    """
+    te_set_l2_mode(1)
+    tik_instance = tik.Tik(tik.Dprofile(params["arch"], params["version"]),
+                           err_msg_level=1)
+    n, c1, h, w, c0 = params["fm_shape"]
+    kh, kw = params["kernel_size"]
+    stride_h, stride_w = params["stride_list"]
+    dilation_h, dilation_w = params["dilation_list"]
+    pad_top, pad_bot, pad_left, pad_right = params["pad_list"]
+    ho = (h + pad_top + pad_bot - (kh - 1) * dilation_h - 1) // stride_h + 1
+    wo = (w + pad_left + pad_right - (kw - 1) * dilation_w - 1) // stride_w + 1
+    wp = pad_left + w + pad_right
+
+    fm_gm = tik_instance.Tensor("float16", (n, c1, h, w, c0),
+                                name='fm_gm', scope=tik.scope_gm)
+    weight_gm = tik_instance.Tensor("float16", (kh * kw, c1, c0, c0),
+                                    name='weight_gm', scope=tik.scope_gm)
+    dst_gm = tik_instance.Tensor("float16", (n, c1, ho, wo, c0),
+                                 name='dst_gm', scope=tik.scope_gm)
+
+    def vconv_op(mask, dst, src, repeat, dst_rep, src_rep):
+        tik_instance.vconv(mask, "", dst, src, repeat, 1, 1, dst_rep, src_rep)
+
+    def vdup_zero(mask, dst, src, repeat, dst_rep, src_rep):
+        tik_instance.vector_dup(mask, dst, 0, repeat, 1, dst_rep)
+
+    item_num = n * c1
+    core_num = 2 if item_num % 2 == 0 else 1
+    pre_core_item = item_num // core_num
+
+    with tik_instance.for_range(0, core_num, block_num=core_num) as core_idx:
+        with tik_instance.for_range(0, pre_core_item) as item_i:
+            item = core_idx * pre_core_item + item_i
+            n_index = item // c1
+            c1_index = item % c1
+            weight_fz = tik_instance.Tensor("float16", (kh * kw * c0 * c0,),
+                                            name='weight_fz', scope=tik.scope_ubuf)
+            weight_ub = tik_instance.Tensor("float16", (kh * kw * c0,),
+                                            name='weight_ub', scope=tik.scope_ubuf)
+            weight_f32 = tik_instance.Tensor("float32", (kh * kw * c0,),
+                                             name='weight_f32', scope=tik.scope_ubuf)
+            row_ub = tik_instance.Tensor("float16", (wp * c0,),
+                                         name='row_ub', scope=tik.scope_ubuf)
+            row_f32 = tik_instance.Tensor("float32", (wp * c0,),
+                                          name='row_f32', scope=tik.scope_ubuf)
+            acc_ub = tik_instance.Tensor("float32", (wo * c0,),
+                                         name='acc_ub', scope=tik.scope_ubuf)
+            out_ub = tik_instance.Tensor("float16", (wo * c0,),
+                                         name='out_ub', scope=tik.scope_ubuf)
+            # the fractal of every tap is c0 blocks, the other c1 blocks lie between them
+            tik_instance.data_move(weight_fz, weight_gm[0, c1_index, 0, 0],
+                                   0, kh * kw, c0, (c1 - 1) * c0, 0)
+            with tik_instance.for_range(0, kh * kw * c0) as tap_lane:
+                tap_weight = tik_instance.Scalar("float16", name="tap_weight")
+                tap_weight.set_as(weight_fz[tap_lane * c0])
+                weight_ub[tap_lane].set_as(tap_weight)
+            _repeat_op(vconv_op, weight_f32, weight_ub, kh * kw * c0, 64, 8, 4)
+            # the padding columns stay zero, rows only ever land between them
+            _repeat_op(vdup_zero, row_ub, row_ub, wp * c0, 128, 8, 8)
+
+            with tik_instance.for_range(0, ho) as oh:
+                _repeat_op(vdup_zero, acc_ub, acc_ub, wo * c0, 64, 8, 8)
+                for i in range(kh):
+                    ih = tik_instance.Scalar("int32", name="ih")
+                    ih.set_as(oh * stride_h - pad_top + i * dilation_h)
+                    with tik_instance.if_scope(tik.all(ih >= 0, ih < h)):
+                        tik_instance.data_move(row_ub[pad_left * c0],
+                                               fm_gm[n_index, c1_index, ih, 0, 0],
+                                               0, 1, w, 0, 0)
+                        _repeat_op(vconv_op, row_f32, row_ub, wp * c0, 64, 8, 4)
+                        for j in range(kw):
+                            # one output pixel per repeat: 2 blocks of c0 floats,
+                            # stride_w input pixels apart, the tap's weights reused
+                            for start in range(0, wo, MAX_REPEAT):
+                                tik_instance.vmla(c0, acc_ub[start * c0],
+                                                  row_f32[(start * stride_w + j * dilation_w) * c0],
+                                                  weight_f32[(i * kw + j) * c0],
+                                                  min(MAX_REPEAT, wo - start), 1, 1, 1,
+                                                  c0 // 8, stride_w * c0 // 8, 0)
+                _repeat_op(vconv_op, out_ub, acc_ub, wo * c0, 64, 4, 8)
+                tik_instance.data_move(dst_gm[n_index, c1_index, oh, 0, 0], out_ub,
+                                       0, 1, wo, 0, 0)
+
+    tik_instance.BuildCCE(kernel_name=params["kernel_name"],
+                          inputs=[fm_gm, weight_gm], outputs=[dst_gm])
+
+    return tik_instance
+
+
+def conv2d_tik(inputs, weights, outputs, strides, pads, dilations, groups=1,
+               data_format="NCHW", kernel_name="conv2d_tik"):
+    """
+    groups splits x and filter into groups that convolve independently.
+    Groups whose channels fill whole c0 blocks run on the cube one group at
+    a time; depthwise convs, one input and one output channel per group,
+    run on the vector unit. Other groupings are left to the AI CPU kernel.
+    strides and dilations follow data_format, the filter dims its ori_format.
+    """
     in_dtype = inputs.get("dtype")
     w_dtype = weights.get("dtype")
     res_dtype = outputs.get("dtype")
@@ -102,29 +232,29 @@ def conv2d_tik(inputs, weights, outputs, strides, pads, dilations, kernel_name="
         raise RuntimeError("dilations shape should be 4d.")
     if len(pads) != 4:
         raise RuntimeError("pads shape should be 4d.")
-        
+    if data_format == "NCHW":
+        strideList = [strides[2], strides[3]]
+        dilationList = [dilations[2], dilations[3]]
+    elif data_format == "NHWC":
+        strideList = [strides[1], strides[2]]
+        dilationList = [dilations[1], dilations[2]]
+    else:
+        raise RuntimeError("data_format should be NCHW or NHWC.")
+    if weights.get("ori_format") == "NCHW":
+        kn, kc, kh, kw = wori_shape
+    else:
+        kn, kh, kw, kc = wori_shape
+    if groups < 1 or kn % groups != 0:
+        raise RuntimeError("filter count %d is not a multiple of groups %d." % (kn, groups))
+
     if in_dtype=="float16":
         loc_dtype = "float32"
         quantize_params = {"mode":"fp322fp16", "mode_param":None}
-        if weights.get("ori_format")=="NCHW":
-            strideList = [strides[2], strides[3]]
-            dilationList = [dilations[2], dilations[3]]                    
-            w_shape = [wori_shape[1]//16, wori_shape[2], wori_shape[3], wori_shape[0], 16]
-        else:
-            strideList = [strides[1], strides[2]]
-            dilationList = [dilations[1], dilations[2]]                    
-            w_shape = [wori_shape[3]//16, wori_shape[1], wori_shape[2], wori_shape[0], 16]
+        c0 = 16
     elif in_dtype=="int8":
         loc_dtype = "int32"
         quantize_params = {"mode":"int322fp16", "mode_param":1.0}
-        if weights.get("ori_format")=="NCHW":
-            strideList = [strides[2], strides[3]]
-            dilationList = [dilations[2], dilations[3]] 
-            w_shape = [wori_shape[1]//32, wori_shape[2], wori_shape[3], wori_shape[0], 32]
-        else:
-            strideList = [strides[1], strides[2]]
-            dilationList = [dilations[1], dilations[2]]     
-            w_shape = [wori_shape[3]//32, wori_shape[1], wori_shape[2], wori_shape[0], 32]
+        c0 = 32
     else:
          raise RuntimeError("input_dtype shape should be float16 or int8.")
 
@@ -132,7 +262,6 @@ def conv2d_tik(inputs, weights, outputs, strides, pads, dilations, kernel_name="
         "arch": "v100",
         "version": "mini",
         "fm_shape": in_shape,
-        "weight_shape": w_shape,
         "fm_dtype": in_dtype,
         "weight_type": w_dtype,
         "dst_l0c_type": loc_dtype,
@@ -142,7 +271,28 @@ def conv2d_tik(inputs, weights, outputs, strides, pads, dilations, kernel_name="
         "pad_value": 0,
         "stride_list": strideList,
         "dilation_list": dilationList,
+        "groups": groups,
         "cout_split_factor": 64,
         "kernel_name": kernel_name}
 
-    conv2d_tik_compute(params)
+    if groups > 1 and kc == 1 and kn == groups:
+        if in_dtype != "float16":
+            raise RuntimeError("depthwise conv2d_tik takes float16 only.")
+        # the filter is the FRACTAL_Z of [c, 1, kh, kw], one tap per channel at lane 0
+        params["kernel_size"] = [kh, kw]
+        _, _, pad_left, pad_right = pads
+        wp = pad_left + in_shape[3] + pad_right
+        wo = (wp - (kw - 1) * dilationList[1] - 1) // strideList[1] + 1
+        ub_bytes = kh * kw * c0 * c0 * 2 + (wp + kh * kw) * c0 * (2 + 4) + wo * c0 * (4 + 2)
+        if ub_bytes > UB_SIZE:
+            raise RuntimeError("depthwise rows of width %d do not fit the UB." % in_shape[3])
+        return depthwise_conv2d_tik_compute(params)
+
+    cout_group = kn // groups
+    if kc % c0 != 0 or cout_group % 16 != 0 or in_shape[1] != groups * kc // c0:
+        raise RuntimeError("groups of %d input and %d output channels are not c0 aligned."
+                           % (kc, cout_group))
+    # the largest split that still tiles every group
+    params["cout_split_factor"] = 64 if cout_group % 64 == 0 else (32 if cout_group % 32 == 0 else 16)
+    params["weight_shape"] = [kc // c0, kh, kw, kn, c0]
+    return conv2d_tik_compute(params)
@@ -33,61 +33,105 @@ def matmul_tik_compute(params, kernel_name, new_ws=None, cnt=0):
     m_thread_num = params['m_thread_num']
     k_thread_num = params['k_thread_num']
 
-    C_gm = tik_instance.Tensor(C_loc_out_type, (n // block_size, m, block_size),
+    # batch_a and batch_b are batch or 1, a single matrix is shared by the whole batch
+    batch = params.get('batch', 1)
+    batch_a = params.get('batch_a', 1)
+    batch_b = params.get('batch_b', 1)
+
+    C_gm = tik_instance.Tensor(C_loc_out_type, (batch, n // block_size, m, block_size),
                                name="C_gm", scope=tik.scope_gm)
-    A_gm = tik_instance.Tensor(params["data_type"], (k//K0, m, K0), name="A_gm",
+    A_gm = tik_instance.Tensor(params["data_type"], (batch_a, k//K0, m, K0), name="A_gm",
                                scope=tik.scope_gm)
-    B_gm = tik_instance.Tensor(params["data_type"], (k//K0, n, K0), name="B_gm",
+    B_gm = tik_instance.Tensor(params["data_type"], (batch_b, k//K0, n, K0), name="B_gm",
                                scope=tik.scope_gm)
 
 
     with tik_instance.for_range(0, 2, block_num=2) as core_id:
-        with tik_instance.for_range(0, n_cycle_times//2, thread_num=n_thread_num) as n_idx:
-            with tik_instance.for_range(0, m_cycle_times, thread_num=m_thread_num) as m_idx:
-                dst_l0c = tik_instance.Tensor(C_loc_out_type, [n_tiling_size//16, m_tiling_size, 16], name='dst_l0c', scope=tik.scope_cbuf_out)
-                with tik_instance.for_range(0, k_cycle_times, thread_num=k_thread_num) as k_idx:
-                    A_l1 = tik_instance.Tensor(params['data_type'], [k_tiling_size//K0, m_tiling_size, K0], name="A_tiling_l1", scope=tik.scope_cbuf)
-                    tik_instance.data_move(A_l1, A_gm[k_idx * k_tiling_size // K0, m_idx*m_tiling_size, :],
-                                           0, k_tiling_size//K0, m_tiling_size, m - m_tiling_size, 0)
-                    B_l1 = tik_instance.Tensor(params["data_type"], [k_tiling_size//K0, n_tiling_size, K0], name="B_tiling_l1", scope=tik.scope_cbuf)
-                    if n-n_tiling_size>65535:
-                        with tik_instance.for_range(0, k_tiling_size//K0) as dma_k_idx:
-                            tik_instance.data_move(B_l1[dma_k_idx, :, :], B_gm[k_idx*k_tiling_size//K0 + dma_k_idx, (core_id*n_cycle_times//2+n_idx)*n_tiling_size, :],
-                                                    0, 1, n_tiling_size, 0, 0)
-                    else:
-                        tik_instance.data_move(B_l1, B_gm[k_idx*k_tiling_size//K0, (core_id*n_cycle_times//2+n_idx)*n_tiling_size, :], 0, k_tiling_size//K0, n_tiling_size, n-n_tiling_size, 0)
-                    with tik_instance.if_scope(k_idx == 0):
-                        tik_instance.matmul(dst_l0c, A_l1, B_l1, m_tiling_size, k_tiling_size, n_tiling_size, init_l1out=True)
-                    with tik_instance.else_scope():
-                        tik_instance.matmul(dst_l0c, A_l1, B_l1, m_tiling_size, k_tiling_size, n_tiling_size, init_l1out=False)
-                tik_instance.fixpipe(C_gm[n_tiling_size//16*(core_id*n_cycle_times//2+n_idx), m_idx*m_tiling_size, :], dst_l0c, n_tiling_size//16, m_tiling_size*16*DTYPE_SIZE[C_loc_out_type]//32,
-                                     (m-m_tiling_size)*16*DTYPE_SIZE[C_loc_out_type]//32, 0)
+        with tik_instance.for_range(0, batch) as b_idx:
+            a_idx = b_idx if batch_a > 1 else 0
+            b_mat = b_idx if batch_b > 1 else 0
+            with tik_instance.for_range(0, n_cycle_times//2, thread_num=n_thread_num) as n_idx:
+                with tik_instance.for_range(0, m_cycle_times, thread_num=m_thread_num) as m_idx:
+                    dst_l0c = tik_instance.Tensor(C_loc_out_type, [n_tiling_size//16, m_tiling_size, 16], name='dst_l0c', scope=tik.scope_cbuf_out)
+                    with tik_instance.for_range(0, k_cycle_times, thread_num=k_thread_num) as k_idx:
+                        A_l1 = tik_instance.Tensor(params['data_type'], [k_tiling_size//K0, m_tiling_size, K0], name="A_tiling_l1", scope=tik.scope_cbuf)
+                        tik_instance.data_move(A_l1, A_gm[a_idx, k_idx * k_tiling_size // K0, m_idx*m_tiling_size, :],
+                                               0, k_tiling_size//K0, m_tiling_size, m - m_tiling_size, 0)
+                        B_l1 = tik_instance.Tensor(params["data_type"], [k_tiling_size//K0, n_tiling_size, K0], name="B_tiling_l1", scope=tik.scope_cbuf)
+                        if n-n_tiling_size>65535:
+                            with tik_instance.for_range(0, k_tiling_size//K0) as dma_k_idx:
+                                tik_instance.data_move(B_l1[dma_k_idx, :, :], B_gm[b_mat, k_idx*k_tiling_size//K0 + dma_k_idx, (core_id*n_cycle_times//2+n_idx)*n_tiling_size, :],
+                                                        0, 1, n_tiling_size, 0, 0)
+                        else:
+                            tik_instance.data_move(B_l1, B_gm[b_mat, k_idx*k_tiling_size//K0, (core_id*n_cycle_times//2+n_idx)*n_tiling_size, :], 0, k_tiling_size//K0, n_tiling_size, n-n_tiling_size, 0)
+                        with tik_instance.if_scope(k_idx == 0):
+                            tik_instance.matmul(dst_l0c, A_l1, B_l1, m_tiling_size, k_tiling_size, n_tiling_size, init_l1out=True)
+                        with tik_instance.else_scope():
+                            tik_instance.matmul(dst_l0c, A_l1, B_l1, m_tiling_size, k_tiling_size, n_tiling_size, init_l1out=False)
+                    tik_instance.fixpipe(C_gm[b_idx, n_tiling_size//16*(core_id*n_cycle_times//2+n_idx), m_idx*m_tiling_size, :], dst_l0c, n_tiling_size//16, m_tiling_size*16*DTYPE_SIZE[C_loc_out_type]//32,
+                                         (m-m_tiling_size)*16*DTYPE_SIZE[C_loc_out_type]//32, 0)
 
     tik_instance.BuildCCE(kernel_name=kernel_name,
                           inputs=[A_gm, B_gm], outputs=[C_gm])
     return tik_instance
 
 
-def matmul_tik(input_x1, input_x2, output_y={}, kernel_name="simple_matmul"):
-    shape_a = input_x1.get("ori_shape")
-    shape_b = input_x2.get("ori_shape")
-    m = shape_a[0]
-    k = shape_a[1]
-    n = shape_b[1]
+def matmul_tik(input_x1, input_x2, output_y={}, transpose_x1=False, transpose_x2=False,
+               m_tiling_size=0, n_tiling_size=0, k_tiling_size=0,
+               m_thread_num=0, n_thread_num=0, k_thread_num=0, kernel_name="simple_matmul"):
+    """
+    y = op(x1) * op(x2) over the batch dims, op transposing when its
+    transpose_x attr is set. The tiling attrs come from MatmulTikInferShape,
+    which picks them for the final shapes, so they have to be set here.
+    x1 and x2 arrive in the k-blocked layout of op(x1) and op(x2), the
+    transposes only say which of the ori_shape axes are m, k and n.
+    """
+    shape_a = list(input_x1.get("ori_shape"))
+    shape_b = list(input_x2.get("ori_shape"))
+    if len(shape_a) < 2 or len(shape_b) < 2:
+        raise RuntimeError("matmul_tik takes inputs of rank 2 or more")
+    m, k = (shape_a[-1], shape_a[-2]) if transpose_x1 else (shape_a[-2], shape_a[-1])
+    k_b, n = (shape_b[-1], shape_b[-2]) if transpose_x2 else (shape_b[-2], shape_b[-1])
+    if k != k_b:
+        raise RuntimeError("matmul_tik inner dims %d and %d differ" % (k, k_b))
+
+    # batch dims aligned at the last one, a missing dim being 1
+    batch_rank = max(len(shape_a), len(shape_b)) - 2
+    batch_dims_a = [1] * (batch_rank + 2 - len(shape_a)) + shape_a[:-2]
+    batch_dims_b = [1] * (batch_rank + 2 - len(shape_b)) + shape_b[:-2]
+    batch_dims = [max(dim_a, dim_b) for dim_a, dim_b in zip(batch_dims_a, batch_dims_b)]
+    # the kernel walks one batch axis, an input either has all of it or shares one matrix
+    for dims in (batch_dims_a, batch_dims_b):
+        if dims != batch_dims and any(dim != 1 for dim in dims):
+            raise RuntimeError("matmul_tik batch dims %s and %s do not broadcast" % (shape_a[:-2], shape_b[:-2]))
+    batch = reduce_mul(batch_dims) if batch_dims else 1
+    batch_a = batch if batch_dims_a == batch_dims else 1
+    batch_b = batch if batch_dims_b == batch_dims else 1
+
+    tiling = (m_tiling_size, n_tiling_size, k_tiling_size, m_thread_num, n_thread_num, k_thread_num)
+    if min(tiling) <= 0:
+        raise RuntimeError("matmul_tik has no tiling for m %d k %d n %d" % (m, k, n))
+    # the n tiles are split over two cores
+    if m % m_tiling_size != 0 or n % (2 * n_tiling_size) != 0 or k % k_tiling_size != 0:
+        raise RuntimeError("matmul_tik tiling %s does not divide m %d k %d n %d" % (tiling, m, k, n))
+
     data_type = input_x1.get("dtype").lower()
     params = {
         'M': m,
         'K': k,
         'N': n,
+        'batch': batch,
+        'batch_a': batch_a,
+        'batch_b': batch_b,
         'data_type': data_type,
-        'm_tiling_size': 16,
-        'm_cycle_times': 1,
-        'm_thread_num': 1,
-        'n_tiling_size': 64,
-        'n_cycle_times': 16,
-        'n_thread_num': 1,
-        'k_tiling_size': 32,
-        'k_cycle_times': 2,
-        'k_thread_num': 2
+        'm_tiling_size': m_tiling_size,
+        'm_cycle_times': m // m_tiling_size,
+        'm_thread_num': m_thread_num,
+        'n_tiling_size': n_tiling_size,
+        'n_cycle_times': n // n_tiling_size,
+        'n_thread_num': n_thread_num,
+        'k_tiling_size': k_tiling_size,
+        'k_cycle_times': k // k_tiling_size,
+        'k_thread_num': k_thread_num
     }
     matmul_tik_compute(params, kernel_name)
@@ -0,0 +1,340 @@
+"""
+Copyright (C) 2020. Huawei Technologies Co., Ltd. All rights reserved.
+
+This program is free software; you can redistribute it and/or modify
+it under the terms of the Apache License Version 2.0.You may not use this file
+except in compliance with the License.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+Apache License for more details at
+http://www.apache.org/licenses/LICENSE-2.0
+
+Runs the depthwise path of conv2d_tik.py on x in NC1HWC0 and a filter in
+FRACTAL_Z, through the tik debugger, and compares it with a depthwise conv
+computed in float64 from the same float16 data. Without the te package the
+kernel runs on a small stand-in of the few tik instructions it uses, so the
+layouts can be checked on any host with numpy.
+"""
+
+from __future__ import absolute_import
+
+from __future__ import division
+from __future__ import print_function
+
+import contextlib
+import os
+import sys
+import types
+import numpy as np
+
+atol = 0.001
+rtol = 0.001
+C0 = 16
+
+# n, c, h, w, kh, kw, strides, dilations, pads as [top, bottom, left, right]
+CASES = [
+    (1, 16, 8, 8, 3, 3, (1, 1), (1, 1), [1, 1, 1, 1]),
+    (2, 40, 9, 11, 3, 3, (2, 2), (1, 1), [1, 1, 1, 1]),
+    (1, 20, 10, 10, 5, 3, (1, 2), (2, 1), [2, 2, 1, 1]),
+    (1, 33, 7, 6, 1, 1, (1, 1), (1, 1), [0, 0, 0, 0]),
+]
+
+
+class _Expr(object):
+    """value of a loop variable or scalar, known once the kernel runs"""
+
+    def __add__(self, other):
+        return _Op(lambda a, b: a + b, self, other)
+
+    def __radd__(self, other):
+        return _Op(lambda a, b: a + b, other, self)
+
+    def __sub__(self, other):
+        return _Op(lambda a, b: a - b, self, other)
+
+    def __rsub__(self, other):
+        return _Op(lambda a, b: a - b, other, self)
+
+    def __mul__(self, other):
+        return _Op(lambda a, b: a * b, self, other)
+
+    def __rmul__(self, other):
+        return _Op(lambda a, b: a * b, other, self)
+
+    def __floordiv__(self, other):
+        return _Op(lambda a, b: a // b, self, other)
+
+    def __mod__(self, other):
+        return _Op(lambda a, b: a % b, self, other)
+
+    def __ge__(self, other):
+        return _Op(lambda a, b: a >= b, self, other)
+
+    def __lt__(self, other):
+        return _Op(lambda a, b: a < b, self, other)
+
+
+def _value(expr, env):
+    return expr.eval(env) if isinstance(expr, _Expr) else expr
+
+
+class _Op(_Expr):
+    def __init__(self, func, *args):
+        self.func = func
+        self.args = args
+
+    def eval(self, env):
+        return self.func(*[_value(arg, env) for arg in self.args])
+
+
+class _Var(_Expr):
+    def __init__(self, tik_instance=None):
+        self.tik_instance = tik_instance
+
+    def eval(self, env):
+        return env[self]
+
+    def set_as(self, value):
+        def assign(env):
+            env[self] = _value(value, env)
+        self.tik_instance.emit(assign)
+
+
+class _Ref(_Expr):
+    """an element of a tensor, the start of the operand of an instruction"""
+
+    def __init__(self, tensor, index):
+        self.tensor = tensor
+        self.index = index
+
+    def offset(self, env):
+        offset = 0
+        for dim, idx in zip(self.tensor.shape, self.index):
+            offset = offset * dim + _value(idx, env)
+        for dim in self.tensor.shape[len(self.index):]:
+            offset *= dim
+        return offset
+
+    def eval(self, env):
+        return self.tensor.data[self.offset(env)]
+
+    def set_as(self, value):
+        def assign(env):
+            self.tensor.data[self.offset(env)] = _value(value, env)
+        self.tensor.tik_instance.emit(assign)
+
+
+class _Tensor(object):
+    def __init__(self, tik_instance, dtype, shape, name):
+        self.tik_instance = tik_instance
+        self.shape = tuple(shape)
+        self.name = name
+        self.data = np.zeros(int(np.prod(self.shape)), dtype=dtype)
+
+    def __getitem__(self, index):
+        index = index if isinstance(index, tuple) else (index,)
+        return _Ref(self, [0 if isinstance(idx, slice) else idx for idx in index])
+
+
+def _operand(operand):
+    """a whole tensor starts at its first element"""
+    return operand[()] if isinstance(operand, _Tensor) else operand
+
+
+def _lanes(ref, env, mask, repeat, blk_stride, rep_stride):
+    """element offsets of every lane of every repeat, strides in 32 byte blocks"""
+    per_block = 32 // ref.tensor.data.itemsize
+    lanes = np.arange(mask)
+    lane_offsets = (lanes // per_block) * blk_stride * per_block + lanes % per_block
+    repeats = np.arange(repeat)[:, None] * rep_stride * per_block
+    return ref.offset(env) + repeats + lane_offsets
+
+
+class _Debugger(object):
+    def __init__(self, tik_instance):
+        self.tik_instance = tik_instance
+
+    def start_debug(self, feed_dict, interactive=False):
+        tik_instance = self.tik_instance
+        for tensor in tik_instance.inputs:
+            tensor.data[:] = np.asarray(feed_dict[tensor.name]).reshape(-1)
+        tik_instance.run(tik_instance.body, {})
+        return [tensor.data.reshape(tensor.shape) for tensor in tik_instance.outputs]
+
+
+class _Tik(object):
+    """the tik instructions of the depthwise path, run when BuildCCE is done"""
+
+    def __init__(self, profile=None, err_msg_level=0):
+        self.body = []
+        self.blocks = [self.body]
+        self.last_cond = None
+        self.inputs = []
+        self.outputs = []
+        self.tikdb = _Debugger(self)
+
+    def emit(self, stmt):
+        self.blocks[-1].append(stmt)
+
+    @staticmethod
+    def run(block, env):
+        for stmt in block:
+            stmt(env)
+
+    @contextlib.contextmanager
+    def _block(self, wrap):
+        body = []
+        self.blocks.append(body)
+        yield
+        self.blocks.pop()
+        self.emit(lambda env: wrap(body, env))
+
+    @contextlib.contextmanager
+    def for_range(self, begin, end, **kwargs):
+        var = _Var()
+
+        def loop(body, env):
+            for value in range(_value(begin, env), _value(end, env)):
+                env[var] = value
+                self.run(body, env)
+        with self._block(loop):
+            yield var
+
+    def if_scope(self, cond):
+        self.last_cond = cond
+        return self._block(lambda body, env: _value(cond, env) and self.run(body, env))
+
+    def else_scope(self):
+        cond = self.last_cond
+        return self._block(lambda body, env: _value(cond, env) or self.run(body, env))
+
+    def Tensor(self, dtype, shape, name, scope=None):
+        return _Tensor(self, dtype, shape, name)
+
+    def Scalar(self, dtype, name=None, init_value=None):
+        return _Var(self)
+
+    def data_move(self, dst, src, sid, nburst, burst, src_stride, dst_stride):
+        dst, src = _operand(dst), _operand(src)
+
+        def move(env):
+            per_block = 32 // dst.tensor.data.itemsize
+            dst_offset = dst.offset(env)
+            src_offset = src.offset(env)
+            size = burst * per_block
+            for i in range(nburst):
+                src_start = src_offset + i * (burst + src_stride) * per_block
+                dst_start = dst_offset + i * (burst + dst_stride) * per_block
+                dst.tensor.data[dst_start:dst_start + size] = src.tensor.data[src_start:src_start + size]
+        self.emit(move)
+
+    def vconv(self, mask, round_mode, dst, src, repeat, dst_blk, src_blk, dst_rep, src_rep):
+        dst, src = _operand(dst), _operand(src)
+
+        def conv(env):
+            dst.tensor.data[_lanes(dst, env, mask, repeat, dst_blk, dst_rep)] = \
+                src.tensor.data[_lanes(src, env, mask, repeat, src_blk, src_rep)]
+        self.emit(conv)
+
+    def vector_dup(self, mask, dst, scalar, repeat, dst_blk, dst_rep):
+        dst = _operand(dst)
+
+        def dup(env):
+            dst.tensor.data[_lanes(dst, env, mask, repeat, dst_blk, dst_rep)] = _value(scalar, env)
+        self.emit(dup)
+
+    def vmla(self, mask, dst, src0, src1, repeat, dst_blk, src0_blk, src1_blk, dst_rep, src0_rep, src1_rep):
+        dst, src0, src1 = _operand(dst), _operand(src0), _operand(src1)
+
+        def mla(env):
+            # repeats run in order, so one that reads an earlier one's dst sees its result
+            dst_idx = _lanes(dst, env, mask, repeat, dst_blk, dst_rep)
+            src0_idx = _lanes(src0, env, mask, repeat, src0_blk, src0_rep)
+            src1_idx = _lanes(src1, env, mask, repeat, src1_blk, src1_rep)
+            for i in range(repeat):
+                dst.tensor.data[dst_idx[i]] += src0.tensor.data[src0_idx[i]] * src1.tensor.data[src1_idx[i]]
+        self.emit(mla)
+
+    def BuildCCE(self, kernel_name, inputs, outputs):
+        self.inputs = inputs
+        self.outputs = outputs
+
+
+def _install_tik_stand_in():
+    modules = {}
+    for name in ("te", "te.tik", "te.tik.common", "te.tik.common.util", "te.platform", "te.platform.cce_conf"):
+        modules[name] = types.ModuleType(name)
+    tik = modules["te.tik"]
+    tik.Tik = _Tik
+    tik.Dprofile = lambda arch, version: None
+    tik.scope_gm = tik.scope_ubuf = tik.scope_cbuf = tik.scope_cbuf_out = None
+    tik.all = lambda *conds: _Op(lambda *values: all(values), *conds)
+    util = modules["te.tik.common.util"]
+    util.ceil_div = lambda a, b: (a + b - 1) // b
+    util.reduce_mul = lambda values: int(np.prod(values))
+    util.DTYPE_SIZE = {"float16": 2, "float32": 4, "int8": 1, "uint8": 1, "int32": 4}
+    modules["te.platform.cce_conf"].te_set_l2_mode = lambda mode: None
+    modules["te"].tik = tik
+    sys.modules.update(modules)
+
+
+def depthwise_reference(x, filt, strides, dilations, pads):
+    n, c, h, w = x.shape
+    _, _, kh, kw = filt.shape
+    pad_top, pad_bot, pad_left, pad_right = pads
+    xp = np.pad(x.astype(np.float64), ((0, 0), (0, 0), (pad_top, pad_bot), (pad_left, pad_right)))
+    ho = (h + pad_top + pad_bot - (kh - 1) * dilations[0] - 1) // strides[0] + 1
+    wo = (w + pad_left + pad_right - (kw - 1) * dilations[1] - 1) // strides[1] + 1
+    y = np.zeros((n, c, ho, wo))
+    for i in range(kh):
+        for j in range(kw):
+            rows = xp[:, :, i * dilations[0]:, j * dilations[1]:]
+            rows = rows[:, :, :(ho - 1) * strides[0] + 1:strides[0], :(wo - 1) * strides[1] + 1:strides[1]]
+            y += rows * filt[:, 0, i, j].astype(np.float64)[None, :, None, None]
+    return y
+
+
+def run_case(conv2d_tik, case):
+    n, c, h, w, kh, kw, strides, dilations, pads = case
+    c1 = (c + C0 - 1) // C0
+    x = np.random.uniform(-2, 2, size=(n, c, h, w)).astype(np.float16)
+    filt = np.random.uniform(-2, 2, size=(c, 1, kh, kw)).astype(np.float16)
+
+    # NC1HWC0 and the FRACTAL_Z of [c, 1, kh, kw], channels padded with zeros
+    x5 = np.zeros((n, c1 * C0, h, w), np.float16)
+    x5[:, :c] = x
+    x5 = x5.reshape(n, c1, C0, h, w).transpose(0, 1, 3, 4, 2)
+    fz = np.zeros((kh * kw, c1 * C0, C0), np.float16)
+    fz[:, :c, 0] = filt[:, 0].reshape(c, kh * kw).T
+    fz = fz.reshape(kh * kw, c1, C0, C0)
+
+    tik_instance = conv2d_tik({"shape": x5.shape, "dtype": "float16"},
+                              {"ori_shape": filt.shape, "ori_format": "NCHW", "dtype": "float16"},
+                              {"dtype": "float16"}, [1, 1] + list(strides), pads,
+                              [1, 1] + list(dilations), groups=c, kernel_name="depthwise_conv2d_tik")
+    y5, = tik_instance.tikdb.start_debug(feed_dict={"fm_gm": x5, "weight_gm": fz}, interactive=False)
+    y = y5.transpose(0, 1, 4, 2, 3).reshape(n, c1 * C0, y5.shape[2], y5.shape[3])[:, :c]
+    return np.allclose(y.astype(np.float32), depthwise_reference(x, filt, strides, dilations, pads), atol, rtol)
+
+
+def main():
+    try:
+        import te
+    except ImportError:
+        _install_tik_stand_in()
+    sys.path.insert(0, os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "..", "impl"))
+    from conv2d_tik import conv2d_tik
+
+    np.random.seed(0)
+    results = [run_case(conv2d_tik, case) for case in CASES]
+    print('====================================')
+    for case, result in zip(CASES, results):
+        print(case, result)
+    print('====================================')
+    return 0 if all(results) else 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())